@@ -7,6 +7,7 @@ class OpenDOMApp {
         this.actuators = new Map();
         this.rules = new Map();
         this.updateInterval = null;
+        this.eventSource = null;
         this.currentEditingDevice = null;
         this.currentEditingRule = null;
         this.pendingAction = null;
@@ -767,27 +768,8 @@ class OpenDOMApp {
         }
 
         try {
-            // Get current config
-            const configResponse = await fetch('/api/config');
-            const config = await configResponse.json();
-            
-            // Update or add device
-            const deviceIndex = config.devices.findIndex(d => d.id === deviceData.id);
-            if (deviceIndex >= 0) {
-                config.devices[deviceIndex] = deviceData;
-            } else {
-                config.devices.push(deviceData);
-            }
-            
-            // Save config
-            const response = await fetch('/api/config', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: `root_password=${encodeURIComponent(this.rootPassword)}&` +
-                      encodeURIComponent(JSON.stringify(config))
-            });
+            // Seul l'appareil modifié est envoyé (création ou remplacement)
+            const response = await this.sendResource('devices', deviceData.id, 'PUT', deviceData);
 
             const result = await response.json();
             if (result.success) {
@@ -803,6 +785,21 @@ class OpenDOMApp {
         }
     }
 
+    // Un seul enregistrement de /api/devices ou /api/rules, mot de passe root
+    // dans l'en-tête X-Root-Password
+    sendResource(collection, id, method, data) {
+        const url = `/api/${collection}/${encodeURIComponent(id)}`;
+        const options = {
+            method: method,
+            headers: { 'X-Root-Password': this.rootPassword }
+        };
+        if (data) {
+            options.headers['Content-Type'] = 'application/json';
+            options.body = JSON.stringify(data);
+        }
+        return fetch(url, options);
+    }
+
     deleteDevice(deviceId) {
         this.currentEditingDevice = deviceId;
         this.pendingAction = 'delete_device';
@@ -811,19 +808,7 @@ class OpenDOMApp {
 
     async performDeleteDevice() {
         try {
-            const configResponse = await fetch('/api/config');
-            const config = await configResponse.json();
-            
-            config.devices = config.devices.filter(d => d.id !== this.currentEditingDevice);
-            
-            const response = await fetch('/api/config', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: `root_password=${encodeURIComponent(this.rootPassword)}&` +
-                      encodeURIComponent(JSON.stringify(config))
-            });
+            const response = await this.sendResource('devices', this.currentEditingDevice, 'DELETE');
 
             const result = await response.json();
             if (result.success) {
@@ -1358,27 +1343,8 @@ class OpenDOMApp {
         }
 
         try {
-            // Get current config
-            const configResponse = await fetch('/api/config');
-            const config = await configResponse.json();
-            
-            // Update or add rule
-            const ruleIndex = config.rules.findIndex(r => r.id === ruleData.id);
-            if (ruleIndex >= 0) {
-                config.rules[ruleIndex] = ruleData;
-            } else {
-                config.rules.push(ruleData);
-            }
-            
-            // Save config
-            const response = await fetch('/api/config', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: `root_password=${encodeURIComponent(this.rootPassword)}&` +
-                      encodeURIComponent(JSON.stringify(config))
-            });
+            // Seule la règle modifiée est envoyée (création ou remplacement)
+            const response = await this.sendResource('rules', ruleData.id, 'PUT', ruleData);
 
             const result = await response.json();
             if (result.success) {
@@ -1402,19 +1368,7 @@ class OpenDOMApp {
 
     async performDeleteRule() {
         try {
-            const configResponse = await fetch('/api/config');
-            const config = await configResponse.json();
-            
-            config.rules = config.rules.filter(r => r.id !== this.currentEditingRule);
-            
-            const response = await fetch('/api/config', {
-                method: 'POST',
-                headers: {
-                    'Content-Type': 'application/x-www-form-urlencoded',
-                },
-                body: `root_password=${encodeURIComponent(this.rootPassword)}&` +
-                      encodeURIComponent(JSON.stringify(config))
-            });
+            const response = await this.sendResource('rules', this.currentEditingRule, 'DELETE');
 
             const result = await response.json();
             if (result.success) {
@@ -1547,6 +1501,55 @@ class OpenDOMApp {
     }
 
     startDataUpdates() {
+        this.stopDataUpdates();
+
+        // Flux poussé par l'ESP32 : seules les lectures modifiées sont envoyées
+        if ('EventSource' in window) {
+            this.startEventStream();
+        } else {
+            this.startPolling();
+        }
+    }
+
+    startEventStream() {
+        this.eventSource = new EventSource('/api/events');
+
+        this.eventSource.addEventListener('sensors', (event) => {
+            const data = JSON.parse(event.data);
+            data.sensors.forEach(reading => this.updateSensorReading(reading));
+        });
+
+        this.eventSource.addEventListener('actuators', (event) => {
+            const data = JSON.parse(event.data);
+            data.actuators.forEach(({ id, state }) => {
+                const actuator = this.actuators.get(id);
+                if (actuator) {
+                    actuator.state = state;
+                    this.updateActuatorCard(id, state);
+                }
+            });
+        });
+
+        this.eventSource.onerror = () => {
+            // Connexion perdue : capteurs déconnectés jusqu'au prochain état complet
+            this.sensors.forEach((sensor, sensorId) => {
+                this.updateSensorReading({
+                    id: sensorId,
+                    type: sensor.sensor_type,
+                    isValid: false,
+                    timestamp: Date.now()
+                });
+            });
+
+            // Flux refusé (ancien serveur) : revenir à l'interrogation périodique
+            if (this.eventSource && this.eventSource.readyState === EventSource.CLOSED) {
+                this.eventSource = null;
+                this.startPolling();
+            }
+        };
+    }
+
+    startPolling() {
         this.updateInterval = setInterval(() => {
             if (this.authenticated) {
                 this.updateSensorData();
@@ -1555,6 +1558,10 @@ class OpenDOMApp {
     }
 
     stopDataUpdates() {
+        if (this.eventSource) {
+            this.eventSource.close();
+            this.eventSource = null;
+        }
         if (this.updateInterval) {
             clearInterval(this.updateInterval);
             this.updateInterval = null;
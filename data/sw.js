@@ -1,5 +1,5 @@
 // OPENDOM Service Worker for PWA functionality
-const CACHE_NAME = 'opendom-v1.0.0';
+const CACHE_NAME = 'opendom-v1.1.0';
 const STATIC_CACHE_URLS = [
   '/',
   '/index.html',
@@ -15,7 +15,8 @@ self.addEventListener('install', (event) => {
     caches.open(CACHE_NAME)
       .then((cache) => {
         console.log('Caching static resources');
-        return cache.addAll(STATIC_CACHE_URLS);
+        // Contourner le cache HTTP : les fichiers y restent STATIC_MAX_AGE secondes
+        return cache.addAll(STATIC_CACHE_URLS.map((url) => new Request(url, { cache: 'reload' })));
       })
       .then(() => {
         return self.skipWaiting();
@@ -57,6 +58,11 @@ self.addEventListener('fetch', (event) => {
     return;
   }
 
+  // Flux d'événements : jamais mis en cache, le navigateur le gère seul
+  if (url.pathname === '/api/events') {
+    return;
+  }
+
   // Cache strategy for different types of requests
   if (url.pathname.startsWith('/api/')) {
     // API requests - network first, cache as fallback
@@ -2,12 +2,23 @@
 #define ACTUATOR_H
 
 #include <Arduino.h>
+#include "Scheduler.h"
+#include "Symbols.h"
+
+enum class ActuatorType : uint8_t { RELAY, BUZZER };
+
+enum class BuzzerPattern : uint8_t { NONE, ALARM, BEEP };
+BuzzerPattern parseBuzzerPattern(Symbol pattern);
 
 class BaseActuator {
 public:
-  BaseActuator(String id, String name, int pin);
-  virtual ~BaseActuator() {}
+  BaseActuator(Symbol id, String name, int pin);
+  virtual ~BaseActuator() { scheduler.cancel(_timer); }
   
+  virtual ActuatorType getType() const = 0;
+  // actuator_type de la configuration, aussi déclaré en MODEL (DeviceRegistry.h)
+  virtual Symbol getModel() const = 0;
+  const char* getTypeName() const { return symbols.text(getModel()); }
   virtual void init() = 0;
   virtual void turnOn() = 0;
   virtual void turnOff() = 0;
@@ -15,21 +26,32 @@ public:
   virtual bool getState() = 0;
   virtual void setState(bool state) = 0;
   
-  String getId() const { return _id; }
-  String getName() const { return _name; }
+  // Appelée à l'échéance de _timer (durée programmée, phase de motif...)
+  virtual void update() {}
+  
+  Symbol getId() const { return _id; }
+  const String& getName() const { return _name; }
+  void setName(const String& name) { _name = name; }
   int getPin() const { return _pin; }
   
 protected:
-  String _id;
+  Symbol _id;
   String _name;
   int _pin;
   bool _state;
   unsigned long _lastAction;
+  Timer _timer;
+  
+private:
+  static void onTimer(void* context);
 };
 
 class RelayActuator : public BaseActuator {
 public:
-  RelayActuator(String id, String name, int pin, bool normallyOpen = true);
+  RelayActuator(Symbol id, String name, int pin, bool normallyOpen = true);
+  ActuatorType getType() const override { return ActuatorType::RELAY; }
+  static constexpr Symbol MODEL = SYM_RELAY;
+  Symbol getModel() const override { return MODEL; }
   void init() override;
   void turnOn() override;
   void turnOff() override;
@@ -38,7 +60,7 @@ public:
   void setState(bool state) override;
   
   void setDuration(unsigned long duration);
-  void update(); // Call this in main loop to handle timed operations
+  void update() override; // Fin de la durée programmée
   
 private:
   bool _normallyOpen;
@@ -49,7 +71,10 @@ private:
 
 class BuzzerActuator : public BaseActuator {
 public:
-  BuzzerActuator(String id, String name, int pin);
+  BuzzerActuator(Symbol id, String name, int pin);
+  ActuatorType getType() const override { return ActuatorType::BUZZER; }
+  static constexpr Symbol MODEL = SYM_BUZZER;
+  Symbol getModel() const override { return MODEL; }
   void init() override;
   void turnOn() override;
   void turnOff() override;
@@ -57,17 +82,18 @@ public:
   bool getState() override;
   void setState(bool state) override;
   
-  void setPattern(String pattern);
-  void update(); // Call this in main loop to handle patterns
+  void setPattern(BuzzerPattern pattern);
+  void update() override; // Changement de phase du motif
   
 private:
-  String _pattern;
+  BuzzerPattern _pattern;
   unsigned long _patternStartTime;
   int _patternStep;
   bool _patternActive;
   
-  void playAlarmPattern();
-  void playBeepPattern();
+  // Appliquent la phase courante et retournent le délai avant la suivante
+  unsigned long playAlarmPattern();
+  unsigned long playBeepPattern();
 };
 
 #endif
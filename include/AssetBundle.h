@@ -0,0 +1,25 @@
+#ifndef ASSET_BUNDLE_H
+#define ASSET_BUNDLE_H
+
+#include <Arduino.h>
+
+// Fichier de l'interface compilé dans le firmware (mode EMBEDDED_ASSETS) :
+// le contenu reste en flash, projetée en mémoire par le cache du MMU
+struct EmbeddedAsset {
+  const char* path;
+  const uint8_t* data;
+  uint32_t length;
+  const char* contentType;
+  const char* etag;   // ETag déjà entre guillemets
+  bool gzip;
+};
+
+namespace AssetBundle {
+  // Recherche en O(1) par hachage parfait généré au build (tools/embed_assets.py) ;
+  // nullptr si le fichier n'est pas embarqué ou si le mode est désactivé
+  const EmbeddedAsset* find(const char* path);
+
+  size_t count();
+}
+
+#endif
@@ -5,84 +5,232 @@
 #include <ArduinoJson.h>
 #include <vector>
 #include <map>
+#include <memory>
+#include "Actuator.h"
+#include "ConfigArena.h"
+#include "Symbols.h"
 
+// Nombre maximal de capteurs adressables par le moteur de règles
+const int MAX_SENSOR_SLOTS = 32;
+const int MAX_ACTUATOR_SLOTS = 32;
+
+// Instantané binaire de la configuration validée, relu au démarrage tant que
+// le JSON n'a pas changé (0 : toujours analyser le JSON, pour comparaison)
+#ifndef CONFIG_SNAPSHOT
+  #define CONFIG_SNAPSHOT 1
+#endif
+
+// Les chaînes de la configuration sont rangées dans son arène (ConfigArena.h)
+// et vivent aussi longtemps qu'elle
 struct WiFiConfig {
-  String ssid;
-  String password;
+  const char* ssid = "";
+  const char* password = "";
 };
 
 struct AuthConfig {
-  String username;
-  String password;
-  String rootPassword;
+  const char* username = "";
+  const char* password = "";
+  const char* rootPassword = "";
 };
 
 struct SystemConfig {
   WiFiConfig wifi;
   AuthConfig auth;
-  bool captivePortal;
+  bool captivePortal = false;
 };
 
+// Identifiants et noms de types internés (Symbols.h) : seuls les libellés
+// libres restent du texte
 struct DeviceConfig {
-  String id;
-  String name;
-  String type;
-  String sensorType;
-  String actuatorType;
+  Symbol id;
+  const char* name;
+  Symbol type;
+  Symbol sensorType;
+  Symbol actuatorType;
   int pin;
   bool enabled;
   unsigned long readInterval;
   bool state;
+  int slot; // Index du capteur ou de l'actionneur actif, -1 sinon
 };
 
 struct Condition {
-  String sensorId;
-  String parameter;
-  String operator_;
+  Symbol sensorId;
+  Symbol parameter;
+  Symbol operator_;
   float value;
-  String logic;
+  Symbol logic;
 };
 
 struct Action {
-  String actuatorId;
-  String action;
+  Symbol actuatorId;
+  Symbol action;
   unsigned long duration;
-  String pattern;
+  Symbol pattern;
 };
 
 struct Schedule {
-  String startTime;
-  String endTime;
-  std::vector<String> days;
+  explicit Schedule(ConfigArena* arena) : startTime(""), endTime(""), days(arena) {}
+  
+  const char* startTime;
+  const char* endTime;
+  ArenaVector<Symbol> days;
+};
+
+// Représentation compilée des règles, résolue une seule fois au chargement
+enum class SensorField : uint8_t { TEMPERATURE, HUMIDITY, GAS, CURRENT, LIGHT, MOTION, PRESSED, UNKNOWN };
+enum class CompareOp : uint8_t { GT, LT, EQ, GE, LE, UNKNOWN };
+enum class LogicOp : uint8_t { AND, OR, UNKNOWN };
+enum class TriggerKind : uint8_t { SENSOR, SCHEDULE, UNKNOWN };
+enum class ActionOp : uint8_t { TURN_ON, TURN_OFF, TOGGLE, UNKNOWN };
+
+struct CompiledCondition {
+  int8_t slot;       // Index du capteur, -1 si le capteur n'existe pas
+  SensorField field;
+  CompareOp op;
+  LogicOp logic;     // Logique appliquée avec la condition évaluée suivante
+  float value;
+};
+
+struct CompiledAction {
+  int8_t actuator;        // Index de l'actionneur, -1 si l'actionneur n'existe pas
+  ActionOp op;
+  BuzzerPattern pattern;
+  unsigned long duration;
+};
+
+struct CompiledRule {
+  TriggerKind trigger;
+  bool timeDriven;             // Réévaluée périodiquement plutôt que sur nouvelle lecture
+  uint16_t firstCondition;     // Index dans Config::conditionProgram
+  uint16_t conditionCount;
+  uint16_t firstDeactivation;
+  uint16_t deactivationCount;
+  uint16_t firstAction;        // Index dans Config::actionProgram
+  uint16_t actionCount;
+  bool scheduleValid;
+  unsigned long scheduleStart; // Début de plage horaire en ms
+  unsigned long scheduleEnd;   // Fin de plage horaire en ms
 };
 
 struct RuleConfig {
-  String id;
-  String name;
+  explicit RuleConfig(ConfigArena* arena)
+    : name(""), conditions(arena), actions(arena), deactivationConditions(arena), schedule(arena) {}
+  
+  Symbol id;
+  const char* name;
   bool enabled;
-  String triggerType;
-  std::vector<Condition> conditions;
-  std::vector<Action> actions;
-  std::vector<Condition> deactivationConditions;
+  Symbol triggerType;
+  ArenaVector<Condition> conditions;
+  ArenaVector<Action> actions;
+  ArenaVector<Condition> deactivationConditions;
   Schedule schedule;
 };
 
+// Dimensions d'une configuration, relevées sur le document avant analyse :
+// l'arène est réservée en un seul bloc de la taille exacte
+struct ConfigExtent {
+  size_t devices = 0;
+  size_t rules = 0;
+  size_t conditions = 0;    // Conditions et conditions de désactivation
+  size_t actions = 0;
+  size_t days = 0;
+  size_t textBytes = 0;     // Chaînes libres, zéro final compris
+  
+  size_t arenaBytes() const;
+};
+
+// Une configuration et tout ce qu'elle contient occupent une seule arène :
+// un rechargement construit une nouvelle Config, l'échange avec l'ancienne
+// (swap) et la détruit, ce qui rend son arène au tas en une fois.
 class Config {
+private:
+  // Déclarée en premier : détruite après les vecteurs qu'elle porte
+  std::unique_ptr<ConfigArena> _arena;
+  
 public:
+  explicit Config(size_t arenaCapacity = 0);
+  // Copie profonde dans une nouvelle arène (édition REST sur une copie)
+  Config(const Config& other);
+  // Une Config déplacée n'a plus d'arène (arena() == nullptr) : elle ne peut
+  // qu'être détruite, rechargée (loadFromFile) ou recevoir une affectation
+  Config(Config&& other);
+  Config& operator=(Config&& other);
+  Config& operator=(const Config&) = delete;
+  
+  void swap(Config& other);
+  
   SystemConfig system;
-  std::vector<DeviceConfig> devices;
-  std::vector<RuleConfig> rules;
+  ArenaVector<DeviceConfig> devices;
+  ArenaVector<RuleConfig> rules;
+  
+  // Programme compilé, indexé comme rules
+  ArenaVector<CompiledRule> compiledRules;
+  ArenaVector<CompiledCondition> conditionProgram;
+  ArenaVector<CompiledAction> actionProgram;
+  int sensorSlotCount = 0;
+  int actuatorSlotCount = 0;
+  
+  // Index capteur -> règles dépendantes (format CSR) : les règles du capteur s
+  // sont sensorRuleIndex[sensorRuleOffsets[s] .. sensorRuleOffsets[s + 1]]
+  ArenaVector<uint16_t> sensorRuleOffsets;
+  ArenaVector<uint16_t> sensorRuleIndex;
+  
+  // Mesure du dernier chargement (démarrage ou rechargement)
+  bool loadedFromSnapshot = false;
+  uint32_t loadMicros = 0;
+  
+  const ConfigArena* arena() const { return _arena.get(); }
   
   bool loadFromFile(const String& filename);
   bool saveToFile(const String& filename);
   void printConfig();
   
+  // Instantané correspondant au fichier JSON filename, déjà écrit
+  bool writeSnapshot(const String& filename) const;
+  
+  // Édition d'un seul enregistrement (API REST) : ajout ou remplacement selon
+  // l'identifiant, puis index et programme compilé recalculés
+  int findDevice(Symbol id) const;
+  int findRule(Symbol id) const;
+  void putDevice(JsonObject deviceObj);
+  bool removeDevice(Symbol id);
+  void putRule(JsonObject ruleObj);
+  bool removeRule(Symbol id);
+  
+  // Même format que /configuration.json
+  static void writeDevice(JsonObject deviceObj, const DeviceConfig& device);
+  static void writeRule(JsonObject ruleObj, const RuleConfig& rule);
+  
+  // Première erreur des règles (déclencheur, grandeur, opérateur, action ou
+  // plage horaire inconnus, capteur ou actionneur absent), nullptr si aucune.
+  // Vérifiée avant d'appliquer une configuration reçue par l'API.
+  const char* validate() const;
+  const char* checkRule(const RuleConfig& rule) const;
+  
 private:
+  // Instantané binaire (src/ConfigSnapshot.cpp) : /configuration.json -> /configuration.bin
+  static String snapshotPath(const String& filename);
+  static bool hashFile(const String& filename, uint32_t& hash, uint32_t& size);
+  bool loadSnapshot(const String& path, uint32_t sourceHash, uint32_t sourceSize);
+  bool saveSnapshot(const String& path, uint32_t sourceHash, uint32_t sourceSize) const;
+
+  static ConfigExtent measure(JsonDocument& doc);
   void parseSystemConfig(JsonObject& systemObj);
   void parseDevices(JsonArray& devicesArray);
+  void parseDevice(JsonObject deviceObj, DeviceConfig& device);
+  void assignSlots();
   void parseRules(JsonArray& rulesArray);
-  void parseConditions(JsonArray& conditionsArray, std::vector<Condition>& conditions);
-  void parseActions(JsonArray& actionsArray, std::vector<Action>& actions);
+  void parseRule(JsonObject ruleObj, RuleConfig& rule);
+  static void writeConditions(JsonArray& conditionsArray, const ArenaVector<Condition>& conditions);
+  void parseConditions(JsonArray& conditionsArray, ArenaVector<Condition>& conditions);
+  void parseActions(JsonArray& actionsArray, ArenaVector<Action>& actions);
+  void compileRules();
+  void compileConditions(const ArenaVector<Condition>& conditions, uint16_t& first, uint16_t& count);
+  void compileActions(const RuleConfig& rule, uint16_t& first, uint16_t& count);
+  int findSensorSlot(Symbol sensorId) const;
+  int findActuatorSlot(Symbol actuatorId) const;
+  void buildDependencyIndex();
 };
 
 #endif
@@ -0,0 +1,90 @@
+#ifndef CONFIG_ARENA_H
+#define CONFIG_ARENA_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <vector>
+
+// Taille des blocs ajoutés quand le bloc initial est plein (édition REST)
+#ifndef CONFIG_ARENA_BLOCK
+  #define CONFIG_ARENA_BLOCK 1024
+#endif
+
+// Mémoire d'une configuration : allocation par incrément, jamais libérée
+// élément par élément. Le premier bloc est dimensionné d'après le document
+// chargé ; tout est rendu au tas d'un coup à la destruction de l'arène.
+// Non thread-safe : une arène n'est remplie que par la tâche qui construit
+// sa configuration.
+class ConfigArena {
+public:
+  explicit ConfigArena(size_t capacity);
+  ~ConfigArena();
+
+  void* allocate(size_t size, size_t align);
+
+  // Copie terminée par un zéro ("" pour une chaîne vide ou absente, sans allocation)
+  const char* copy(const char* text);
+
+  size_t used() const { return _used; }
+  size_t capacity() const { return _capacity; }
+  size_t blocks() const { return _blocks; }
+
+  // Octets de toutes les arènes vivantes, et leur maximum depuis le démarrage :
+  // pendant un rechargement, l'ancienne et la nouvelle configuration coexistent
+  static size_t liveBytes() { return _live.load(std::memory_order_relaxed); }
+  static size_t peakBytes() { return _peak.load(std::memory_order_relaxed); }
+
+private:
+  struct Block {
+    Block* previous;
+    size_t size;
+    size_t top;
+  };
+
+  ConfigArena(const ConfigArena&) = delete;
+  ConfigArena& operator=(const ConfigArena&) = delete;
+
+  Block* addBlock(size_t size);
+
+  Block* _current;
+  size_t _used;
+  size_t _capacity;
+  size_t _blocks;
+
+  static std::atomic<size_t> _live;
+  static std::atomic<size_t> _peak;
+};
+
+// Allocateur std::vector sur une ConfigArena : deallocate() ne fait rien, la
+// mémoire est rendue avec l'arène. Il suit le conteneur lors des déplacements
+// et des échanges, jamais lors des copies.
+template <typename T>
+struct ArenaAllocator {
+  typedef T value_type;
+  typedef std::true_type propagate_on_container_move_assignment;
+  typedef std::true_type propagate_on_container_swap;
+
+  ConfigArena* arena;
+
+  ArenaAllocator(ConfigArena* arena) : arena(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+  T* allocate(size_t count) {
+    void* pointer = arena->allocate(count * sizeof(T), alignof(T));
+    // Comme operator new sans exceptions
+    if (!pointer) abort();
+    return static_cast<T*>(pointer);
+  }
+  void deallocate(T*, size_t) {}
+};
+
+template <typename T, typename U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena == b.arena; }
+template <typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) { return a.arena != b.arena; }
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef DEVICE_REGISTRY_H
+#define DEVICE_REGISTRY_H
+
+#include <Arduino.h>
+#include <new>
+#include <type_traits>
+#include "Sensor.h"
+#include "Actuator.h"
+
+// Multiplicateur des tailles de réserve de src/DeviceRegistry.cpp (le banc
+// env:native-bench génère jusqu'à 200 dispositifs)
+#ifndef DEVICE_POOL_SCALE
+  #define DEVICE_POOL_SCALE 1
+#endif
+
+// Réserve statique d'objets d'un modèle : N emplacements en .bss, attribués
+// par un masque de bits. Ni allocation ni fragmentation à la création d'un
+// dispositif ; un emplacement libéré est réutilisé par la reconfiguration.
+// Créations et destructions par la seule tâche de contrôle.
+template <typename T, size_t N>
+class DevicePool {
+  static_assert(N > 0, "DevicePool holds at least one object");
+
+public:
+  template <typename Base>
+  static Base* create(Symbol id, const char* name, int pin) {
+    for (size_t i = 0; i < N; i++) {
+      uint32_t bit = 1UL << (i % 32);
+      if (!(_used[i / 32] & bit)) {
+        _used[i / 32] |= bit;
+        return new (&_storage[i]) T(id, name, pin);
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename Base>
+  static void destroy(Base* device) {
+    T* object = static_cast<T*>(device);
+    size_t index = reinterpret_cast<Storage*>(object) - _storage;
+    object->~T();
+    _used[index / 32] &= ~(1UL << (index % 32));
+  }
+
+  static size_t used() {
+    size_t count = 0;
+    for (size_t w = 0; w < WORDS; w++) count += __builtin_popcount(_used[w]);
+    return count;
+  }
+
+private:
+  typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type Storage;
+  static const size_t WORDS = (N + 31) / 32;
+
+  static Storage _storage[N];
+  static uint32_t _used[WORDS];
+};
+
+template <typename T, size_t N>
+typename DevicePool<T, N>::Storage DevicePool<T, N>::_storage[N];
+
+template <typename T, size_t N>
+uint32_t DevicePool<T, N>::_used[DevicePool<T, N>::WORDS];
+
+// Entrée du registre : modèle (sensor_type / actuator_type de la
+// configuration) et fonctions de sa réserve
+template <typename Base>
+struct DeviceDriver {
+  Symbol model;
+  size_t capacity;
+  Base* (*create)(Symbol id, const char* name, int pin);
+  void (*destroy)(Base* device);
+  size_t (*used)();
+};
+
+typedef DeviceDriver<BaseSensor> SensorDriver;
+typedef DeviceDriver<BaseActuator> ActuatorDriver;
+
+// Entrée pour le modèle T (T::MODEL) et une réserve de N objets
+template <typename Base, typename T, size_t N>
+constexpr DeviceDriver<Base> deviceDriver() {
+  return { T::MODEL, N, &DevicePool<T, N>::template create<Base>,
+           &DevicePool<T, N>::template destroy<Base>, &DevicePool<T, N>::used };
+}
+
+// Registre des pilotes (src/DeviceRegistry.cpp) : ajouter un modèle, c'est
+// ajouter une ligne à ces tables
+extern const SensorDriver sensorDrivers[];
+extern const size_t sensorDriverCount;
+extern const ActuatorDriver actuatorDrivers[];
+extern const size_t actuatorDriverCount;
+
+// Pilote du modèle, nullptr s'il n'est pas enregistré
+const SensorDriver* findSensorDriver(Symbol model);
+const ActuatorDriver* findActuatorDriver(Symbol model);
+
+// Destruction et retour à la réserve d'un dispositif créé par son pilote
+void destroySensor(BaseSensor* sensor);
+void destroyActuator(BaseActuator* actuator);
+
+#endif
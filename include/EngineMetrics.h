@@ -0,0 +1,23 @@
+#ifndef ENGINE_METRICS_H
+#define ENGINE_METRICS_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+#ifndef MAX_RULE_METRICS
+  #define MAX_RULE_METRICS 64
+#endif
+
+// Compteurs du moteur exposés par /metrics : tableaux fixes indexés par case,
+// incrémentés par la tâche de contrôle et remis à zéro à chaque reconfiguration
+struct EngineMetrics {
+  volatile uint32_t sensorReads[MAX_SENSOR_SLOTS];
+  volatile uint32_t sensorInvalidReads[MAX_SENSOR_SLOTS];
+  volatile uint32_t ruleEvaluations[MAX_RULE_METRICS];
+  volatile uint32_t ruleActivations[MAX_RULE_METRICS];
+  volatile uint32_t actuatorToggles[MAX_ACTUATOR_SLOTS];
+};
+
+extern EngineMetrics engineMetrics;
+
+#endif
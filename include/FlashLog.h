@@ -0,0 +1,114 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+
+// Partition de données réservée au journal (partitions.csv)
+#ifndef FLASH_LOG_PARTITION
+  #define FLASH_LOG_PARTITION "tslog"
+#endif
+
+// Unité d'écriture : une page complète par commit, 8 pages par segment
+// (secteur de 4 Ko, unité d'effacement de la flash)
+#ifndef FLASH_LOG_PAGE_SIZE
+  #define FLASH_LOG_PAGE_SIZE 512
+#endif
+
+// Délai maximal avant d'écrire une page incomplète (perte max. à la coupure)
+#ifndef FLASH_LOG_FLUSH_MS
+  #define FLASH_LOG_FLUSH_MS 600000
+#endif
+
+// La source d'un enregistrement est désignée par l'empreinte de son
+// identifiant (SymbolTable::fingerprint, 32 bits) : un index de case ou de
+// règle changerait de sens à la reconfiguration suivante
+enum class FlashRecordType : uint8_t {
+  BOOT = 1,      // Démarrage : raison du reset
+  // Anciens formats, source sur un octet (index de case ou de règle), relus
+  // avec la source "#index"
+  READING_BY_INDEX = 2,
+  ACTUATOR_BY_INDEX = 3,
+  RULE_BY_INDEX = 4,
+  READING = 5,   // Lecture capteur : source, puis couples (grandeur, valeur float)
+  ACTUATOR = 6,  // Changement d'état d'un actionneur : source, état
+  RULE = 7       // Activation / désactivation d'une règle : source, état
+};
+
+// Enregistrement restitué à la lecture ; data pointe dans un tampon
+// temporaire, valide pendant l'appel du visiteur seulement
+struct FlashRecord {
+  uint32_t boot;   // Numéro de démarrage (incrémenté à chaque begin())
+  uint32_t time;   // millis() au moment de l'enregistrement
+  FlashRecordType type;
+  uint8_t length;
+  const uint8_t* data;
+};
+
+typedef void (*FlashRecordVisitor)(const FlashRecord& record, void* context);
+
+// Journal circulaire en ajout seul sur une partition brute. Les
+// enregistrements s'accumulent dans une page en RAM écrite d'un bloc quand
+// elle est pleine (ou après FLASH_LOG_FLUSH_MS). Chaque page porte un numéro
+// de séquence et un CRC32 : au démarrage, seule la première page de chaque
+// segment est lue pour retrouver le segment courant, puis ses pages pour
+// retrouver la position d'écriture. Rétention : quand la partition est
+// pleine, le segment le plus ancien est effacé.
+// Non thread-safe : un seul propriétaire (la tâche web).
+class FlashLog {
+public:
+  FlashLog();
+
+  bool begin(const char* label = FLASH_LOG_PARTITION);
+  bool isReady() const { return _partition != nullptr; }
+
+  bool append(FlashRecordType type, uint32_t time, const void* data, uint8_t length);
+
+  // Écrit la page en cours si elle attend depuis plus de FLASH_LOG_FLUSH_MS
+  void loop(uint32_t now);
+  bool flush();
+
+  // Parcourt tous les enregistrements, du plus ancien à la page en RAM ;
+  // les pages dont le CRC est faux sont ignorées
+  size_t read(FlashRecordVisitor visitor, void* context) const;
+
+  uint32_t boot() const { return _boot; }
+  size_t segmentCount() const { return _segmentCount; }
+  size_t pagesWritten() const { return _pagesWritten; }
+  size_t capacity() const;
+  // Pages illisibles vues au démarrage (écriture interrompue par une coupure)
+  uint32_t corruptPages() const { return _corruptPages; }
+
+private:
+  struct PageHeader {
+    uint16_t magic;
+    uint16_t length;    // Octets d'enregistrements dans la page
+    uint32_t sequence;  // Croissant sur toute la partition
+    uint32_t boot;
+    uint32_t crc;       // CRC32 de l'en-tête (hors crc) et des données
+  };
+
+  static const size_t PAGE_DATA = FLASH_LOG_PAGE_SIZE - sizeof(PageHeader);
+
+  const esp_partition_t* _partition;
+  size_t _segmentCount;
+  size_t _pagesPerSegment;
+  size_t _writePage;      // Prochaine page à écrire (index absolu)
+  uint32_t _sequence;     // Séquence de la prochaine page
+  uint32_t _boot;
+  size_t _pagesWritten;
+  uint32_t _corruptPages;
+
+  // Page en cours de remplissage
+  alignas(4) uint8_t _page[FLASH_LOG_PAGE_SIZE];
+  size_t _pageLength;
+  uint32_t _pageStarted;
+
+  bool readPage(size_t page, uint8_t* buffer) const;
+  bool isErased(size_t page) const;
+  static uint32_t pageCrc(const uint8_t* page);
+  static size_t visitRecords(const uint8_t* data, size_t length, uint32_t boot,
+                             FlashRecordVisitor visitor, void* context);
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <Arduino.h>
+
+// Bloc compressé : en-tête + HISTORY_BLOCK_SIZE octets de points encodés
+#ifndef HISTORY_BLOCK_SIZE
+  #define HISTORY_BLOCK_SIZE 256
+#endif
+
+// Blocs par niveau et par série ; le plus ancien est écrasé quand le dernier
+// est plein. Avec des mesures usuelles (~8 octets par agrégat), cela garde
+// quelques minutes de brut, ~2 h à la minute, ~1 jour au quart d'heure et
+// ~7 jours à l'heure, soit ~4 Ko par série.
+#ifndef HISTORY_RAW_BLOCKS
+  #define HISTORY_RAW_BLOCKS 2
+#endif
+#ifndef HISTORY_MINUTE_BLOCKS
+  #define HISTORY_MINUTE_BLOCKS 4
+#endif
+#ifndef HISTORY_QUARTER_BLOCKS
+  #define HISTORY_QUARTER_BLOCKS 4
+#endif
+#ifndef HISTORY_HOUR_BLOCKS
+  #define HISTORY_HOUR_BLOCKS 6
+#endif
+
+#ifndef HISTORY_MAX_SERIES
+  #define HISTORY_MAX_SERIES 16
+#endif
+
+// Niveaux de résolution : mesures brutes puis agrégats min/max/moyenne
+enum class HistoryTier : uint8_t { RAW, MINUTE, QUARTER, HOUR };
+const int HISTORY_TIERS = 4;
+
+// Point restitué ; au niveau RAW, min = max = avg = valeur mesurée
+struct HistoryPoint {
+  uint32_t timestamp;  // millis() de la mesure, ou début de l'intervalle agrégé
+  float min;
+  float max;
+  float avg;
+};
+
+typedef void (*HistoryVisitor)(const HistoryPoint& point, void* context);
+
+// Historique en RAM des mesures, compressé à la Gorilla : horodatages en
+// delta-de-delta, valeurs en XOR avec la précédente. Chaque série garde un
+// anneau de blocs par niveau ; les agrégats 1 min / 15 min / 1 h sont
+// produits au fil de l'eau à partir des mesures brutes.
+// Non thread-safe : un seul propriétaire (la tâche web).
+class History {
+public:
+  History();
+  ~History();
+
+  // Réserve la mémoire de toutes les séries, une seule fois au démarrage
+  bool begin(size_t seriesCount);
+  size_t seriesCount() const { return _seriesCount; }
+
+  // Ajoute une mesure ; les horodatages d'une série doivent être croissants
+  void record(int series, uint32_t timestamp, float value);
+
+  // Oublie les points d'une série (réattribuée à un autre capteur)
+  void reset(int series);
+
+  // Parcourt les points de [from, to] du plus ancien au plus récent,
+  // retourne leur nombre
+  size_t query(int series, HistoryTier tier, uint32_t from, uint32_t to,
+               HistoryVisitor visitor, void* context) const;
+
+  // Niveau le plus fin dont les intervalles couvrent step (ms) et qui
+  // remonte jusqu'à from
+  HistoryTier tierFor(int series, uint32_t from, uint32_t step) const;
+
+  static uint32_t period(HistoryTier tier);
+
+  // Octets réservés et octets de données encodées
+  size_t capacity() const;
+  size_t used() const;
+
+private:
+  struct Block {
+    uint32_t firstTime;
+    uint16_t bits;
+    uint16_t count;
+    uint8_t data[HISTORY_BLOCK_SIZE];
+  };
+
+  // État de l'encodeur du bloc courant
+  struct Encoder {
+    uint32_t lastTime;
+    int32_t lastDelta;
+    uint32_t lastValues[3];
+    uint8_t leading[3];
+    uint8_t trailing[3];
+  };
+
+  struct Ring {
+    Block* blocks;
+    uint8_t capacity;
+    uint8_t head;   // Bloc en cours d'écriture
+    uint8_t used;
+    Encoder encoder;
+  };
+
+  // Agrégat en cours pour un niveau
+  struct Rollup {
+    uint32_t bucket;
+    float min;
+    float max;
+    float sum;
+    uint32_t count;
+  };
+
+  struct Series {
+    Ring rings[HISTORY_TIERS];
+    Rollup rollups[HISTORY_TIERS]; // Index 0 inutilisé (niveau RAW)
+  };
+
+  Series* _series;
+  size_t _seriesCount;
+  Block* _pool;
+  size_t _poolBlocks;
+
+  void clear(Series& series);
+  void accumulate(Series& series, int tier, uint32_t timestamp, float min, float max, float sum, uint32_t count);
+  void append(Ring& ring, int values, uint32_t timestamp, const float* data);
+  static bool encode(Block& block, Encoder& encoder, int values, uint32_t timestamp, const float* data);
+  static size_t decode(const Block& block, int values, uint32_t from, uint32_t to,
+                       HistoryVisitor visitor, void* context);
+};
+
+#endif
@@ -0,0 +1,236 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <Print.h>
+#include <HTTP_Method.h>
+#include <vector>
+
+// Connexions simultanées : lwIP est limité à CONFIG_LWIP_MAX_SOCKETS (10 par
+// défaut), dont un pour l'écoute et un pour le serveur DNS
+#ifndef HTTP_MAX_CONNECTIONS
+  #define HTTP_MAX_CONNECTIONS 6
+#endif
+
+// Fermeture d'une connexion inactive (keep-alive ou client trop lent)
+#ifndef HTTP_IDLE_TIMEOUT_MS
+  #define HTTP_IDLE_TIMEOUT_MS 5000
+#endif
+
+// Requêtes servies avant de fermer une connexion persistante
+#ifndef HTTP_MAX_REQUESTS
+  #define HTTP_MAX_REQUESTS 100
+#endif
+
+#ifndef HTTP_MAX_HEADER_SIZE
+  #define HTTP_MAX_HEADER_SIZE 2048
+#endif
+#ifndef HTTP_MAX_BODY_SIZE
+  #define HTTP_MAX_BODY_SIZE 16384
+#endif
+
+// Taille d'un envoi de fichier et quota d'octets par connexion et par tour,
+// pour que les téléchargements simultanés progressent ensemble
+#ifndef HTTP_CHUNK_SIZE
+  #define HTTP_CHUNK_SIZE 1436
+#endif
+#ifndef HTTP_WRITE_BUDGET
+  #define HTTP_WRITE_BUDGET 4096
+#endif
+
+// Flux Server-Sent Events : commentaire périodique pour détecter les clients
+// disparus, et retard d'envoi toléré avant d'abandonner un client trop lent
+#ifndef HTTP_EVENT_HEARTBEAT_MS
+  #define HTTP_EVENT_HEARTBEAT_MS 15000
+#endif
+#ifndef HTTP_EVENT_BACKLOG
+  #define HTTP_EVENT_BACKLOG 8192
+#endif
+
+// Attente maximale d'un client qui ne lit plus pendant une réponse chunked
+#ifndef HTTP_STREAM_TIMEOUT_MS
+  #define HTTP_STREAM_TIMEOUT_MS 1000
+#endif
+
+typedef void (*HttpHandler)();
+
+class HttpServer;
+
+// Corps d'une réponse chunked, alimenté par print() ou serializeJson()
+class ChunkedWriter : public Print {
+public:
+  ChunkedWriter(HttpServer& server) : _server(server) {}
+
+  size_t write(uint8_t byte) override { return write(&byte, 1); }
+  size_t write(const uint8_t* buffer, size_t size) override;
+
+private:
+  HttpServer& _server;
+};
+
+struct HttpArgument {
+  String name;
+  String value;
+};
+
+// Requêtes servies par une route et durée cumulée de leur traitement
+struct HttpRouteStats {
+  uint32_t requests;
+  uint64_t totalMicros;
+};
+
+// Serveur HTTP/1.1 piloté par select() : plusieurs connexions non bloquantes,
+// keep-alive et délai d'inactivité par connexion. Les gestionnaires gardent
+// l'API de WebServer (arg, hasArg, send, streamFile...) et s'exécutent un par
+// un dans la tâche web ; seuls les envois sont entrelacés entre connexions.
+class HttpServer {
+public:
+  HttpServer(uint16_t port = 80);
+  ~HttpServer();
+
+  void begin();
+  void stop();
+
+  // uri peut contenir des segments "{}", relus par pathArg() (/api/rules/{})
+  void on(const String& uri, HttpHandler handler);
+  void on(const String& uri, HTTPMethod method, HttpHandler handler);
+  void onNotFound(HttpHandler handler);
+
+  // Attend au plus waitMs une activité réseau puis traite toutes les
+  // connexions prêtes
+  void handleClient(uint32_t waitMs = 10);
+  // Compteur de cycles au retour de select() dans le dernier handleClient() :
+  // mesure le traitement sans l'attente réseau
+  uint32_t wakeCycles() const { return _wakeCycles; }
+
+  // Requête en cours de traitement (valide dans un gestionnaire)
+  HTTPMethod method() const { return _method; }
+  const String& uri() const { return _uri; }
+  String arg(const String& name) const;
+  bool hasArg(const String& name) const;
+  String pathArg(unsigned int index) const;
+  // Corps brut, lisible sans copie (arg("plain") en renvoie une copie)
+  const String& body() const { return _body; }
+  String header(const String& name) const;
+  bool hasHeader(const String& name) const;
+
+  // Réponse : un seul envoi par requête, les en-têtes ajoutés avant
+  void sendHeader(const String& name, const String& value, bool first = false);
+  void send(int code, const char* contentType = nullptr, const String& content = String());
+  void send(int code, const String& contentType, const String& content) { send(code, contentType.c_str(), content); }
+
+  // Corps constant (flash projetée) envoyé directement depuis content, sans
+  // copie intermédiaire ; le pointeur doit rester valide jusqu'à la fin de l'envoi
+  void send_P(int code, const char* contentType, const char* content, size_t length);
+
+  // Le fichier est envoyé par morceaux au fil des tours, le serveur en garde
+  // une référence : l'appelant n'a pas à le fermer. Un fichier .gz est servi
+  // avec Content-Encoding: gzip.
+  size_t streamFile(File file, const String& contentType);
+
+  // Réponse de longueur inconnue écrite pendant le gestionnaire : les données
+  // passent par un tampon fixe (celui des envois de fichiers) vidé vers la
+  // socket en Transfer-Encoding: chunked à chaque remplissage. La mémoire
+  // utilisée ne dépend donc pas de la taille de la réponse.
+  Print& beginChunked(int code, const char* contentType);
+  void endChunked();
+
+  // Server-Sent Events : dans un gestionnaire, beginEventStream() garde la
+  // connexion ouverte comme abonnée et sendEvent() lui envoie un premier état.
+  // broadcastEvent() formate l'événement une seule fois pour tous les abonnés.
+  bool beginEventStream();
+  void sendEvent(const char* event, const String& data);
+  void broadcastEvent(const char* event, const String& data);
+  size_t eventSubscribers() const;
+
+  size_t activeConnections() const;
+  uint32_t requestCount() const { return _requestCount; }
+
+  // Compteurs par route, dans l'ordre d'enregistrement ; les requêtes sans
+  // route sont comptées à part
+  size_t routeCount() const { return _routes.size(); }
+  const String& routeUri(size_t index) const { return _routes[index].uri; }
+  HTTPMethod routeMethod(size_t index) const { return _routes[index].method; }
+  const HttpRouteStats& routeStats(size_t index) const { return _routes[index].stats; }
+  const HttpRouteStats& unmatchedStats() const { return _unmatchedStats; }
+  static const char* methodName(HTTPMethod method);
+
+private:
+  enum class ConnectionState : uint8_t { FREE, READING, WRITING, STREAMING };
+
+  struct Connection {
+    int fd;
+    ConnectionState state;
+    bool keepAlive;
+    bool eventStream;
+    uint16_t requests;
+    uint32_t lastActivity;
+    String input;
+    String output;
+    size_t outputPos;
+    const char* body;
+    size_t bodyRemaining;
+    File file;
+  };
+
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    HttpHandler handler;
+    HttpRouteStats stats;
+  };
+
+  uint16_t _port;
+  int _listenFd;
+  Connection _connections[HTTP_MAX_CONNECTIONS];
+  std::vector<Route> _routes;
+  HttpHandler _notFoundHandler;
+  HttpRouteStats _unmatchedStats;
+  uint32_t _requestCount;
+  uint32_t _lastHeartbeat;
+  uint32_t _wakeCycles;
+
+  // Requête courante
+  Connection* _current;
+  HTTPMethod _method;
+  bool _headOnly;
+  bool _responded;
+  String _uri;
+  String _body;
+  std::vector<HttpArgument> _args;
+  std::vector<String> _pathArgs;
+  std::vector<HttpArgument> _headers;
+  String _extraHeaders;
+  bool _http11;
+
+  // Réponse chunked en cours
+  ChunkedWriter _writer;
+  bool _chunked;
+  bool _streamFailed;
+  size_t _chunkLength;
+
+  // Tampon de lecture des fichiers, partagé puisque tout se passe dans la tâche web
+  uint8_t _chunk[HTTP_CHUNK_SIZE];
+
+  void acceptConnections();
+  void readConnection(Connection& conn);
+  void writeConnection(Connection& conn);
+  void closeConnection(Connection& conn);
+  void processInput(Connection& conn);
+  bool parseRequest(Connection& conn, int headerEnd, size_t& consumed);
+  void dispatch();
+  bool flushOutput(Connection& conn);
+  void completeResponse(Connection& conn);
+  void sendError(Connection& conn, int code);
+  void queueEvent(Connection& conn, const String& event);
+  size_t appendChunk(const uint8_t* data, size_t size);
+  bool flushChunk(bool last);
+  bool writeAll(Connection& conn, const char* data, size_t length);
+
+  friend class ChunkedWriter;
+  String statusHeader(int code, const char* contentType, size_t length);
+  void parseArguments(const String& data);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Taille de l'arène des documents JSON de la tâche web
+#ifndef JSON_ARENA_SIZE
+  #define JSON_ARENA_SIZE 4096
+#endif
+
+// Allocateur ArduinoJson sur une zone fixe réservée au démarrage :
+// allocation par incrément, la zone est entièrement libérée quand le dernier
+// bloc l'est (JsonDocument::clear()). Au-delà de la capacité, repli sur le tas.
+// Non thread-safe : un seul propriétaire (la tâche web).
+class JsonArena : public ArduinoJson::Allocator {
+public:
+  JsonArena();
+
+  void* allocate(size_t size) override;
+  void deallocate(void* pointer) override;
+  void* reallocate(void* pointer, size_t newSize) override;
+
+  size_t used() const { return _top; }
+  size_t highWater() const { return _highWater; }
+  uint32_t heapFallbacks() const { return _heapFallbacks; }
+
+private:
+  // Chaque bloc est précédé de sa taille pour permettre reallocate()
+  struct Header {
+    uint32_t size;
+  };
+
+  alignas(8) uint8_t _buffer[JSON_ARENA_SIZE];
+  size_t _top;
+  size_t _lastBlock;
+  size_t _liveBlocks;
+  size_t _highWater;
+  uint32_t _heapFallbacks;
+
+  bool owns(const void* pointer) const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <Arduino.h>
+
+// Histogramme de durées en cycles CPU, une case par puissance de 2 : la case b
+// compte les durées de [2^b, 2^(b+1)) cycles (0 et 1 dans la case 0).
+// Un seul écrivain ; les lecteurs d'une autre tâche voient des compteurs
+// 32 bits cohérents un à un, suffisants pour des percentiles.
+class LatencyHistogram {
+public:
+  static const int BUCKETS = 32;
+
+  LatencyHistogram() { reset(); }
+
+  // Enregistre la durée écoulée depuis start et retourne l'instant courant,
+  // pour chaîner les étapes d'une boucle avec une seule lecture du compteur
+  inline uint32_t recordSince(uint32_t start) {
+    uint32_t now = ESP.getCycleCount();
+    record(now - start);
+    return now;
+  }
+
+  inline void record(uint32_t cycles) {
+    _buckets[31 - __builtin_clz(cycles | 1)]++;
+    _count++;
+    if (cycles > _max) _max = cycles;
+  }
+
+  // Écrivain uniquement
+  void reset();
+
+  uint32_t count() const { return _count; }
+  uint32_t maxCycles() const { return _max; }
+
+  // Percentile (0-1) en cycles, interpolé linéairement dans sa case
+  uint32_t percentile(float fraction) const;
+
+private:
+  volatile uint32_t _buckets[BUCKETS];
+  volatile uint32_t _count;
+  volatile uint32_t _max;
+};
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <string.h>
+#include <type_traits>
+
+// Niveau de log retenu à la compilation, aligné sur CORE_DEBUG_LEVEL
+// (0=aucun, 1=erreur, 2=avertissement, 3=info, 4=debug, 5=verbose)
+#ifndef LOG_BUILD_LEVEL
+  #ifdef CORE_DEBUG_LEVEL
+    #define LOG_BUILD_LEVEL CORE_DEBUG_LEVEL
+  #else
+    #define LOG_BUILD_LEVEL 3
+  #endif
+#endif
+
+// Taille de l'anneau (puissance de 2) et longueur maximale d'une ligne
+#ifndef LOG_RING_SIZE
+  #define LOG_RING_SIZE 64
+#endif
+#ifndef LOG_LINE_SIZE
+  #define LOG_LINE_SIZE 96
+#endif
+
+// Arguments d'un message et place réservée à la copie de ses chaînes (%s)
+#ifndef LOG_MAX_ARGS
+  #define LOG_MAX_ARGS 8
+#endif
+#ifndef LOG_TEXT_SIZE
+  #define LOG_TEXT_SIZE 48
+#endif
+
+enum class LogLevel : uint8_t {
+  NONE = 0,
+  ERROR = 1,
+  WARN = 2,
+  INFO = 3,
+  DEBUG = 4,
+  VERBOSE = 5
+};
+
+namespace Log {
+  // Arguments bruts d'un message, mis en forme plus tard par la tâche de
+  // vidage : entiers étendus à 64 bits, flottants en double, pointeurs. Les
+  // chaînes sont copiées (tronquées au-delà de LOG_TEXT_SIZE), celles de
+  // l'appelant pouvant disparaître avant la mise en forme.
+  struct Arguments {
+    union Value {
+      long long integer;
+      unsigned long long unsignedInteger;
+      double real;
+      const void* pointer;
+      uint16_t text;      // Position dans text[]
+    };
+
+    uint8_t count = 0;
+    uint8_t textUsed = 0;
+    Value values[LOG_MAX_ARGS];
+    char text[LOG_TEXT_SIZE];
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type add(T value) {
+      if (count < LOG_MAX_ARGS) values[count++].integer = value;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value>::type add(T value) {
+      if (count < LOG_MAX_ARGS) values[count++].unsignedInteger = value;
+    }
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type add(T value) {
+      if (count < LOG_MAX_ARGS) values[count++].real = value;
+    }
+    void add(const void* value) {
+      if (count < LOG_MAX_ARGS) values[count++].pointer = value;
+    }
+    void add(const char* value);
+    void add(char* value) { add((const char*)value); }
+  };
+
+  // Démarre la tâche basse priorité qui vide l'anneau vers Serial
+  void begin();
+
+  // Range le format et les arguments bruts dans une case de l'anneau (sans
+  // allocation ni mise en forme). Le format doit être une chaîne constante.
+  // Ne bloque jamais : le message est abandonné si l'anneau est plein
+  void commit(LogLevel level, const char* format, const Arguments& arguments);
+
+  inline void collect(Arguments&) {}
+  template <typename T, typename... Rest>
+  inline void collect(Arguments& arguments, T value, Rest... rest) {
+    arguments.add(value);
+    collect(arguments, rest...);
+  }
+
+  template <typename... Args>
+  inline void write(LogLevel level, const char* format, Args... args) {
+    Arguments arguments;
+    collect(arguments, args...);
+    commit(level, format, arguments);
+  }
+
+  // Jamais appelée : vérification du format par le compilateur
+  inline void checkFormat(const char*, ...) __attribute__((format(printf, 1, 2)));
+  inline void checkFormat(const char*, ...) {}
+
+  // Vide l'anneau de façon synchrone, retourne le nombre de lignes écrites
+  size_t drain();
+
+  // Nombre de messages perdus faute de place
+  uint32_t dropped();
+}
+
+// Les appels sous le niveau de compilation disparaissent, arguments compris ;
+// le format des autres est vérifié comme celui de printf
+#if LOG_BUILD_LEVEL >= 1
+  #define LOG_E(...) (false ? Log::checkFormat(__VA_ARGS__) : Log::write(LogLevel::ERROR, __VA_ARGS__))
+#else
+  #define LOG_E(...) ((void)0)
+#endif
+
+#if LOG_BUILD_LEVEL >= 2
+  #define LOG_W(...) (false ? Log::checkFormat(__VA_ARGS__) : Log::write(LogLevel::WARN, __VA_ARGS__))
+#else
+  #define LOG_W(...) ((void)0)
+#endif
+
+#if LOG_BUILD_LEVEL >= 3
+  #define LOG_I(...) (false ? Log::checkFormat(__VA_ARGS__) : Log::write(LogLevel::INFO, __VA_ARGS__))
+#else
+  #define LOG_I(...) ((void)0)
+#endif
+
+#if LOG_BUILD_LEVEL >= 4
+  #define LOG_D(...) (false ? Log::checkFormat(__VA_ARGS__) : Log::write(LogLevel::DEBUG, __VA_ARGS__))
+#else
+  #define LOG_D(...) ((void)0)
+#endif
+
+#if LOG_BUILD_LEVEL >= 5
+  #define LOG_V(...) (false ? Log::checkFormat(__VA_ARGS__) : Log::write(LogLevel::VERBOSE, __VA_ARGS__))
+#else
+  #define LOG_V(...) ((void)0)
+#endif
+
+#endif
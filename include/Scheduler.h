@@ -0,0 +1,68 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <Arduino.h>
+
+typedef void (*TimerCallback)(void* context);
+
+struct TimerLink {
+  TimerLink* next;
+  TimerLink* prev;
+};
+
+// Échéance enregistrée dans la roue ; l'objet appartient au composant qui
+// l'arme et ne doit pas être détruit tant qu'il est armé
+struct Timer : TimerLink {
+  uint32_t expires;
+  TimerCallback callback;
+  void* context;
+  uint8_t level;
+  uint8_t slot;
+
+  Timer(TimerCallback cb = nullptr, void* ctx = nullptr);
+  bool isArmed() const { return next != nullptr; }
+};
+
+// Roue de temporisation hiérarchique (4 niveaux de 64 cases, 1 tick = 1 ms) :
+// insertion et annulation en O(1), les échéances lointaines descendent d'un
+// niveau à chaque tour de la roue inférieure. Les échéances au-delà de
+// 64^4 ms (~4,6 h) sont replacées au dernier niveau jusqu'à être à portée.
+class TimerWheel {
+public:
+  TimerWheel();
+
+  // Arme (ou réarme) le timer pour l'instant absolu expires (en ms)
+  void schedule(Timer& timer, uint32_t expires);
+  void scheduleIn(Timer& timer, uint32_t delay) { schedule(timer, millis() + delay); }
+  void cancel(Timer& timer);
+
+  // Déclenche tous les timers échus jusqu'à now inclus
+  void advance(uint32_t now);
+
+  // Prochain instant où la roue doit être avancée (échéance ou cascade) ;
+  // false si aucun timer n'est armé
+  bool nextDeadline(uint32_t& deadline) const;
+
+  size_t size() const { return _count; }
+
+private:
+  static const int LEVELS = 4;
+  static const int SLOT_BITS = 6;
+  static const int SLOTS = 1 << SLOT_BITS;
+  static const uint32_t SLOT_MASK = SLOTS - 1;
+
+  TimerLink _slots[LEVELS][SLOTS];
+  uint64_t _occupied[LEVELS];
+  uint32_t _current; // Prochain tick à traiter
+  size_t _count;
+  bool _started;
+
+  void insert(Timer& timer);
+  void unlink(Timer& timer);
+  void cascade(int level, uint32_t index);
+};
+
+// Roue unique de la tâche de contrôle
+extern TimerWheel scheduler;
+
+#endif
@@ -2,11 +2,19 @@
 #define SENSOR_H
 
 #include <Arduino.h>
-#include <DHT.h>
+#include <driver/rmt.h>
+#include "Scheduler.h"
+#include "Symbols.h"
 
+// Intervalle de lecture minimal (ms) : un read_interval plus court, ou 0,
+// réarmerait le capteur aussitôt et monopoliserait la tâche de contrôle
+#ifndef SENSOR_MIN_READ_INTERVAL
+  #define SENSOR_MIN_READ_INTERVAL 20
+#endif
+
+// Lecture d'un capteur : rangée par case (BaseSensor::getSlot()), le capteur
+// porte lui-même son identifiant et son modèle
 struct SensorReading {
-  String sensorId;
-  String type;
   float temperature;
   float humidity;
   float gas;
@@ -20,49 +28,103 @@ struct SensorReading {
 
 class BaseSensor {
 public:
-  BaseSensor(String id, String name, int pin);
-  virtual ~BaseSensor() {}
+  BaseSensor(Symbol id, String name, int pin);
+  virtual ~BaseSensor() { scheduler.cancel(_timer); }
   
   virtual void init() = 0;
   virtual SensorReading read() = 0;
   virtual bool isReady();
   
-  String getId() const { return _id; }
-  String getName() const { return _name; }
+  // Fait avancer l'acquisition sans bloquer ; retourne true quand une
+  // nouvelle lecture est disponible dans reading
+  virtual bool poll(SensorReading& reading);
+  
+  // Délai (ms) avant que poll() ait de nouveau du travail
+  virtual unsigned long nextPollDelay() const;
+  
+  // Échéance de la prochaine scrutation dans la roue de temporisation
+  Timer& timer() { return _timer; }
+  // sensor_type de la configuration ; chaque modèle le déclare aussi en
+  // MODEL, sa clé dans le registre des pilotes (DeviceRegistry.h)
+  virtual Symbol getModel() const = 0;
+  const char* getTypeName() const { return symbols.text(getModel()); }
+  
+  Symbol getId() const { return _id; }
+  const String& getName() const { return _name; }
+  void setName(const String& name) { _name = name; }
   int getPin() const { return _pin; }
-  void setReadInterval(unsigned long interval) { _readInterval = interval; }
+  void setReadInterval(unsigned long interval) {
+    _readInterval = interval < SENSOR_MIN_READ_INTERVAL ? SENSOR_MIN_READ_INTERVAL : interval;
+  }
   unsigned long getReadInterval() const { return _readInterval; }
+  unsigned long getLastRead() const { return _lastRead; }
+  void setSlot(int slot) { _slot = slot; }
+  int getSlot() const { return _slot; }
   
 protected:
-  String _id;
+  Symbol _id;
   String _name;
   int _pin;
+  int _slot;
   unsigned long _lastRead;
   unsigned long _readInterval;
+  Timer _timer;
 };
 
+// Pilote DHT11 asynchrone : le train d'impulsions est capturé par le
+// périphérique RMT, aucune section n'est bloquante ni sans interruptions
 class DHT11Sensor : public BaseSensor {
 public:
-  DHT11Sensor(String id, String name, int pin);
+  DHT11Sensor(Symbol id, String name, int pin);
+  ~DHT11Sensor() override;
   void init() override;
-  SensorReading read() override;
+  SensorReading read() override; // Dernier résultat, sans nouvelle acquisition
+  bool poll(SensorReading& reading) override;
+  unsigned long nextPollDelay() const override;
+  static constexpr Symbol MODEL = SYM_DHT11;
+  Symbol getModel() const override { return MODEL; }
+  
+  // Machine à états : start() lance une acquisition, update() la fait
+  // avancer et retourne true quand result() contient une nouvelle lecture
+  void start();
+  bool update();
+  const SensorReading& result() const { return _result; }
+  bool isBusy() const { return _state != State::IDLE; }
   
 private:
-  DHT* _dht;
+  enum class State : uint8_t { IDLE, START_SIGNAL, CAPTURE, RETRY_WAIT };
+  
+  State _state;
+  rmt_channel_t _channel;
+  RingbufHandle_t _ringbuf;
+  bool _rmtReady;
+  bool _retrying;
+  unsigned long _stateTime;
+  SensorReading _result;
+  
+  bool decode(const rmt_item32_t* items, size_t count, float& temperature, float& humidity);
+  void handleFailure();
+  void complete(bool isValid, float temperature, float humidity);
+  
+  static uint8_t _channelsInUse; // Un bit par canal RMT attribué
 };
 
 class MQ2Sensor : public BaseSensor {
 public:
-  MQ2Sensor(String id, String name, int pin);
+  MQ2Sensor(Symbol id, String name, int pin);
   void init() override;
   SensorReading read() override;
+  static constexpr Symbol MODEL = SYM_MQ2;
+  Symbol getModel() const override { return MODEL; }
 };
 
 class ASCSensor : public BaseSensor {
 public:
-  ASCSensor(String id, String name, int pin);
+  ASCSensor(Symbol id, String name, int pin);
   void init() override;
   SensorReading read() override;
+  static constexpr Symbol MODEL = SYM_ASC;
+  Symbol getModel() const override { return MODEL; }
   
 private:
   float _sensitivity;
@@ -71,16 +133,20 @@ private:
 
 class LDRSensor : public BaseSensor {
 public:
-  LDRSensor(String id, String name, int pin);
+  LDRSensor(Symbol id, String name, int pin);
   void init() override;
   SensorReading read() override;
+  static constexpr Symbol MODEL = SYM_LDR;
+  Symbol getModel() const override { return MODEL; }
 };
 
 class PIRSensor : public BaseSensor {
 public:
-  PIRSensor(String id, String name, int pin);
+  PIRSensor(Symbol id, String name, int pin);
   void init() override;
   SensorReading read() override;
+  static constexpr Symbol MODEL = SYM_PIR;
+  Symbol getModel() const override { return MODEL; }
   
 private:
   bool _lastState;
@@ -88,9 +154,11 @@ private:
 
 class ButtonSensor : public BaseSensor {
 public:
-  ButtonSensor(String id, String name, int pin);
+  ButtonSensor(Symbol id, String name, int pin);
   void init() override;
   SensorReading read() override;
+  static constexpr Symbol MODEL = SYM_BUTTON;
+  Symbol getModel() const override { return MODEL; }
   
 private:
   bool _lastState;
@@ -0,0 +1,41 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+#include "Sensor.h"
+
+// Copie POD d'une lecture, publiée par la tâche de contrôle pour la tâche web
+struct PublishedReading {
+  float temperature;
+  float humidity;
+  float gas;
+  float current;
+  float light;
+  bool motion;
+  bool pressed;
+  bool isValid;
+  unsigned long timestamp;
+};
+
+// Instantané des lectures protégé par un seqlock par capteur :
+// un seul écrivain (tâche de contrôle) qui ne bloque jamais, des lecteurs
+// qui recommencent leur copie si une publication a eu lieu entre-temps.
+class ReadingSnapshot {
+public:
+  ReadingSnapshot();
+
+  void publish(int slot, const SensorReading& reading);
+  bool read(int slot, PublishedReading& out) const;
+
+  // Incrémenté à chaque publication, permet de détecter un changement
+  uint32_t generation() const { return _generation.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> _seq[MAX_SENSOR_SLOTS];
+  PublishedReading _data[MAX_SENSOR_SLOTS];
+  std::atomic<uint32_t> _generation;
+};
+
+#endif
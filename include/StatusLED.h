@@ -2,6 +2,7 @@
 #define STATUS_LED_H
 
 #include <Arduino.h>
+#include "Scheduler.h"
 
 enum class LEDStatus {
   SYSTEM_NORMAL_IDLE,    // Bleu - Système fonctionne, aucun actionneur actif
@@ -15,7 +16,7 @@ public:
   
   void init();
   void setStatus(LEDStatus status);
-  void update(); // Pour les effets de clignotement
+  void update(); // Appelée à chaque échéance de clignotement
   void turnOff();
   
   // Méthodes utilitaires
@@ -31,6 +32,9 @@ private:
   bool _blinkState;
   unsigned long _lastBlink;
   unsigned long _blinkInterval;
+  Timer _blinkTimer;
+  
+  static void onBlinkTimer(void* context);
   
   // Couleurs prédéfinies
   void setRed();
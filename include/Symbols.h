@@ -0,0 +1,86 @@
+#ifndef SYMBOLS_H
+#define SYMBOLS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+// Identifiant interné : les identifiants et noms de types de la configuration
+// sont remplacés au chargement par un index dans la table, comparé comme un
+// entier. Le texte ne sert qu'à la frontière JSON / HTTP.
+typedef uint16_t Symbol;
+
+// Symboles prédéfinis, internés dans cet ordre à la construction de la table :
+// le code les compare sans consulter la table
+enum : Symbol {
+  SYM_EMPTY = 0,
+  // Nature d'un dispositif
+  SYM_SENSOR, SYM_ACTUATOR,
+  // Modèles
+  SYM_DHT11, SYM_MQ2, SYM_ASC, SYM_LDR, SYM_PIR, SYM_BUTTON,
+  SYM_RELAY, SYM_BUZZER,
+  // Grandeurs des conditions
+  SYM_TEMPERATURE, SYM_HUMIDITY, SYM_GAS, SYM_CURRENT, SYM_LIGHT, SYM_MOTION, SYM_PRESSED,
+  // Opérateurs et logique
+  SYM_GT, SYM_LT, SYM_EQ, SYM_GE, SYM_LE,
+  SYM_AND, SYM_OR,
+  // Actions et motifs du buzzer
+  SYM_TURN_ON, SYM_TURN_OFF, SYM_TOGGLE,
+  SYM_ALARM, SYM_BEEP,
+  // Déclencheurs
+  SYM_SENSOR_THRESHOLD, SYM_SENSOR_COMBINATION, SYM_CRITICAL_EVENT, SYM_SCHEDULE,
+  PREDEFINED_SYMBOLS
+};
+
+// Résultat de find() pour un texte jamais interné
+const Symbol SYMBOL_UNKNOWN = 0xFFFF;
+
+// Table de chaînes internées, jamais libérées : elle ne grandit qu'avec des
+// identifiants nouveaux, pas avec les rechargements d'une même configuration.
+// Le texte est rangé dans des blocs fixes qui ne bougent jamais, si bien que
+// text() se lit sans verrou depuis n'importe quelle tâche ; intern() et find()
+// sont sérialisés par un mutex (chargement de configuration, requêtes HTTP).
+class SymbolTable {
+public:
+  SymbolTable();
+
+  // Symbole du texte, ajouté s'il est nouveau (SYMBOL_UNKNOWN si la table est pleine)
+  Symbol intern(const char* text);
+  Symbol intern(const String& text) { return intern(text.c_str()); }
+
+  // Symbole d'un texte déjà interné, sans ajout
+  Symbol find(const char* text) const;
+  Symbol find(const String& text) const { return find(text.c_str()); }
+
+  // Texte du symbole ("" pour un symbole inconnu)
+  const char* text(Symbol symbol) const;
+
+  // Empreinte FNV-1a du texte : contrairement au numéro du symbole, qui suit
+  // l'ordre d'internement, elle reste la même d'un démarrage à l'autre
+  static uint32_t fingerprint(const char* text);
+  uint32_t fingerprint(Symbol symbol) const { return fingerprint(text(symbol)); }
+
+  size_t count() const { return _count.load(std::memory_order_acquire); }
+  size_t bytes() const { return _bytes; }
+
+private:
+  static const size_t BLOCK_SYMBOLS = 128;
+  static const size_t MAX_BLOCKS = 64;
+  static const size_t TEXT_BLOCK_SIZE = 1024;
+
+  Symbol lookup(const char* text, size_t length, uint32_t hash, size_t& position) const;
+  void grow();
+
+  const char** _blocks[MAX_BLOCKS];   // Texte de chaque symbole, par blocs de BLOCK_SYMBOLS
+  std::atomic<size_t> _count;
+  char* _text;                        // Bloc de texte en cours de remplissage
+  size_t _textUsed;
+  size_t _bytes;
+  std::vector<Symbol> _index;         // Adressage ouvert, SYMBOL_UNKNOWN = case vide
+  mutable std::mutex _mutex;
+};
+
+extern SymbolTable symbols;
+
+#endif
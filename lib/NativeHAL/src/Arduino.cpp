@@ -0,0 +1,108 @@
+#include "Arduino.h"
+#include "WiFi.h"
+#include "esp_rom_crc.h"
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <stdio.h>
+#include <thread>
+
+HardwareSerial Serial;
+EspClass ESP;
+WiFiClass WiFi;
+
+namespace {
+
+std::mutex serialMutex;
+
+// Référence fixée au premier appel, y compris depuis un constructeur global
+std::chrono::steady_clock::time_point bootTime() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return start;
+}
+
+}
+
+// Compteurs 32 bits comme sur ESP32 : mêmes débordements
+unsigned long millis() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+}
+
+unsigned long micros() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime();
+  return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+uint32_t EspClass::getCycleCount() {
+  auto elapsed = std::chrono::steady_clock::now() - bootTime();
+  uint64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return (uint32_t)(nanos * getCpuFreqMHz() / 1000);
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  const long dividend = out_max - out_min;
+  const long divisor = in_max - in_min;
+  const long delta = x - in_min;
+  if (divisor == 0) return -1;
+  return (delta * dividend + (divisor / 2)) / divisor + out_min;
+}
+
+long random(long howbig) {
+  if (howbig <= 0) return 0;
+  return esp_random() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if (howsmall >= howbig) return howsmall;
+  return random(howbig - howsmall) + howsmall;
+}
+
+// Pas de capteur sur l'hôte : valeur typique d'un ESP32 au repos
+float temperatureRead() {
+  return 45.0f;
+}
+
+uint32_t esp_random() {
+  thread_local std::mt19937 generator(std::random_device{}());
+  return generator();
+}
+
+esp_reset_reason_t esp_reset_reason() {
+  return ESP_RST_POWERON;
+}
+
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len) {
+  crc = ~crc;
+  while (len--) {
+    crc ^= *buf++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  std::lock_guard<std::mutex> lock(serialMutex);
+  size_t written = fwrite(buffer, 1, size, stdout);
+  fflush(stdout);
+  return written;
+}
+
+void HardwareSerial::flush() {
+  std::lock_guard<std::mutex> lock(serialMutex);
+  fflush(stdout);
+}
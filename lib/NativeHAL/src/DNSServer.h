@@ -0,0 +1,16 @@
+#ifndef NATIVE_DNS_SERVER_H
+#define NATIVE_DNS_SERVER_H
+
+#include <stdint.h>
+#include "WString.h"
+#include "IPAddress.h"
+
+// Portail captif inactif sur l'hôte (le port 53 demande des privilèges)
+class DNSServer {
+public:
+  bool start(uint16_t port, const String& domainName, const IPAddress& resolvedIP) { return true; }
+  void stop() {}
+  void processNextRequest() {}
+};
+
+#endif
@@ -0,0 +1,23 @@
+#ifndef NATIVE_ESP_H
+#define NATIVE_ESP_H
+
+#include <stdint.h>
+
+// Valeurs fixes d'un ESP32-WROOM (4 Mo de flash, 240 MHz), le tas de l'hôte
+// n'ayant pas de limite comparable
+class EspClass {
+public:
+  uint32_t getHeapSize() { return 327680; }
+  uint32_t getFreeHeap() { return 245760; }
+  uint32_t getMinFreeHeap() { return 200704; }
+  uint32_t getMaxAllocHeap() { return 114676; }
+  uint8_t getCpuFreqMHz() { return 240; }
+  uint32_t getFlashChipSize() { return 4 * 1024 * 1024; }
+  const char* getSdkVersion() { return "native"; }
+  // Compteur de cycles 32 bits simulé à getCpuFreqMHz() à partir de l'horloge de l'hôte
+  uint32_t getCycleCount();
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,103 @@
+#include "esp_partition.h"
+#include "esp_spi_flash.h"
+#include "SimHAL.h"
+#include <fcntl.h>
+#include <mutex>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// Partitions de données de partitions.csv
+esp_partition_t partitions[] = {
+  { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x02, 0x9000,   0x5000,  "nvs",      false },
+  { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x00, 0xe000,   0x2000,  "otadata",  false },
+  { ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x290000, 0xE0000, "spiffs", false },
+  { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x40, 0x370000, 0x80000, "tslog",    false },
+  { ESP_PARTITION_TYPE_DATA, (esp_partition_subtype_t)0x03, 0x3F0000, 0x10000, "coredump", false },
+};
+
+const size_t PARTITION_COUNT = sizeof(partitions) / sizeof(partitions[0]);
+int partitionFds[PARTITION_COUNT] = { -1, -1, -1, -1, -1 };
+std::mutex partitionMutex;
+
+int indexOf(const esp_partition_t* partition) {
+  for (size_t i = 0; i < PARTITION_COUNT; i++) {
+    if (partition == &partitions[i]) return (int)i;
+  }
+  return -1;
+}
+
+// Fichier de la partition, créé effacé (0xFF) à la première ouverture
+int openPartition(size_t index) {
+  if (partitionFds[index] >= 0) return partitionFds[index];
+
+  String dir = Sim::directory();
+  if (!Sim::makeDirectories(dir)) return -1;
+  String path = dir + "/" + partitions[index].label + ".bin";
+  int fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return -1;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && (size_t)info.st_size < partitions[index].size) {
+    std::vector<uint8_t> erased(partitions[index].size - info.st_size, 0xFF);
+    if (pwrite(fd, erased.data(), erased.size(), info.st_size) != (ssize_t)erased.size()) {
+      close(fd);
+      return -1;
+    }
+  }
+  partitionFds[index] = fd;
+  return fd;
+}
+
+int checkedFd(const esp_partition_t* partition, size_t offset, size_t size) {
+  int index = indexOf(partition);
+  if (index < 0 || offset > partition->size || size > partition->size - offset) return -1;
+  return openPartition(index);
+}
+
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label) {
+  std::lock_guard<std::mutex> lock(partitionMutex);
+  for (size_t i = 0; i < PARTITION_COUNT; i++) {
+    const esp_partition_t& partition = partitions[i];
+    if (partition.type != type) continue;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && partition.subtype != subtype) continue;
+    if (label && strcmp(label, partition.label) != 0) continue;
+    return openPartition(i) >= 0 ? &partition : nullptr;
+  }
+  return nullptr;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t src_offset, void* dst, size_t size) {
+  std::lock_guard<std::mutex> lock(partitionMutex);
+  int fd = checkedFd(partition, src_offset, size);
+  if (fd < 0) return ESP_ERR_INVALID_SIZE;
+  return pread(fd, dst, size, src_offset) == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+// Comme la NOR : l'écriture ne fait que passer des bits de 1 à 0
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t dst_offset, const void* src, size_t size) {
+  std::lock_guard<std::mutex> lock(partitionMutex);
+  int fd = checkedFd(partition, dst_offset, size);
+  if (fd < 0) return ESP_ERR_INVALID_SIZE;
+
+  std::vector<uint8_t> flash(size);
+  if (pread(fd, flash.data(), size, dst_offset) != (ssize_t)size) return ESP_FAIL;
+  const uint8_t* bytes = (const uint8_t*)src;
+  for (size_t i = 0; i < size; i++) flash[i] &= bytes[i];
+  return pwrite(fd, flash.data(), size, dst_offset) == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  if (offset % SPI_FLASH_SEC_SIZE || size % SPI_FLASH_SEC_SIZE) return ESP_ERR_INVALID_ARG;
+  std::lock_guard<std::mutex> lock(partitionMutex);
+  int fd = checkedFd(partition, offset, size);
+  if (fd < 0) return ESP_ERR_INVALID_SIZE;
+
+  std::vector<uint8_t> erased(size, 0xFF);
+  return pwrite(fd, erased.data(), size, offset) == (ssize_t)size ? ESP_OK : ESP_FAIL;
+}
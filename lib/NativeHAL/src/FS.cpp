@@ -0,0 +1,218 @@
+#include "FS.h"
+#include "SPIFFS.h"
+#include "SimHAL.h"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs {
+
+File::File(FILE* fp, const String& path) : _handle(std::make_shared<Handle>()) {
+  _handle->fp = fp;
+  _handle->path = path;
+}
+
+size_t File::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t File::write(const uint8_t* buffer, size_t size) {
+  if (!*this) return 0;
+  return fwrite(buffer, 1, size, _handle->fp);
+}
+
+int File::available() {
+  if (!*this) return 0;
+  return (int)(size() - position());
+}
+
+int File::read() {
+  if (!*this) return -1;
+  return fgetc(_handle->fp);
+}
+
+int File::peek() {
+  if (!*this) return -1;
+  int c = fgetc(_handle->fp);
+  if (c != EOF) ungetc(c, _handle->fp);
+  return c;
+}
+
+void File::flush() {
+  if (*this) fflush(_handle->fp);
+}
+
+size_t File::read(uint8_t* buffer, size_t size) {
+  if (!*this) return 0;
+  return fread(buffer, 1, size, _handle->fp);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!*this) return false;
+  int whence = (mode == SeekCur) ? SEEK_CUR : (mode == SeekEnd) ? SEEK_END : SEEK_SET;
+  return fseek(_handle->fp, pos, whence) == 0;
+}
+
+size_t File::position() const {
+  if (!*this) return 0;
+  long pos = ftell(_handle->fp);
+  return pos < 0 ? 0 : (size_t)pos;
+}
+
+size_t File::size() const {
+  if (!*this) return 0;
+  fflush(_handle->fp);
+  struct stat info;
+  if (fstat(fileno(_handle->fp), &info) != 0) return 0;
+  return (size_t)info.st_size;
+}
+
+void File::close() {
+  if (_handle && _handle->fp) {
+    fclose(_handle->fp);
+    _handle->fp = nullptr;
+  }
+  _handle.reset();
+}
+
+File::operator bool() const {
+  return _handle && _handle->fp;
+}
+
+const char* File::path() const {
+  return _handle ? _handle->path.c_str() : nullptr;
+}
+
+// Comme Arduino-ESP32 2.x : le nom sans le répertoire
+const char* File::name() const {
+  if (!_handle) return nullptr;
+  const char* path = _handle->path.c_str();
+  const char* slash = strrchr(path, '/');
+  return slash ? slash + 1 : path;
+}
+
+// Chaîne vide tant que le système de fichiers n'est pas monté : fopen échoue
+String FS::hostPath(const char* path) const {
+  if (_root.isEmpty()) return String();
+  String result = _root;
+  if (path[0] != '/') result += '/';
+  result += path;
+  return result;
+}
+
+File FS::open(const char* path, const char* mode, bool create) {
+  String host = hostPath(path);
+  if (mode[0] != 'r') {
+    Sim::makeDirectories(host.substring(0, host.lastIndexOf('/')));
+  }
+
+  String hostMode = mode;
+  hostMode += 'b';
+  FILE* fp = fopen(host.c_str(), hostMode.c_str());
+  if (!fp) return File();
+  return File(fp, path);
+}
+
+bool FS::exists(const char* path) {
+  struct stat info;
+  return stat(hostPath(path).c_str(), &info) == 0;
+}
+
+bool FS::remove(const char* path) {
+  return ::remove(hostPath(path).c_str()) == 0;
+}
+
+bool FS::rename(const char* pathFrom, const char* pathTo) {
+  return ::rename(hostPath(pathFrom).c_str(), hostPath(pathTo).c_str()) == 0;
+}
+
+namespace {
+
+const size_t SPIFFS_PARTITION_SIZE = 0xE0000; // partitions.csv
+
+bool copyFile(const String& from, const String& to) {
+  FILE* in = fopen(from.c_str(), "rb");
+  if (!in) return false;
+  FILE* out = fopen(to.c_str(), "wb");
+  if (!out) {
+    fclose(in);
+    return false;
+  }
+  char buffer[4096];
+  size_t n;
+  bool ok = true;
+  while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0) {
+    if (fwrite(buffer, 1, n, out) != n) {
+      ok = false;
+      break;
+    }
+  }
+  fclose(in);
+  fclose(out);
+  return ok;
+}
+
+}
+
+// Recopie data/ comme « pio run -t uploadfs », sans écraser un fichier modifié
+// depuis par le programme (configuration enregistrée par l'API)
+bool SPIFFSFS::begin(bool formatOnFail, const char* basePath, uint8_t maxOpenFiles, const char* partitionLabel) {
+  _root = Sim::directory() + "/spiffs";
+  if (!Sim::makeDirectories(_root)) {
+    fprintf(stderr, "SPIFFS: cannot create %s (%d)\n", _root.c_str(), errno);
+    return false;
+  }
+
+  String dataDir = Sim::dataDirectory();
+  DIR* dir = opendir(dataDir.c_str());
+  if (!dir) return true;
+
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    String source = dataDir + "/" + entry->d_name;
+    String target = _root + "/" + entry->d_name;
+    struct stat sourceInfo;
+    struct stat targetInfo;
+    if (stat(source.c_str(), &sourceInfo) != 0 || !S_ISREG(sourceInfo.st_mode)) continue;
+    if (stat(target.c_str(), &targetInfo) == 0 && targetInfo.st_mtime >= sourceInfo.st_mtime) continue;
+    copyFile(source, target);
+  }
+  closedir(dir);
+  return true;
+}
+
+bool SPIFFSFS::format() {
+  DIR* dir = opendir(_root.c_str());
+  if (!dir) return false;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    if (entry->d_name[0] == '.') continue;
+    ::remove((_root + "/" + entry->d_name).c_str());
+  }
+  closedir(dir);
+  return true;
+}
+
+size_t SPIFFSFS::totalBytes() {
+  return SPIFFS_PARTITION_SIZE;
+}
+
+size_t SPIFFSFS::usedBytes() {
+  size_t used = 0;
+  DIR* dir = opendir(_root.c_str());
+  if (!dir) return 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != nullptr) {
+    struct stat info;
+    if (stat((_root + "/" + entry->d_name).c_str(), &info) == 0 && S_ISREG(info.st_mode)) {
+      used += info.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
+
+}
+
+fs::SPIFFSFS SPIFFS;
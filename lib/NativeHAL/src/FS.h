@@ -0,0 +1,71 @@
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <stdio.h>
+#include <memory>
+#include "Stream.h"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+// Fichier de l'hôte ; comme sur ESP32, les copies partagent le même descripteur
+class File : public Stream {
+public:
+  File() {}
+  File(FILE* fp, const String& path);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int peek() override;
+  void flush() override;
+  size_t read(uint8_t* buffer, size_t size);
+  size_t readBytes(char* buffer, size_t length) override { return read((uint8_t*)buffer, length); }
+
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  const char* path() const;
+  const char* name() const;
+
+private:
+  struct Handle {
+    FILE* fp;
+    String path;
+    ~Handle() { if (fp) fclose(fp); }
+  };
+  std::shared_ptr<Handle> _handle;
+};
+
+// Système de fichiers monté sur un répertoire de l'hôte
+class FS {
+public:
+  File open(const char* path, const char* mode = "r", bool create = false);
+  File open(const String& path, const char* mode = "r", bool create = false) { return open(path.c_str(), mode, create); }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+  bool rename(const char* pathFrom, const char* pathTo);
+  bool rename(const String& pathFrom, const String& pathTo) { return rename(pathFrom.c_str(), pathTo.c_str()); }
+
+protected:
+  String hostPath(const char* path) const;
+  String _root;
+};
+
+}
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
+
+#endif
@@ -0,0 +1,203 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/ringbuf.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SimTask {
+  std::mutex mutex;
+  std::condition_variable notified;
+  uint32_t notifyValue = 0;
+  std::string name;
+};
+
+struct SimQueue {
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::condition_variable notFull;
+  std::deque<std::vector<uint8_t>> items;
+  size_t length;
+  size_t itemSize;
+};
+
+struct SimRingbuf {
+  std::mutex mutex;
+  std::condition_variable notEmpty;
+  std::deque<std::vector<uint8_t>> items;
+  std::vector<uint8_t> borrowed; // Élément rendu par xRingbufferReceive
+  size_t capacity;
+  size_t used = 0;
+};
+
+namespace {
+
+thread_local SimTask* currentTask = nullptr;
+
+// Attente bornée en ticks, portMAX_DELAY sans limite
+template <typename Predicate>
+bool waitTicks(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t ticks, Predicate ready) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(ticks), ready);
+}
+
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskCode, const char* name, uint32_t stackDepth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* createdTask,
+                                   BaseType_t coreId) {
+  SimTask* task = new SimTask();
+  task->name = name ? name : "";
+  if (createdTask) *createdTask = task;
+
+  std::thread([task, taskCode, parameters]() {
+    currentTask = task;
+    taskCode(parameters);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char* name, uint32_t stackDepth,
+                       void* parameters, UBaseType_t priority, TaskHandle_t* createdTask) {
+  return xTaskCreatePinnedToCore(taskCode, name, stackDepth, parameters, priority, createdTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  // Un thread ne peut pas en arrêter un autre : seule la suppression de soi est simulée
+  if (task == nullptr || task == currentTask) {
+    for (;;) {
+      std::this_thread::sleep_for(std::chrono::hours(1));
+    }
+  }
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+  }
+}
+
+TickType_t xTaskGetTickCount() {
+  static const auto start = std::chrono::steady_clock::now();
+  return (TickType_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - start).count();
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  // Threads non créés par xTaskCreate (main) : descripteur créé au premier appel
+  if (!currentTask) currentTask = new SimTask();
+  return currentTask;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (!task) return pdFAIL;
+  {
+    std::lock_guard<std::mutex> lock(task->mutex);
+    task->notifyValue++;
+  }
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearCountOnExit, TickType_t ticksToWait) {
+  SimTask* task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->mutex);
+  waitTicks(task->notified, lock, ticksToWait, [task]() { return task->notifyValue > 0; });
+
+  uint32_t value = task->notifyValue;
+  if (value > 0) {
+    task->notifyValue = clearCountOnExit ? 0 : value - 1;
+  }
+  return value;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  SimQueue* queue = new SimQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitTicks(queue->notFull, lock, ticksToWait, [queue]() { return queue->items.size() < queue->length; })) {
+    return pdFALSE;
+  }
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  lock.unlock();
+  queue->notEmpty.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(queue->mutex);
+  if (!waitTicks(queue->notEmpty, lock, ticksToWait, [queue]() { return !queue->items.empty(); })) {
+    return pdFALSE;
+  }
+  std::copy(queue->items.front().begin(), queue->items.front().end(), (uint8_t*)buffer);
+  queue->items.pop_front();
+  lock.unlock();
+  queue->notFull.notify_one();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(queue->mutex);
+  return (UBaseType_t)queue->items.size();
+}
+
+RingbufHandle_t xRingbufferCreate(size_t bufferSize, int type) {
+  SimRingbuf* ringbuf = new SimRingbuf();
+  ringbuf->capacity = bufferSize;
+  return ringbuf;
+}
+
+void vRingbufferDelete(RingbufHandle_t ringbuf) {
+  delete ringbuf;
+}
+
+BaseType_t xRingbufferSend(RingbufHandle_t ringbuf, const void* data, size_t size, TickType_t ticksToWait) {
+  {
+    std::lock_guard<std::mutex> lock(ringbuf->mutex);
+    // Comme le pilote RMT : une trame qui ne tient pas est perdue
+    if (ringbuf->used + size > ringbuf->capacity) return pdFALSE;
+    const uint8_t* bytes = (const uint8_t*)data;
+    ringbuf->items.emplace_back(bytes, bytes + size);
+    ringbuf->used += size;
+  }
+  ringbuf->notEmpty.notify_one();
+  return pdTRUE;
+}
+
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* itemSize, TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(ringbuf->mutex);
+  if (!waitTicks(ringbuf->notEmpty, lock, ticksToWait, [ringbuf]() { return !ringbuf->items.empty(); })) {
+    return nullptr;
+  }
+  ringbuf->borrowed.swap(ringbuf->items.front());
+  ringbuf->items.pop_front();
+  if (itemSize) *itemSize = ringbuf->borrowed.size();
+  return ringbuf->borrowed.data();
+}
+
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item) {
+  std::lock_guard<std::mutex> lock(ringbuf->mutex);
+  ringbuf->used -= ringbuf->borrowed.size();
+  ringbuf->borrowed.clear();
+}
@@ -0,0 +1,20 @@
+#ifndef NATIVE_HTTP_METHOD_H
+#define NATIVE_HTTP_METHOD_H
+
+// Mêmes valeurs que http_parser, utilisé par WebServer sur ESP32
+enum http_method {
+  HTTP_DELETE = 0,
+  HTTP_GET = 1,
+  HTTP_HEAD = 2,
+  HTTP_POST = 3,
+  HTTP_PUT = 4,
+  HTTP_CONNECT = 5,
+  HTTP_OPTIONS = 6,
+  HTTP_TRACE = 7,
+  HTTP_PATCH = 28,
+};
+
+typedef enum http_method HTTPMethod;
+#define HTTP_ANY (HTTPMethod)(255)
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef NATIVE_HARDWARE_SERIAL_H
+#define NATIVE_HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+// Port série simulé : écritures vers stdout, lectures réservées à la console
+// de commandes du simulateur (SimHAL)
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) {}
+  void end() {}
+
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,29 @@
+#include "Arduino.h"
+#include "SimHAL.h"
+#include <signal.h>
+
+#ifdef OPENDOM_BENCH
+// src/Benchmark.cpp (env:native-bench)
+int runBenchmarks(int argc, char** argv);
+#endif
+
+// Point d'entrée de env:native : même séquence que le cœur Arduino-ESP32
+// (setup() puis loop() en boucle), la console du simulateur en parallèle.
+// Les tests (pio test -e native, test/) ont leur propre main()
+#ifndef PIO_UNIT_TESTING
+int main(int argc, char** argv) {
+  // Une socket fermée par le client ne doit pas arrêter le programme
+  signal(SIGPIPE, SIG_IGN);
+
+#ifdef OPENDOM_BENCH
+  return runBenchmarks(argc, argv);
+#endif
+
+  Sim::startConsole();
+  setup();
+  for (;;) {
+    loop();
+  }
+  return 0;
+}
+#endif
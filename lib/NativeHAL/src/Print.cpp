@@ -0,0 +1,35 @@
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <vector>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (!write(*buffer++)) break;
+    n++;
+  }
+  return n;
+}
+
+size_t Print::printf(const char* format, ...) {
+  char local[128];
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(local, sizeof(local), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(args);
+    return 0;
+  }
+  if ((size_t)len < sizeof(local)) {
+    va_end(args);
+    return write((const uint8_t*)local, len);
+  }
+  std::vector<char> buffer(len + 1);
+  vsnprintf(buffer.data(), buffer.size(), format, args);
+  va_end(args);
+  return write((const uint8_t*)buffer.data(), len);
+}
@@ -0,0 +1,24 @@
+#ifndef NATIVE_SPIFFS_H
+#define NATIVE_SPIFFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+// SPIFFS simulé : <OPENDOM_SIM_DIR>/spiffs (.pio/native_sim par défaut),
+// complété au montage par les fichiers de data/ absents ou plus récents
+class SPIFFSFS : public FS {
+public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/spiffs",
+             uint8_t maxOpenFiles = 10, const char* partitionLabel = nullptr);
+  void end() {}
+  bool format();
+  size_t totalBytes();
+  size_t usedBytes();
+};
+
+}
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif
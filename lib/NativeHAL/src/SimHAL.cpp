@@ -0,0 +1,301 @@
+#include "SimHAL.h"
+#include "Arduino.h"
+#include "driver/rmt.h"
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+
+namespace {
+
+const double PI_2 = 6.283185307179586;
+
+struct PinState {
+  std::atomic<uint8_t> mode{INPUT};
+  std::atomic<int> output{-1};
+  std::atomic<int> analog{-1};   // Consigne ADC, -1 : modèle
+  std::atomic<int> digital{-1};  // Consigne numérique, -1 : repos
+};
+
+PinState pins[Sim::PIN_COUNT];
+
+enum class DhtMode : uint8_t { MODEL, FIXED, DISCONNECTED };
+
+struct DhtState {
+  DhtMode mode = DhtMode::MODEL;
+  float temperature = 0;
+  float humidity = 0;
+};
+
+std::mutex dhtMutex;
+DhtState dhts[Sim::PIN_COUNT];
+
+struct RmtChannel {
+  bool installed = false;
+  gpio_num_t gpio = GPIO_NUM_NC;
+  RingbufHandle_t ringbuf = nullptr;
+};
+
+RmtChannel rmtChannels[RMT_CHANNEL_MAX];
+
+bool validPin(int pin) {
+  return pin >= 0 && pin < Sim::PIN_COUNT;
+}
+
+double seconds() {
+  return millis() / 1000.0;
+}
+
+// Variations lentes et déphasées d'une broche à l'autre, plus un bruit de
+// quelques pas, bien en deçà du seuil de stabilité des capteurs (50)
+int analogModel(int pin) {
+  double value = 1200 + 600 * sin(PI_2 * seconds() / 600 + pin);
+  return (int)value + (int)(esp_random() % 7) - 3;
+}
+
+bool dhtReading(int pin, float& temperature, float& humidity) {
+  std::lock_guard<std::mutex> lock(dhtMutex);
+  const DhtState& dht = dhts[pin];
+  switch (dht.mode) {
+    case DhtMode::DISCONNECTED:
+      return false;
+    case DhtMode::FIXED:
+      temperature = dht.temperature;
+      humidity = dht.humidity;
+      return true;
+    case DhtMode::MODEL:
+      break;
+  }
+  temperature = 24 + 3 * sin(PI_2 * seconds() / 900 + pin);
+  humidity = 50 + 10 * sin(PI_2 * seconds() / 1200 + pin);
+  return true;
+}
+
+// Octets DHT11 : humidité (entier, dixièmes), température (entier, bit de
+// signe et dixièmes), somme de contrôle
+void encodeDht(float temperature, float humidity, uint8_t data[5]) {
+  int humidityTenths = (int)lroundf(std::max(0.0f, std::min(humidity, 100.0f)) * 10);
+  data[0] = humidityTenths / 10;
+  data[1] = humidityTenths % 10;
+
+  int temperatureTenths = (int)lroundf(temperature * 10);
+  if (temperatureTenths >= 0) {
+    data[2] = temperatureTenths / 10;
+    data[3] = temperatureTenths % 10;
+  } else {
+    // Décodage : -1 - data[2] + dixièmes
+    int magnitude = -temperatureTenths - 10;
+    int integral = magnitude > 0 ? (magnitude + 9) / 10 : 0;
+    data[2] = integral;
+    data[3] = 0x80 | (10 * integral - magnitude);
+  }
+  data[4] = data[0] + data[1] + data[2] + data[3];
+}
+
+void sendDhtFrame(RmtChannel& channel) {
+  int pin = channel.gpio;
+  float temperature;
+  float humidity;
+  if (!validPin(pin) || !channel.ringbuf || !dhtReading(pin, temperature, humidity)) return;
+
+  uint8_t data[5];
+  encodeDht(temperature, humidity, data);
+
+  // Réponse, 40 bits puis niveau bas de fin, en µs (clk_div = 80)
+  rmt_item32_t items[42] = {};
+  items[0].level0 = 0; items[0].duration0 = 80;
+  items[0].level1 = 1; items[0].duration1 = 80;
+  for (int i = 0; i < 40; i++) {
+    bool one = data[i / 8] & (0x80 >> (i % 8));
+    items[i + 1].level0 = 0; items[i + 1].duration0 = 50;
+    items[i + 1].level1 = 1; items[i + 1].duration1 = one ? 70 : 26;
+  }
+  items[41].level0 = 0; items[41].duration0 = 50;
+  items[41].level1 = 0; items[41].duration1 = 0;
+  xRingbufferSend(channel.ringbuf, items, sizeof(items), 0);
+}
+
+}
+
+namespace Sim {
+
+void setAnalog(int pin, int value) {
+  if (validPin(pin)) pins[pin].analog = value < 0 ? -1 : std::min(value, 4095);
+}
+
+void setDigital(int pin, int level) {
+  if (validPin(pin)) pins[pin].digital = level < 0 ? -1 : (level ? HIGH : LOW);
+}
+
+void setDht(int pin, float temperature, float humidity) {
+  if (!validPin(pin)) return;
+  std::lock_guard<std::mutex> lock(dhtMutex);
+  dhts[pin].mode = DhtMode::FIXED;
+  dhts[pin].temperature = temperature;
+  dhts[pin].humidity = humidity;
+}
+
+void disconnectDht(int pin) {
+  if (!validPin(pin)) return;
+  std::lock_guard<std::mutex> lock(dhtMutex);
+  dhts[pin].mode = DhtMode::DISCONNECTED;
+}
+
+void resetDht(int pin) {
+  if (!validPin(pin)) return;
+  std::lock_guard<std::mutex> lock(dhtMutex);
+  dhts[pin].mode = DhtMode::MODEL;
+}
+
+int outputLevel(int pin) {
+  return validPin(pin) ? pins[pin].output.load() : -1;
+}
+
+bool runCommand(const String& line) {
+  char command[16];
+  char arg[16];
+  int pin;
+  float temperature;
+  float humidity;
+
+  if (sscanf(line.c_str(), "%15s", command) != 1) return false;
+  String name = command;
+
+  if (name == "analog" && sscanf(line.c_str(), "%*s %d %15s", &pin, arg) == 2 && validPin(pin)) {
+    setAnalog(pin, String(arg) == "auto" ? -1 : atoi(arg));
+    return true;
+  }
+  if (name == "digital" && sscanf(line.c_str(), "%*s %d %15s", &pin, arg) == 2 && validPin(pin)) {
+    setDigital(pin, String(arg) == "auto" ? -1 : atoi(arg));
+    return true;
+  }
+  if (name == "dht" && sscanf(line.c_str(), "%*s %d %f %f", &pin, &temperature, &humidity) == 3 && validPin(pin)) {
+    setDht(pin, temperature, humidity);
+    return true;
+  }
+  if (name == "dht" && sscanf(line.c_str(), "%*s %d %15s", &pin, arg) == 2 && validPin(pin)) {
+    String mode = arg;
+    if (mode == "off") disconnectDht(pin);
+    else if (mode == "auto") resetDht(pin);
+    else return false;
+    return true;
+  }
+  if (name == "pins") {
+    for (int i = 0; i < PIN_COUNT; i++) {
+      if (pins[i].output >= 0) Serial.printf("[sim] pin %d = %d\r\n", i, pins[i].output.load());
+    }
+    return true;
+  }
+  return false;
+}
+
+void startConsole() {
+  std::thread([]() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+      if (line.empty()) continue;
+      if (!runCommand(String(line.c_str()))) {
+        Serial.printf("[sim] commande inconnue : %s\r\n", line.c_str());
+      }
+    }
+  }).detach();
+}
+
+String directory() {
+  const char* dir = getenv("OPENDOM_SIM_DIR");
+  return String(dir && *dir ? dir : ".pio/native_sim");
+}
+
+String dataDirectory() {
+  const char* dir = getenv("OPENDOM_DATA_DIR");
+  return String(dir && *dir ? dir : "data");
+}
+
+bool makeDirectories(const String& path) {
+  for (int pos = path.indexOf('/', 1); ; pos = path.indexOf('/', pos + 1)) {
+    String prefix = (pos < 0) ? path : path.substring(0, pos);
+    if (!prefix.isEmpty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) return false;
+    if (pos < 0) return true;
+  }
+}
+
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (validPin(pin)) pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (validPin(pin)) pins[pin].output = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (!validPin(pin)) return LOW;
+  PinState& state = pins[pin];
+  if (state.digital >= 0) return state.digital;
+  if (state.mode == OUTPUT) return state.output > 0 ? HIGH : LOW;
+  return (state.mode & PULLUP) ? HIGH : LOW;
+}
+
+uint16_t analogRead(uint8_t pin) {
+  if (!validPin(pin)) return 0;
+  int value = pins[pin].analog;
+  if (value < 0) value = analogModel(pin);
+  return (uint16_t)std::max(0, std::min(value, 4095));
+}
+
+void analogWrite(uint8_t pin, int value) {
+  if (validPin(pin)) pins[pin].output = value;
+}
+
+esp_err_t rmt_config(const rmt_config_t* config) {
+  if (!config || config->channel >= RMT_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+  rmtChannels[config->channel].gpio = config->gpio_num;
+  return ESP_OK;
+}
+
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags) {
+  if (channel >= RMT_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+  RmtChannel& rmt = rmtChannels[channel];
+  if (rmt.installed) return ESP_ERR_INVALID_STATE;
+  rmt.ringbuf = xRingbufferCreate(rx_buf_size, RINGBUF_TYPE_NOSPLIT);
+  rmt.installed = true;
+  return ESP_OK;
+}
+
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel) {
+  if (channel >= RMT_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+  RmtChannel& rmt = rmtChannels[channel];
+  if (!rmt.installed) return ESP_ERR_INVALID_STATE;
+  vRingbufferDelete(rmt.ringbuf);
+  rmt.ringbuf = nullptr;
+  rmt.installed = false;
+  return ESP_OK;
+}
+
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* buf_handle) {
+  if (channel >= RMT_CHANNEL_MAX || !buf_handle || !rmtChannels[channel].installed) return ESP_ERR_INVALID_ARG;
+  *buf_handle = rmtChannels[channel].ringbuf;
+  return ESP_OK;
+}
+
+esp_err_t rmt_set_gpio(rmt_channel_t channel, rmt_mode_t mode, gpio_num_t gpio_num, bool invert_signal) {
+  if (channel >= RMT_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+  rmtChannels[channel].gpio = gpio_num;
+  return ESP_OK;
+}
+
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool rx_idx_rst) {
+  if (channel >= RMT_CHANNEL_MAX || !rmtChannels[channel].installed) return ESP_ERR_INVALID_STATE;
+  sendDhtFrame(rmtChannels[channel]);
+  return ESP_OK;
+}
+
+esp_err_t rmt_rx_stop(rmt_channel_t channel) {
+  if (channel >= RMT_CHANNEL_MAX) return ESP_ERR_INVALID_ARG;
+  return ESP_OK;
+}
@@ -0,0 +1,39 @@
+#ifndef NATIVE_SIM_HAL_H
+#define NATIVE_SIM_HAL_H
+
+#include "WString.h"
+
+// Matériel simulé de env:native. Sans consigne, les entrées suivent des
+// modèles lents (ADC ~1200 ± 600 sur 10 min, DHT 24 °C / 50 %), les entrées
+// numériques restent au repos (bas, haut avec INPUT_PULLUP) et les sorties
+// relisent le dernier niveau écrit.
+//
+// Les consignes se donnent depuis le code ou sur l'entrée standard du
+// programme, une commande par ligne :
+//   analog <pin> <0-4095|auto>
+//   digital <pin> <0|1|auto>
+//   dht <pin> <température> <humidité>   (dht <pin> off : capteur débranché)
+//   pins                                 (niveaux des sorties)
+namespace Sim {
+
+const int PIN_COUNT = 40;
+
+void setAnalog(int pin, int value);    // -1 : retour au modèle
+void setDigital(int pin, int level);   // -1 : niveau de repos
+void setDht(int pin, float temperature, float humidity);
+void disconnectDht(int pin);
+void resetDht(int pin);                // Retour au modèle
+int outputLevel(int pin);              // digitalWrite / analogWrite, -1 si jamais écrite
+
+bool runCommand(const String& line);
+void startConsole();
+
+// Répertoire des fichiers simulés (OPENDOM_SIM_DIR, .pio/native_sim par
+// défaut) et source de l'image SPIFFS (OPENDOM_DATA_DIR, data par défaut)
+String directory();
+String dataDirectory();
+bool makeDirectories(const String& path);
+
+}
+
+#endif
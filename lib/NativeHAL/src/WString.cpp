@@ -0,0 +1,165 @@
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+std::string formatInteger(unsigned long long value, bool negative, unsigned char base) {
+  if (base < 2 || base > 36) base = 10;
+  char digits[66];
+  int pos = sizeof(digits);
+  digits[--pos] = '\0';
+  do {
+    unsigned digit = (unsigned)(value % base);
+    digits[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value);
+  if (negative) digits[--pos] = '-';
+  return std::string(digits + pos);
+}
+
+std::string formatSigned(long long value) {
+  if (value < 0) return formatInteger(0ULL - (unsigned long long)value, true, 10);
+  return formatInteger((unsigned long long)value, false, 10);
+}
+
+std::string formatFloat(double value, unsigned int decimalPlaces) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", (int)decimalPlaces, value);
+  return std::string(buffer);
+}
+
+}
+
+// Comme Arduino : le signe n'est conservé qu'en base 10
+String::String(unsigned char value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base)
+  : _buffer(base == 10 ? formatSigned(value) : formatInteger((unsigned int)value, false, base)) {}
+String::String(unsigned int value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base)
+  : _buffer(base == 10 ? formatSigned(value) : formatInteger((unsigned long)value, false, base)) {}
+String::String(unsigned long value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(long long value, unsigned char base)
+  : _buffer(base == 10 ? formatSigned(value) : formatInteger((unsigned long long)value, false, base)) {}
+String::String(unsigned long long value, unsigned char base) : _buffer(formatInteger(value, false, base)) {}
+String::String(float value, unsigned int decimalPlaces) : _buffer(formatFloat(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces) : _buffer(formatFloat(value, decimalPlaces)) {}
+
+bool String::equalsIgnoreCase(const String& s) const {
+  if (length() != s.length()) return false;
+  for (unsigned int i = 0; i < length(); i++) {
+    if (tolower((unsigned char)_buffer[i]) != tolower((unsigned char)s._buffer[i])) return false;
+  }
+  return true;
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+  if (offset > length() || prefix.length() > length() - offset) return false;
+  return _buffer.compare(offset, prefix.length(), prefix._buffer) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  if (suffix.length() > length()) return false;
+  return _buffer.compare(length() - suffix.length(), suffix.length(), suffix._buffer) == 0;
+}
+
+char& String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= length()) {
+    dummy = 0;
+    return dummy;
+  }
+  return _buffer[index];
+}
+
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+  if (!bufsize || !buf) return;
+  if (index >= length()) {
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = length() - index;
+  if (n > bufsize - 1) n = bufsize - 1;
+  memcpy(buf, _buffer.data() + index, n);
+  buf[n] = 0;
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  size_t pos = _buffer.find(ch, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  if (fromIndex >= length()) return -1;
+  size_t pos = _buffer.find(str._buffer, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const {
+  if (isEmpty()) return -1;
+  size_t pos = _buffer.rfind(ch, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(const String& str, unsigned int fromIndex) const {
+  if (str.length() > length()) return -1;
+  size_t pos = _buffer.rfind(str._buffer, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    unsigned int temp = endIndex;
+    endIndex = beginIndex;
+    beginIndex = temp;
+  }
+  if (beginIndex >= length()) return String();
+  if (endIndex > length()) endIndex = length();
+  return String(_buffer.data() + beginIndex, endIndex - beginIndex);
+}
+
+void String::replace(char find, char replace) {
+  for (size_t i = 0; i < _buffer.size(); i++) {
+    if (_buffer[i] == find) _buffer[i] = replace;
+  }
+}
+
+void String::replace(const String& find, const String& replace) {
+  if (find.isEmpty()) return;
+  size_t pos = 0;
+  while ((pos = _buffer.find(find._buffer, pos)) != std::string::npos) {
+    _buffer.replace(pos, find.length(), replace._buffer);
+    pos += replace.length();
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= length()) return;
+  _buffer.erase(index, count);
+}
+
+void String::toLowerCase() {
+  for (char& c : _buffer) c = (char)tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char& c : _buffer) c = (char)toupper((unsigned char)c);
+}
+
+void String::trim() {
+  size_t first = 0;
+  while (first < _buffer.size() && isspace((unsigned char)_buffer[first])) first++;
+  size_t last = _buffer.size();
+  while (last > first && isspace((unsigned char)_buffer[last - 1])) last--;
+  _buffer = _buffer.substr(first, last - first);
+}
+
+long String::toInt() const {
+  return atol(c_str());
+}
+
+double String::toDouble() const {
+  return atof(c_str());
+}
@@ -0,0 +1,137 @@
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+// String d'Arduino-ESP32, sur std::string : mêmes méthodes et mêmes
+// conversions numériques, sans l'optimisation des chaînes courtes
+class String {
+public:
+  String() {}
+  String(const char* cstr) : _buffer(cstr ? cstr : "") {}
+  String(const char* cstr, unsigned int length) : _buffer(cstr ? cstr : "", cstr ? length : 0) {}
+  String(const String& str) = default;
+  String(String&& str) = default;
+  explicit String(char c) : _buffer(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+
+  String& operator=(const String& rhs) = default;
+  String& operator=(String&& rhs) = default;
+  String& operator=(const char* cstr) { _buffer = cstr ? cstr : ""; return *this; }
+
+  bool reserve(unsigned int size) { _buffer.reserve(size); return true; }
+  unsigned int length() const { return (unsigned int)_buffer.size(); }
+  bool isEmpty() const { return _buffer.empty(); }
+  const char* c_str() const { return _buffer.c_str(); }
+  char* begin() { return &_buffer[0]; }
+  char* end() { return &_buffer[0] + _buffer.size(); }
+  const char* begin() const { return c_str(); }
+  const char* end() const { return c_str() + _buffer.size(); }
+
+  bool concat(const String& str) { _buffer += str._buffer; return true; }
+  bool concat(const char* cstr) { if (!cstr) return false; _buffer += cstr; return true; }
+  bool concat(const char* cstr, unsigned int length) { if (!cstr) return false; _buffer.append(cstr, length); return true; }
+  bool concat(char c) { _buffer += c; return true; }
+  bool concat(unsigned char value) { return concat(String(value)); }
+  bool concat(int value) { return concat(String(value)); }
+  bool concat(unsigned int value) { return concat(String(value)); }
+  bool concat(long value) { return concat(String(value)); }
+  bool concat(unsigned long value) { return concat(String(value)); }
+  bool concat(long long value) { return concat(String(value)); }
+  bool concat(unsigned long long value) { return concat(String(value)); }
+  bool concat(float value) { return concat(String(value)); }
+  bool concat(double value) { return concat(String(value)); }
+
+  template <typename T>
+  String& operator+=(const T& rhs) { concat(rhs); return *this; }
+
+  int compareTo(const String& s) const { return _buffer.compare(s._buffer); }
+  bool equals(const String& s) const { return _buffer == s._buffer; }
+  bool equals(const char* cstr) const { return _buffer == (cstr ? cstr : ""); }
+  bool equalsIgnoreCase(const String& s) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String& rhs) const { return compareTo(rhs) > 0; }
+  bool operator<=(const String& rhs) const { return compareTo(rhs) <= 0; }
+  bool operator>=(const String& rhs) const { return compareTo(rhs) >= 0; }
+  bool startsWith(const String& prefix) const { return startsWith(prefix, 0); }
+  bool startsWith(const String& prefix, unsigned int offset) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(unsigned int index) const { return index < length() ? _buffer[index] : 0; }
+  void setCharAt(unsigned int index, char c) { if (index < length()) _buffer[index] = c; }
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+  void getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char* buf, unsigned int bufsize, unsigned int index = 0) const {
+    getBytes((unsigned char*)buf, bufsize, index);
+  }
+
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char ch) const { return lastIndexOf(ch, length()); }
+  int lastIndexOf(char ch, unsigned int fromIndex) const;
+  int lastIndexOf(const String& str) const { return lastIndexOf(str, length()); }
+  int lastIndexOf(const String& str, unsigned int fromIndex) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String& find, const String& replace);
+  void remove(unsigned int index) { remove(index, (unsigned int)-1); }
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const { return (float)toDouble(); }
+  double toDouble() const;
+
+private:
+  std::string _buffer;
+};
+
+// Type des concaténations, attendu par ArduinoJson (ARDUINOJSON_ENABLE_ARDUINO_STRING)
+class StringSumHelper : public String {
+public:
+  using String::String;
+  StringSumHelper(const String& s) : String(s) {}
+};
+
+template <typename T>
+StringSumHelper operator+(const String& lhs, const T& rhs) {
+  StringSumHelper result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+inline StringSumHelper operator+(const char* lhs, const String& rhs) {
+  StringSumHelper result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+inline StringSumHelper operator+(char lhs, const String& rhs) {
+  StringSumHelper result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+inline bool operator==(const char* lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char* lhs, const String& rhs) { return !rhs.equals(lhs); }
+
+#endif
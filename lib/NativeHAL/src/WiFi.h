@@ -0,0 +1,25 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <stdint.h>
+#include "IPAddress.h"
+
+// Pas de radio sur l'hôte : le point d'accès est simulé, le serveur HTTP
+// écoute sur toutes les interfaces locales
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+
+class WiFiClass {
+public:
+  bool mode(wifi_mode_t mode) { _mode = mode; return true; }
+  bool softAP(const char* ssid, const char* passphrase = nullptr) { return true; }
+  IPAddress softAPIP() { return IPAddress(127, 0, 0, 1); }
+  uint8_t softAPgetStationNum() { return 0; }
+  int8_t RSSI() { return 0; }
+
+private:
+  wifi_mode_t _mode = WIFI_OFF;
+};
+
+extern WiFiClass WiFi;
+
+#endif
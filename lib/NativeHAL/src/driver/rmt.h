@@ -0,0 +1,70 @@
+#ifndef NATIVE_DRIVER_RMT_H
+#define NATIVE_DRIVER_RMT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "freertos/ringbuf.h"
+
+// Réception RMT simulée : rmt_rx_start dépose dans le tampon la trame que
+// renverrait le capteur DHT branché sur la broche (voir SimHAL.h)
+typedef enum {
+  RMT_CHANNEL_0, RMT_CHANNEL_1, RMT_CHANNEL_2, RMT_CHANNEL_3,
+  RMT_CHANNEL_4, RMT_CHANNEL_5, RMT_CHANNEL_6, RMT_CHANNEL_7,
+  RMT_CHANNEL_MAX
+} rmt_channel_t;
+
+typedef enum { RMT_MODE_TX, RMT_MODE_RX, RMT_MODE_MAX } rmt_mode_t;
+
+typedef struct {
+  union {
+    struct {
+      uint32_t duration0 : 15;
+      uint32_t level0 : 1;
+      uint32_t duration1 : 15;
+      uint32_t level1 : 1;
+    };
+    uint32_t val;
+  };
+} rmt_item32_t;
+
+typedef struct {
+  uint16_t idle_threshold;
+  uint8_t filter_ticks_thresh;
+  bool filter_en;
+} rmt_rx_config_t;
+
+typedef struct {
+  rmt_mode_t rmt_mode;
+  rmt_channel_t channel;
+  gpio_num_t gpio_num;
+  uint8_t clk_div;
+  uint8_t mem_block_num;
+  uint32_t flags;
+  rmt_rx_config_t rx_config;
+} rmt_config_t;
+
+inline rmt_config_t rmtDefaultConfigRx(gpio_num_t gpio, rmt_channel_t channel) {
+  rmt_config_t config = {};
+  config.rmt_mode = RMT_MODE_RX;
+  config.channel = channel;
+  config.gpio_num = gpio;
+  config.clk_div = 80;
+  config.mem_block_num = 1;
+  config.rx_config.idle_threshold = 12000;
+  config.rx_config.filter_ticks_thresh = 100;
+  config.rx_config.filter_en = true;
+  return config;
+}
+
+#define RMT_DEFAULT_CONFIG_RX(gpio, channel_id) rmtDefaultConfigRx((gpio), (channel_id))
+
+esp_err_t rmt_config(const rmt_config_t* config);
+esp_err_t rmt_driver_install(rmt_channel_t channel, size_t rx_buf_size, int intr_alloc_flags);
+esp_err_t rmt_driver_uninstall(rmt_channel_t channel);
+esp_err_t rmt_get_ringbuf_handle(rmt_channel_t channel, RingbufHandle_t* buf_handle);
+esp_err_t rmt_set_gpio(rmt_channel_t channel, rmt_mode_t mode, gpio_num_t gpio_num, bool invert_signal);
+esp_err_t rmt_rx_start(rmt_channel_t channel, bool rx_idx_rst);
+esp_err_t rmt_rx_stop(rmt_channel_t channel);
+
+#endif
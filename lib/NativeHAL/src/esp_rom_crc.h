@@ -0,0 +1,10 @@
+#ifndef NATIVE_ESP_ROM_CRC_H
+#define NATIVE_ESP_ROM_CRC_H
+
+#include <stdint.h>
+
+// CRC32 IEEE 802.3 (polynôme réfléchi 0xEDB88320), même convention que la ROM :
+// crc est la valeur renvoyée par l'appel précédent, 0 au départ
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len);
+
+#endif
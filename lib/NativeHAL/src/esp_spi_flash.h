@@ -0,0 +1,6 @@
+#ifndef NATIVE_ESP_SPI_FLASH_H
+#define NATIVE_ESP_SPI_FLASH_H
+
+#define SPI_FLASH_SEC_SIZE 4096
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef NATIVE_FREERTOS_RINGBUF_H
+#define NATIVE_FREERTOS_RINGBUF_H
+
+#include "FreeRTOS.h"
+
+// Tampon d'éléments (RINGBUF_TYPE_NOSPLIT) : un élément reçu reste valide
+// jusqu'à vRingbufferReturnItem
+struct SimRingbuf;
+typedef SimRingbuf* RingbufHandle_t;
+
+RingbufHandle_t xRingbufferCreate(size_t bufferSize, int type);
+void vRingbufferDelete(RingbufHandle_t ringbuf);
+BaseType_t xRingbufferSend(RingbufHandle_t ringbuf, const void* data, size_t size, TickType_t ticksToWait);
+void* xRingbufferReceive(RingbufHandle_t ringbuf, size_t* itemSize, TickType_t ticksToWait);
+void vRingbufferReturnItem(RingbufHandle_t ringbuf, void* item);
+
+#define RINGBUF_TYPE_NOSPLIT 0
+
+#endif
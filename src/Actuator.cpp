@@ -1,18 +1,29 @@
 #include "Actuator.h"
+#include "Log.h"
+
+BuzzerPattern parseBuzzerPattern(Symbol pattern) {
+  if (pattern == SYM_ALARM) return BuzzerPattern::ALARM;
+  if (pattern == SYM_BEEP) return BuzzerPattern::BEEP;
+  return BuzzerPattern::NONE;
+}
 
 // BaseActuator Implementation
-BaseActuator::BaseActuator(String id, String name, int pin) 
-  : _id(id), _name(name), _pin(pin), _state(false), _lastAction(0) {}
+BaseActuator::BaseActuator(Symbol id, String name, int pin) 
+  : _id(id), _name(name), _pin(pin), _state(false), _lastAction(0), _timer(onTimer, this) {}
+
+void BaseActuator::onTimer(void* context) {
+  static_cast<BaseActuator*>(context)->update();
+}
 
 // RelayActuator Implementation
-RelayActuator::RelayActuator(String id, String name, int pin, bool normallyOpen) 
+RelayActuator::RelayActuator(Symbol id, String name, int pin, bool normallyOpen) 
   : BaseActuator(id, name, pin), _normallyOpen(normallyOpen), _duration(0), 
     _turnOnTime(0), _timedOperation(false) {}
 
 void RelayActuator::init() {
   pinMode(_pin, OUTPUT);
   setState(false);
-  Serial.println("Relay actuator initialized on pin " + String(_pin));
+  LOG_I("Relay actuator initialized on pin %d", _pin);
 }
 
 void RelayActuator::turnOn() {
@@ -20,7 +31,10 @@ void RelayActuator::turnOn() {
   digitalWrite(_pin, _normallyOpen ? HIGH : LOW);
   _lastAction = millis();
   _turnOnTime = millis();
-  Serial.println("Relay " + _id + " turned ON");
+  if (_timedOperation) {
+    scheduler.schedule(_timer, _turnOnTime + _duration);
+  }
+  LOG_D("Relay %s turned ON", symbols.text(_id));
 }
 
 void RelayActuator::turnOff() {
@@ -28,7 +42,8 @@ void RelayActuator::turnOff() {
   digitalWrite(_pin, _normallyOpen ? LOW : HIGH);
   _lastAction = millis();
   _timedOperation = false;
-  Serial.println("Relay " + _id + " turned OFF");
+  scheduler.cancel(_timer);
+  LOG_D("Relay %s turned OFF", symbols.text(_id));
 }
 
 void RelayActuator::toggle() {
@@ -56,6 +71,7 @@ void RelayActuator::setDuration(unsigned long duration) {
   if (duration > 0 && _state) {
     _timedOperation = true;
     _turnOnTime = millis();
+    scheduler.schedule(_timer, _turnOnTime + _duration);
   }
 }
 
@@ -68,21 +84,21 @@ void RelayActuator::update() {
 }
 
 // BuzzerActuator Implementation
-BuzzerActuator::BuzzerActuator(String id, String name, int pin) 
-  : BaseActuator(id, name, pin), _pattern(""), _patternStartTime(0), 
+BuzzerActuator::BuzzerActuator(Symbol id, String name, int pin) 
+  : BaseActuator(id, name, pin), _pattern(BuzzerPattern::NONE), _patternStartTime(0), 
     _patternStep(0), _patternActive(false) {}
 
 void BuzzerActuator::init() {
   pinMode(_pin, OUTPUT);
   setState(false);
-  Serial.println("Buzzer actuator initialized on pin " + String(_pin));
+  LOG_I("Buzzer actuator initialized on pin %d", _pin);
 }
 
 void BuzzerActuator::turnOn() {
   _state = true;
   digitalWrite(_pin, HIGH);
   _lastAction = millis();
-  Serial.println("Buzzer " + _id + " turned ON");
+  LOG_D("Buzzer %s turned ON", symbols.text(_id));
 }
 
 void BuzzerActuator::turnOff() {
@@ -90,7 +106,8 @@ void BuzzerActuator::turnOff() {
   digitalWrite(_pin, LOW);
   _lastAction = millis();
   _patternActive = false;
-  Serial.println("Buzzer " + _id + " turned OFF");
+  scheduler.cancel(_timer);
+  LOG_D("Buzzer %s turned OFF", symbols.text(_id));
 }
 
 void BuzzerActuator::toggle() {
@@ -113,26 +130,32 @@ void BuzzerActuator::setState(bool state) {
   }
 }
 
-void BuzzerActuator::setPattern(String pattern) {
+void BuzzerActuator::setPattern(BuzzerPattern pattern) {
   _pattern = pattern;
-  if (pattern != "") {
+  if (pattern != BuzzerPattern::NONE) {
     _patternActive = true;
     _patternStartTime = millis();
     _patternStep = 0;
+    scheduler.schedule(_timer, _patternStartTime);
   }
 }
 
 void BuzzerActuator::update() {
   if (!_patternActive) return;
   
-  if (_pattern == "alarm") {
-    playAlarmPattern();
-  } else if (_pattern == "beep") {
-    playBeepPattern();
+  unsigned long nextStep = 0;
+  switch (_pattern) {
+    case BuzzerPattern::ALARM: nextStep = playAlarmPattern(); break;
+    case BuzzerPattern::BEEP:  nextStep = playBeepPattern(); break;
+    case BuzzerPattern::NONE:  break;
+  }
+  
+  if (nextStep > 0) {
+    scheduler.scheduleIn(_timer, nextStep);
   }
 }
 
-void BuzzerActuator::playAlarmPattern() {
+unsigned long BuzzerActuator::playAlarmPattern() {
   unsigned long elapsed = millis() - _patternStartTime;
   unsigned long cycleTime = elapsed % 1000; // 1 second cycle
   
@@ -141,15 +164,17 @@ void BuzzerActuator::playAlarmPattern() {
       digitalWrite(_pin, HIGH);
       _state = true;
     }
+    return 500 - cycleTime;
   } else { // OFF for 500ms
     if (_state) {
       digitalWrite(_pin, LOW);
       _state = false;
     }
+    return 1000 - cycleTime;
   }
 }
 
-void BuzzerActuator::playBeepPattern() {
+unsigned long BuzzerActuator::playBeepPattern() {
   unsigned long elapsed = millis() - _patternStartTime;
   unsigned long cycleTime = elapsed % 2000; // 2 second cycle
   
@@ -158,10 +183,12 @@ void BuzzerActuator::playBeepPattern() {
       digitalWrite(_pin, HIGH);
       _state = true;
     }
+    return 100 - cycleTime;
   } else { // OFF for the rest
     if (_state) {
       digitalWrite(_pin, LOW);
       _state = false;
     }
+    return 2000 - cycleTime;
   }
 }
@@ -0,0 +1,53 @@
+#include "AssetBundle.h"
+
+#ifdef EMBEDDED_ASSETS
+
+// Généré dans le répertoire de build par tools/embed_assets.py
+#include "AssetBundle.gen.h"
+
+namespace {
+
+// FNV-1a 32 bits, la graine est choisie au build pour éviter toute collision
+uint32_t hashPath(const char* path) {
+  uint32_t hash = 2166136261u ^ EMBEDDED_ASSET_SEED;
+  while (*path) {
+    hash ^= (uint8_t)*path++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+}
+
+namespace AssetBundle {
+
+const EmbeddedAsset* find(const char* path) {
+  int16_t index = embeddedAssetSlots[hashPath(path) & EMBEDDED_ASSET_MASK];
+  if (index < 0) return nullptr;
+
+  // Un chemin absent peut tomber sur une case occupée : vérifier
+  const EmbeddedAsset* asset = &embeddedAssets[index];
+  return strcmp(asset->path, path) == 0 ? asset : nullptr;
+}
+
+size_t count() {
+  return sizeof(embeddedAssets) / sizeof(embeddedAssets[0]);
+}
+
+}
+
+#else
+
+namespace AssetBundle {
+
+const EmbeddedAsset* find(const char*) {
+  return nullptr;
+}
+
+size_t count() {
+  return 0;
+}
+
+}
+
+#endif
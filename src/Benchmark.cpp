@@ -0,0 +1,354 @@
+#include <Arduino.h>
+
+#ifdef OPENDOM_BENCH
+
+#include <SPIFFS.h>
+#include <ArduinoJson.h>
+#include <atomic>
+#include <chrono>
+#include <stdio.h>
+#include <vector>
+#include "Config.h"
+#include "Sensor.h"
+#include "Actuator.h"
+
+// Banc de mesure du moteur de règles et de l'API (env:native-bench). Pour
+// chaque configuration synthétique (règles x dispositifs), une ligne JSON :
+//   {"bench":"processRules","rules":100,"devices":50,...,"nsPerOp":..,
+//    "allocsPerLoop":..,"bytesPerLoop":..}
+// Une « boucle » est un passage complet (toutes les règles, tous les
+// capteurs ou une réponse /api/sensors) ; une « opération » est une règle
+// évaluée, une lecture traitée ou une réponse.
+
+// main.cpp
+extern Config config;
+extern std::vector<BaseSensor*> sensors;
+extern std::vector<BaseActuator*> actuators;
+extern BaseSensor* sensorSlots[MAX_SENSOR_SLOTS];
+extern std::vector<uint8_t> dirtyRules;
+void reconfigure(Config& next);
+void processRules();
+bool evaluateConditions(const CompiledCondition* program, const ArenaVector<Condition>& conditions);
+void storeReading(BaseSensor* sensor, const SensorReading& reading);
+void writeSensorData(Print& out);
+
+namespace {
+
+// Allocations comptées au niveau de malloc (operator new compris), toutes
+// tâches confondues : le banc n'en démarre aucune
+std::atomic<uint64_t> allocationCount(0);
+std::atomic<uint64_t> allocationBytes(0);
+
+const int RULE_COUNTS[] = { 10, 30, 100, 300, 1000 };
+const int DEVICE_COUNTS[] = { 5, 20, 50, 200 };
+
+const char* const SENSOR_TYPES[] = { "DHT11", "MQ2", "ASC", "LDR", "PIR", "BUTTON" };
+const char* const ACTUATOR_TYPES[] = { "RELAY", "RELAY", "BUZZER" };
+
+// Condition typique de chaque capteur et sa réciproque (désactivation)
+struct Threshold {
+  const char* parameter;
+  const char* activate;
+  const char* deactivate;
+  float value;
+};
+
+const Threshold THRESHOLDS[] = {
+  { "temperature", ">", "<", 28 },
+  { "gas",         ">", "<", 300 },
+  { "current",     ">", "<", 5 },
+  { "light",       "<", ">", 400 },
+  { "motion",      "==", "==", 1 },
+  { "pressed",     "==", "==", 1 },
+};
+
+const size_t SENSOR_TYPE_COUNT = sizeof(SENSOR_TYPES) / sizeof(SENSOR_TYPES[0]);
+const size_t ACTUATOR_TYPE_COUNT = sizeof(ACTUATOR_TYPES) / sizeof(ACTUATOR_TYPES[0]);
+
+struct BenchResult {
+  uint64_t loops;
+  uint64_t nanos;
+  uint64_t allocations;
+  uint64_t bytes;
+};
+
+class CountingPrint : public Print {
+public:
+  size_t count = 0;
+  size_t write(uint8_t c) override { count++; return 1; }
+  size_t write(const uint8_t* buffer, size_t size) override { count += size; return size; }
+};
+
+void generateConfig(JsonDocument& doc, int ruleCount, int deviceCount) {
+  JsonObject system = doc["system"].to<JsonObject>();
+  system["wifi"]["ssid"] = "OPENDOM";
+  system["wifi"]["password"] = "opendom2025";
+  system["auth"]["username"] = "astron";
+  system["auth"]["password"] = "astron";
+  system["auth"]["root_password"] = "astronome";
+  system["captive_portal"] = false;
+
+  // Moitié capteurs, moitié actionneurs, types en alternance
+  int sensorCount = (deviceCount + 1) / 2;
+  int actuatorCount = deviceCount - sensorCount;
+  JsonArray devices = doc["devices"].to<JsonArray>();
+  for (int i = 0; i < sensorCount; i++) {
+    JsonObject device = devices.add<JsonObject>();
+    device["id"] = "sensor_" + String(i);
+    device["name"] = "Capteur " + String(i);
+    device["type"] = "sensor";
+    device["sensor_type"] = SENSOR_TYPES[i % SENSOR_TYPE_COUNT];
+    device["pin"] = i % 40;
+    device["enabled"] = true;
+    device["read_interval"] = 1000;
+  }
+  for (int i = 0; i < actuatorCount; i++) {
+    JsonObject device = devices.add<JsonObject>();
+    device["id"] = "actuator_" + String(i);
+    device["name"] = "Actionneur " + String(i);
+    device["type"] = "actuator";
+    device["actuator_type"] = ACTUATOR_TYPES[i % ACTUATOR_TYPE_COUNT];
+    device["pin"] = i % 40;
+    device["enabled"] = true;
+    device["state"] = false;
+  }
+
+  // 1 à 3 conditions par règle, réparties sur tous les capteurs (y compris
+  // ceux au-delà de MAX_SENSOR_SLOTS) ; actions sur des actionneurs adressables
+  int addressableActuators = min(actuatorCount, MAX_ACTUATOR_SLOTS);
+  JsonArray rules = doc["rules"].to<JsonArray>();
+  for (int i = 0; i < ruleCount; i++) {
+    JsonObject rule = rules.add<JsonObject>();
+    rule["id"] = "rule_" + String(i);
+    rule["name"] = "Règle " + String(i);
+    rule["enabled"] = true;
+    rule["trigger_type"] = "sensor_combination";
+
+    JsonArray conditions = rule["conditions"].to<JsonArray>();
+    JsonArray deactivation = rule["deactivation_conditions"].to<JsonArray>();
+    int conditionCount = 1 + i % 3;
+    for (int c = 0; c < conditionCount; c++) {
+      int sensor = (i * 7 + c * 13) % sensorCount;
+      const Threshold& threshold = THRESHOLDS[sensor % SENSOR_TYPE_COUNT];
+
+      JsonObject condition = conditions.add<JsonObject>();
+      condition["sensor_id"] = "sensor_" + String(sensor);
+      condition["parameter"] = threshold.parameter;
+      condition["operator"] = threshold.activate;
+      condition["value"] = threshold.value;
+      condition["logic"] = (c % 2) ? "OR" : "AND";
+
+      JsonObject inverse = deactivation.add<JsonObject>();
+      inverse["sensor_id"] = "sensor_" + String(sensor);
+      inverse["parameter"] = threshold.parameter;
+      inverse["operator"] = threshold.deactivate;
+      inverse["value"] = (strcmp(threshold.deactivate, "==") == 0) ? 0 : threshold.value;
+      inverse["logic"] = "AND";
+    }
+
+    JsonArray actions = rule["actions"].to<JsonArray>();
+    int actionCount = addressableActuators > 0 ? 1 + i % 2 : 0;
+    for (int a = 0; a < actionCount; a++) {
+      JsonObject action = actions.add<JsonObject>();
+      action["actuator_id"] = "actuator_" + String((i + a * 5) % addressableActuators);
+      action["action"] = "turn_on";
+      if (i % 5 == 0) action["duration"] = 5000;
+    }
+  }
+}
+
+// Lectures alternant d'un côté à l'autre des seuils à chaque boucle
+SensorReading syntheticReading(bool high) {
+  SensorReading reading;
+  reading.temperature = high ? 32 : 22;
+  reading.humidity = 55;
+  reading.gas = high ? 450 : 120;
+  reading.current = high ? 8 : 1;
+  reading.light = high ? 200 : 800;
+  reading.motion = high;
+  reading.pressed = high;
+  reading.isValid = true;
+  reading.timestamp = millis();
+  return reading;
+}
+
+// Répète body par lots doublés jusqu'à minTimeMs ; la première exécution
+// (chauffe : caches, vecteurs dimensionnés) n'est pas comptée
+template <typename Body>
+BenchResult measure(uint32_t minTimeMs, Body body) {
+  body();
+
+  BenchResult result = {0, 0, 0, 0};
+  uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+  uint64_t bytesBefore = allocationBytes.load(std::memory_order_relaxed);
+  auto start = std::chrono::steady_clock::now();
+  uint64_t batch = 1;
+
+  for (;;) {
+    for (uint64_t i = 0; i < batch; i++) body();
+    result.loops += batch;
+    result.nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (result.nanos >= (uint64_t)minTimeMs * 1000000ULL) break;
+    if (batch < 1024) batch *= 2;
+  }
+
+  result.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+  result.bytes = allocationBytes.load(std::memory_order_relaxed) - bytesBefore;
+  return result;
+}
+
+void report(const char* bench, int ruleCount, int deviceCount, size_t opsPerLoop, const BenchResult& result,
+            size_t outputBytes = 0) {
+  double loops = (double)result.loops;
+  double ops = loops * (opsPerLoop ? opsPerLoop : 1);
+  printf("{\"bench\":\"%s\",\"rules\":%d,\"devices\":%d,\"sensors\":%u,\"actuators\":%u,"
+         "\"loops\":%llu,\"opsPerLoop\":%u,\"nsPerOp\":%.1f,\"nsPerLoop\":%.1f,"
+         "\"allocsPerLoop\":%.2f,\"bytesPerLoop\":%.1f",
+         bench, ruleCount, deviceCount, (unsigned)sensors.size(), (unsigned)actuators.size(),
+         (unsigned long long)result.loops, (unsigned)opsPerLoop, result.nanos / ops, result.nanos / loops,
+         result.allocations / loops, result.bytes / loops);
+  if (outputBytes) printf(",\"responseBytes\":%u", (unsigned)outputBytes);
+  printf("}\n");
+  fflush(stdout);
+}
+
+// Même chemin qu'une configuration reçue par l'API : fichier, chargement, reconfigure()
+bool applyDocument(JsonDocument& doc) {
+  File file = SPIFFS.open("/bench.json", "w");
+  serializeJson(doc, file);
+  file.close();
+
+  Config next;
+  if (!next.loadFromFile("/bench.json")) return false;
+  reconfigure(next);
+  return true;
+}
+
+void runSuite(int ruleCount, int deviceCount, uint32_t minTimeMs) {
+  {
+    JsonDocument doc;
+    generateConfig(doc, ruleCount, deviceCount);
+    if (!applyDocument(doc)) {
+      fprintf(stderr, "bench: cannot load %d rules / %d devices\n", ruleCount, deviceCount);
+      return;
+    }
+  }
+  // Réserves trop petites (DEVICE_POOL_SCALE) : mesures non comparables
+  if ((int)(sensors.size() + actuators.size()) != deviceCount) {
+    fprintf(stderr, "bench: %u of %d devices created, skipping\n",
+            (unsigned)(sensors.size() + actuators.size()), deviceCount);
+    return;
+  }
+
+  std::vector<BaseSensor*> slotted;
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    if (sensorSlots[slot]) slotted.push_back(sensorSlots[slot]);
+  }
+  std::vector<SensorReading> lowReadings;
+  std::vector<SensorReading> highReadings;
+  for (BaseSensor* sensor : slotted) {
+    lowReadings.push_back(syntheticReading(false));
+    highReadings.push_back(syntheticReading(true));
+    storeReading(sensor, lowReadings.back());
+  }
+  processRules();
+
+  // Conditions seules : le coût d'évaluation d'une règle déclenchée par capteur
+  volatile int sink = 0;
+  BenchResult result = measure(minTimeMs, [&]() {
+    int active = 0;
+    for (size_t i = 0; i < config.rules.size(); i++) {
+      const CompiledRule& program = config.compiledRules[i];
+      if (program.trigger != TriggerKind::SENSOR) continue;
+      active += evaluateConditions(config.conditionProgram.data() + program.firstCondition, config.rules[i].conditions);
+    }
+    sink = active;
+  });
+  report("evaluateConditions", ruleCount, deviceCount, config.rules.size(), result);
+
+  // Toutes les règles à réévaluer : conditions, actions et désactivations
+  result = measure(minTimeMs, [&]() {
+    std::fill(dirtyRules.begin(), dirtyRules.end(), 1);
+    processRules();
+  });
+  report("processRules", ruleCount, deviceCount, config.rules.size(), result);
+
+  // Une nouvelle lecture par capteur adressable, puis les règles dépendantes
+  bool high = false;
+  result = measure(minTimeMs, [&]() {
+    high = !high;
+    for (size_t i = 0; i < slotted.size(); i++) {
+      storeReading(slotted[i], high ? highReadings[i] : lowReadings[i]);
+      processRules();
+    }
+  });
+  report("updateSensor", ruleCount, deviceCount, slotted.size(), result);
+
+  // Corps de /api/sensors, sérialisé sans socket
+  CountingPrint out;
+  result = measure(minTimeMs, [&]() {
+    out.count = 0;
+    writeSensorData(out);
+  });
+  report("handleSensorData", ruleCount, deviceCount, 1, result, out.count);
+  (void)sink;
+}
+
+}
+
+extern "C" {
+
+// glibc : les fonctions d'origine restent accessibles sous ces noms
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocationBytes.fetch_add(size, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocationBytes.fetch_add(count * size, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  allocationBytes.fetch_add(size, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+  __libc_free(ptr);
+}
+
+}
+
+// Appelé par lib/NativeHAL à la place de setup()/loop() ; argument optionnel :
+// durée minimale de chaque mesure en ms (200 par défaut)
+int runBenchmarks(int argc, char** argv) {
+  uint32_t minTimeMs = (argc > 1) ? (uint32_t)atoi(argv[1]) : 200;
+  if (minTimeMs == 0) minTimeMs = 200;
+
+  if (!SPIFFS.begin(true)) {
+    fprintf(stderr, "bench: SPIFFS unavailable\n");
+    return 1;
+  }
+
+  for (int ruleCount : RULE_COUNTS) {
+    for (int deviceCount : DEVICE_COUNTS) {
+      runSuite(ruleCount, deviceCount, minTimeMs);
+    }
+  }
+
+  // Libère les dispositifs avant la sortie
+  Config empty;
+  reconfigure(empty);
+  return 0;
+}
+
+#endif
@@ -1,15 +1,180 @@
 #include "Config.h"
 #include <SPIFFS.h>
+#include <algorithm>
+#include "Log.h"
+
+namespace {
+
+// Valeur JSON internée : chaîne telle quelle, nombre ou booléen sous sa forme
+// texte, SYM_EMPTY si absente
+Symbol internValue(JsonVariantConst value) {
+  if (value.isNull()) return SYM_EMPTY;
+  if (value.is<const char*>()) return symbols.intern(value.as<const char*>());
+  return symbols.intern(value.as<String>());
+}
+
+// Texte libre recopié dans l'arène, "" si absent
+const char* copyValue(ConfigArena& arena, JsonVariantConst value) {
+  if (value.isNull()) return "";
+  if (value.is<const char*>()) return arena.copy(value.as<const char*>());
+  return arena.copy(value.as<String>().c_str());
+}
+
+// Place occupée par copyValue()
+size_t valueBytes(JsonVariantConst value) {
+  if (value.isNull()) return 0;
+  size_t length = value.is<const char*>() ? strlen(value.as<const char*>()) : value.as<String>().length();
+  return length ? length + 1 : 0;
+}
+
+// "HH:MM", heures 0-23 et minutes 0-59
+bool validClock(const char* text) {
+  if (!isdigit(text[0]) || !isdigit(text[1]) || text[2] != ':' ||
+      !isdigit(text[3]) || !isdigit(text[4]) || text[5] != '\0') {
+    return false;
+  }
+  return atoi(text) < 24 && atoi(text + 3) < 60;
+}
+
+// "HH:MM" en millisecondes depuis minuit
+unsigned long parseClock(const char* text) {
+  const char* colon = strchr(text, ':');
+  return (atol(text) * 60UL + atol(colon ? colon + 1 : text)) * 60UL * 1000UL;
+}
+
+}
+
+size_t ConfigExtent::arenaBytes() const {
+  // Marge d'alignement : quatre vecteurs par règle, sept pour Config
+  size_t vectors = rules * 4 + 7;
+  return devices * sizeof(DeviceConfig) +
+         rules * (sizeof(RuleConfig) + sizeof(CompiledRule)) +
+         conditions * (sizeof(Condition) + sizeof(CompiledCondition) + sizeof(uint16_t)) +
+         actions * (sizeof(Action) + sizeof(CompiledAction)) +
+         days * sizeof(Symbol) +
+         (MAX_SENSOR_SLOTS + 1) * sizeof(uint16_t) +
+         textBytes + vectors * 8;
+}
+
+Config::Config(size_t arenaCapacity)
+  : _arena(new ConfigArena(arenaCapacity)),
+    devices(_arena.get()),
+    rules(_arena.get()),
+    compiledRules(_arena.get()),
+    conditionProgram(_arena.get()),
+    actionProgram(_arena.get()),
+    sensorRuleOffsets(_arena.get()),
+    sensorRuleIndex(_arena.get()) {
+}
+
+Config::Config(const Config& other) : Config((other._arena ? other._arena->used() : 0) + CONFIG_ARENA_BLOCK) {
+  ConfigArena& arena = *_arena;
+  system = other.system;
+  system.wifi.ssid = arena.copy(other.system.wifi.ssid);
+  system.wifi.password = arena.copy(other.system.wifi.password);
+  system.auth.username = arena.copy(other.system.auth.username);
+  system.auth.password = arena.copy(other.system.auth.password);
+  system.auth.rootPassword = arena.copy(other.system.auth.rootPassword);
+  
+  devices.reserve(other.devices.size());
+  for (const auto& device : other.devices) {
+    devices.push_back(device);
+    devices.back().name = arena.copy(device.name);
+  }
+  
+  rules.reserve(other.rules.size());
+  for (const auto& source : other.rules) {
+    rules.emplace_back(&arena);
+    RuleConfig& rule = rules.back();
+    rule.id = source.id;
+    rule.name = arena.copy(source.name);
+    rule.enabled = source.enabled;
+    rule.triggerType = source.triggerType;
+    rule.conditions.assign(source.conditions.begin(), source.conditions.end());
+    rule.actions.assign(source.actions.begin(), source.actions.end());
+    rule.deactivationConditions.assign(source.deactivationConditions.begin(), source.deactivationConditions.end());
+    rule.schedule.startTime = arena.copy(source.schedule.startTime);
+    rule.schedule.endTime = arena.copy(source.schedule.endTime);
+    rule.schedule.days.assign(source.schedule.days.begin(), source.schedule.days.end());
+  }
+  
+  compiledRules.assign(other.compiledRules.begin(), other.compiledRules.end());
+  conditionProgram.assign(other.conditionProgram.begin(), other.conditionProgram.end());
+  actionProgram.assign(other.actionProgram.begin(), other.actionProgram.end());
+  sensorRuleOffsets.assign(other.sensorRuleOffsets.begin(), other.sensorRuleOffsets.end());
+  sensorRuleIndex.assign(other.sensorRuleIndex.begin(), other.sensorRuleIndex.end());
+  sensorSlotCount = other.sensorSlotCount;
+  actuatorSlotCount = other.actuatorSlotCount;
+  loadedFromSnapshot = other.loadedFromSnapshot;
+  loadMicros = other.loadMicros;
+}
+
+// L'arène et les vecteurs (avec leur allocateur) changent de propriétaire
+// sans allocation ; la source reste sans arène
+Config::Config(Config&& other)
+  : _arena(std::move(other._arena)),
+    system(other.system),
+    devices(std::move(other.devices)),
+    rules(std::move(other.rules)),
+    compiledRules(std::move(other.compiledRules)),
+    conditionProgram(std::move(other.conditionProgram)),
+    actionProgram(std::move(other.actionProgram)),
+    sensorSlotCount(other.sensorSlotCount),
+    actuatorSlotCount(other.actuatorSlotCount),
+    sensorRuleOffsets(std::move(other.sensorRuleOffsets)),
+    sensorRuleIndex(std::move(other.sensorRuleIndex)),
+    loadedFromSnapshot(other.loadedFromSnapshot),
+    loadMicros(other.loadMicros) {
+}
+
+Config& Config::operator=(Config&& other) {
+  swap(other);
+  return *this;
+}
+
+// Les vecteurs emportent leur allocateur : chaque arène suit son contenu
+void Config::swap(Config& other) {
+  std::swap(_arena, other._arena);
+  std::swap(system, other.system);
+  devices.swap(other.devices);
+  rules.swap(other.rules);
+  compiledRules.swap(other.compiledRules);
+  conditionProgram.swap(other.conditionProgram);
+  actionProgram.swap(other.actionProgram);
+  std::swap(sensorSlotCount, other.sensorSlotCount);
+  std::swap(actuatorSlotCount, other.actuatorSlotCount);
+  sensorRuleOffsets.swap(other.sensorRuleOffsets);
+  sensorRuleIndex.swap(other.sensorRuleIndex);
+  std::swap(loadedFromSnapshot, other.loadedFromSnapshot);
+  std::swap(loadMicros, other.loadMicros);
+}
 
 bool Config::loadFromFile(const String& filename) {
+  uint32_t start = micros();
+  
   if (!SPIFFS.exists(filename)) {
-    Serial.println("Configuration file not found: " + filename);
+    LOG_E("Configuration file not found: %s", filename.c_str());
     return false;
   }
   
+#if CONFIG_SNAPSHOT
+  // JSON inchangé depuis le dernier chargement : instantané binaire
+  uint32_t sourceHash = 0;
+  uint32_t sourceSize = 0;
+  String snapshot = snapshotPath(filename);
+  bool hashed = hashFile(filename, sourceHash, sourceSize);
+  if (hashed && loadSnapshot(snapshot, sourceHash, sourceSize)) {
+    loadedFromSnapshot = true;
+    loadMicros = micros() - start;
+    LOG_I("Configuration loaded from snapshot in %u us (arena %u bytes, free heap %u)",
+          (unsigned)loadMicros, (unsigned)_arena->capacity(), (unsigned)ESP.getFreeHeap());
+    return true;
+  }
+#endif
+  
   File file = SPIFFS.open(filename, "r");
   if (!file) {
-    Serial.println("Failed to open configuration file");
+    LOG_E("Failed to open configuration file");
     return false;
   }
   
@@ -18,106 +183,460 @@ bool Config::loadFromFile(const String& filename) {
   file.close();
   
   if (error) {
-    Serial.println("Failed to parse configuration file: " + String(error.c_str()));
+    LOG_E("Failed to parse configuration file: %s", error.c_str());
     return false;
   }
   
+  // Nouvelle configuration dans sa propre arène : l'actuelle reste intacte
+  // jusqu'à l'échange, puis son arène est libérée avec loaded
+  Config loaded(measure(doc).arenaBytes());
+  
   JsonObject systemObj = doc["system"];
-  parseSystemConfig(systemObj);
+  loaded.parseSystemConfig(systemObj);
   
   JsonArray devicesArray = doc["devices"];
-  parseDevices(devicesArray);
+  loaded.parseDevices(devicesArray);
   
   JsonArray rulesArray = doc["rules"];
-  parseRules(rulesArray);
+  loaded.parseRules(rulesArray);
+  
+  swap(loaded);
   
-  Serial.println("Configuration loaded successfully");
+  loadedFromSnapshot = false;
+  loadMicros = micros() - start;
+  LOG_I("Configuration parsed from JSON in %u us (arena %u bytes, free heap %u)",
+        (unsigned)loadMicros, (unsigned)_arena->capacity(), (unsigned)ESP.getFreeHeap());
+  
+#if CONFIG_SNAPSHOT
+  if (hashed) saveSnapshot(snapshot, sourceHash, sourceSize);
+#endif
   return true;
 }
 
+ConfigExtent Config::measure(JsonDocument& doc) {
+  ConfigExtent extent;
+  
+  JsonObject systemObj = doc["system"];
+  extent.textBytes += valueBytes(systemObj["wifi"]["ssid"]) + valueBytes(systemObj["wifi"]["password"]) +
+                      valueBytes(systemObj["auth"]["username"]) + valueBytes(systemObj["auth"]["password"]) +
+                      valueBytes(systemObj["auth"]["root_password"]);
+  
+  for (JsonObject deviceObj : doc["devices"].as<JsonArray>()) {
+    extent.devices++;
+    extent.textBytes += valueBytes(deviceObj["name"]);
+  }
+  
+  for (JsonObject ruleObj : doc["rules"].as<JsonArray>()) {
+    extent.rules++;
+    extent.textBytes += valueBytes(ruleObj["name"]);
+    extent.conditions += ruleObj["conditions"].size() + ruleObj["deactivation_conditions"].size();
+    extent.actions += ruleObj["actions"].size();
+    JsonObject scheduleObj = ruleObj["schedule"];
+    if (!scheduleObj.isNull()) {
+      extent.textBytes += valueBytes(scheduleObj["start_time"]) + valueBytes(scheduleObj["end_time"]);
+      extent.days += scheduleObj["days"].size();
+    }
+  }
+  return extent;
+}
+
 void Config::parseSystemConfig(JsonObject& systemObj) {
-  system.wifi.ssid = systemObj["wifi"]["ssid"].as<String>();
-  system.wifi.password = systemObj["wifi"]["password"].as<String>();
-  system.auth.username = systemObj["auth"]["username"].as<String>();
-  system.auth.password = systemObj["auth"]["password"].as<String>();
-  system.auth.rootPassword = systemObj["auth"]["root_password"].as<String>();
+  system.wifi.ssid = copyValue(*_arena, systemObj["wifi"]["ssid"]);
+  system.wifi.password = copyValue(*_arena, systemObj["wifi"]["password"]);
+  system.auth.username = copyValue(*_arena, systemObj["auth"]["username"]);
+  system.auth.password = copyValue(*_arena, systemObj["auth"]["password"]);
+  system.auth.rootPassword = copyValue(*_arena, systemObj["auth"]["root_password"]);
   system.captivePortal = systemObj["captive_portal"].as<bool>();
 }
 
 void Config::parseDevices(JsonArray& devicesArray) {
   devices.clear();
+  devices.reserve(devicesArray.size());
   for (JsonObject deviceObj : devicesArray) {
     DeviceConfig device;
-    device.id = deviceObj["id"].as<String>();
-    device.name = deviceObj["name"].as<String>();
-    device.type = deviceObj["type"].as<String>();
-    device.sensorType = deviceObj["sensor_type"].as<String>();
-    device.actuatorType = deviceObj["actuator_type"].as<String>();
-    device.pin = deviceObj["pin"].as<int>();
-    device.enabled = deviceObj["enabled"].as<bool>();
-    device.readInterval = deviceObj["read_interval"].as<unsigned long>();
-    device.state = deviceObj["state"].as<bool>();
+    parseDevice(deviceObj, device);
     devices.push_back(device);
   }
+  assignSlots();
+}
+
+void Config::parseDevice(JsonObject deviceObj, DeviceConfig& device) {
+  device.id = internValue(deviceObj["id"]);
+  device.name = copyValue(*_arena, deviceObj["name"]);
+  device.type = internValue(deviceObj["type"]);
+  device.sensorType = internValue(deviceObj["sensor_type"]);
+  device.actuatorType = internValue(deviceObj["actuator_type"]);
+  device.pin = deviceObj["pin"].as<int>();
+  device.enabled = deviceObj["enabled"].as<bool>();
+  device.readInterval = deviceObj["read_interval"].as<unsigned long>();
+  device.state = deviceObj["state"].as<bool>();
+  device.slot = -1;
+}
+
+void Config::assignSlots() {
+  // Attribution d'un index aux capteurs et actionneurs actifs, dans l'ordre
+  sensorSlotCount = 0;
+  actuatorSlotCount = 0;
+  for (auto& device : devices) {
+    device.slot = -1;
+    if (device.type == SYM_SENSOR && device.enabled) {
+      if (sensorSlotCount < MAX_SENSOR_SLOTS) {
+        device.slot = sensorSlotCount++;
+      } else {
+        LOG_W("Too many sensors, ignoring: %s", symbols.text(device.id));
+      }
+    } else if (device.type == SYM_ACTUATOR && device.enabled) {
+      if (actuatorSlotCount < MAX_ACTUATOR_SLOTS) {
+        device.slot = actuatorSlotCount++;
+      } else {
+        LOG_W("Too many actuators, ignoring: %s", symbols.text(device.id));
+      }
+    }
+  }
 }
 
 void Config::parseRules(JsonArray& rulesArray) {
   rules.clear();
+  rules.reserve(rulesArray.size());
   for (JsonObject ruleObj : rulesArray) {
-    RuleConfig rule;
-    rule.id = ruleObj["id"].as<String>();
-    rule.name = ruleObj["name"].as<String>();
-    rule.enabled = ruleObj["enabled"].as<bool>();
-    rule.triggerType = ruleObj["trigger_type"].as<String>();
-    
-    if (!ruleObj["conditions"].isNull()) {
-      JsonArray conditionsArray = ruleObj["conditions"];
-      parseConditions(conditionsArray, rule.conditions);
+    rules.emplace_back(_arena.get());
+    parseRule(ruleObj, rules.back());
+  }
+  
+  compileRules();
+}
+
+void Config::parseRule(JsonObject ruleObj, RuleConfig& rule) {
+  rule.id = internValue(ruleObj["id"]);
+  rule.name = copyValue(*_arena, ruleObj["name"]);
+  rule.enabled = ruleObj["enabled"].as<bool>();
+  rule.triggerType = internValue(ruleObj["trigger_type"]);
+  
+  if (!ruleObj["conditions"].isNull()) {
+    JsonArray conditionsArray = ruleObj["conditions"];
+    parseConditions(conditionsArray, rule.conditions);
+  }
+  
+  if (!ruleObj["actions"].isNull()) {
+    JsonArray actionsArray = ruleObj["actions"];
+    parseActions(actionsArray, rule.actions);
+  }
+  
+  if (!ruleObj["deactivation_conditions"].isNull()) {
+    JsonArray deactivationArray = ruleObj["deactivation_conditions"];
+    parseConditions(deactivationArray, rule.deactivationConditions);
+  }
+  
+  if (!ruleObj["schedule"].isNull()) {
+    JsonObject scheduleObj = ruleObj["schedule"];
+    rule.schedule.startTime = copyValue(*_arena, scheduleObj["start_time"]);
+    rule.schedule.endTime = copyValue(*_arena, scheduleObj["end_time"]);
+    JsonArray daysArray = scheduleObj["days"];
+    rule.schedule.days.reserve(daysArray.size());
+    for (JsonVariant day : daysArray) {
+      rule.schedule.days.push_back(internValue(day));
+    }
+  }
+}
+
+int Config::findDevice(Symbol id) const {
+  for (size_t i = 0; i < devices.size(); i++) {
+    if (devices[i].id == id) return i;
+  }
+  return -1;
+}
+
+int Config::findRule(Symbol id) const {
+  for (size_t i = 0; i < rules.size(); i++) {
+    if (rules[i].id == id) return i;
+  }
+  return -1;
+}
+
+void Config::putDevice(JsonObject deviceObj) {
+  DeviceConfig device;
+  parseDevice(deviceObj, device);
+  int index = findDevice(device.id);
+  if (index >= 0) {
+    devices[index] = device;
+  } else {
+    devices.push_back(device);
+  }
+  // Les index et les règles qui désignent ce dispositif sont à refaire
+  assignSlots();
+  compileRules();
+}
+
+bool Config::removeDevice(Symbol id) {
+  int index = findDevice(id);
+  if (index < 0) return false;
+  devices.erase(devices.begin() + index);
+  assignSlots();
+  compileRules();
+  return true;
+}
+
+void Config::putRule(JsonObject ruleObj) {
+  RuleConfig rule(_arena.get());
+  parseRule(ruleObj, rule);
+  int index = findRule(rule.id);
+  if (index >= 0) {
+    rules[index] = std::move(rule);
+  } else {
+    rules.push_back(std::move(rule));
+  }
+  compileRules();
+}
+
+bool Config::removeRule(Symbol id) {
+  int index = findRule(id);
+  if (index < 0) return false;
+  rules.erase(rules.begin() + index);
+  compileRules();
+  return true;
+}
+
+const char* Config::validate() const {
+  for (const auto& rule : rules) {
+    const char* error = checkRule(rule);
+    if (error) return error;
+  }
+  return nullptr;
+}
+
+const char* Config::checkRule(const RuleConfig& rule) const {
+  switch (rule.triggerType) {
+    case SYM_SENSOR_THRESHOLD:
+    case SYM_SENSOR_COMBINATION:
+    case SYM_CRITICAL_EVENT:
+      break;
+    case SYM_SCHEDULE:
+      if (!validClock(rule.schedule.startTime) || !validClock(rule.schedule.endTime)) {
+        return "schedule needs start_time and end_time as HH:MM";
+      }
+      break;
+    default:
+      return "Unknown trigger_type";
+  }
+  
+  const ArenaVector<Condition>* parts[2] = { &rule.conditions, &rule.deactivationConditions };
+  for (int part = 0; part < 2; part++) {
+    for (const auto& condition : *parts[part]) {
+      int device = findDevice(condition.sensorId);
+      if (device < 0 || devices[device].type != SYM_SENSOR) return "Condition refers to an unknown sensor";
+      if (condition.parameter < SYM_TEMPERATURE || condition.parameter > SYM_PRESSED) return "Unknown condition parameter";
+      if (condition.operator_ < SYM_GT || condition.operator_ > SYM_LE) return "Unknown condition operator";
+      if (condition.logic != SYM_EMPTY && condition.logic != SYM_AND && condition.logic != SYM_OR) return "Unknown condition logic";
+      if (!isfinite(condition.value)) return "Condition value must be a number";
     }
+  }
+  
+  for (const auto& action : rule.actions) {
+    int device = findDevice(action.actuatorId);
+    if (device < 0 || devices[device].type != SYM_ACTUATOR) return "Action refers to an unknown actuator";
+    if (action.action < SYM_TURN_ON || action.action > SYM_TOGGLE) return "Unknown action";
+  }
+  return nullptr;
+}
+
+void Config::compileRules() {
+  compiledRules.clear();
+  conditionProgram.clear();
+  actionProgram.clear();
+  
+  // Tailles exactes réservées d'avance : pas de réallocation dans l'arène
+  size_t conditionTotal = 0;
+  size_t actionTotal = 0;
+  for (const auto& rule : rules) {
+    conditionTotal += rule.conditions.size() + rule.deactivationConditions.size();
+    actionTotal += rule.actions.size();
+  }
+  compiledRules.reserve(rules.size());
+  conditionProgram.reserve(conditionTotal);
+  actionProgram.reserve(actionTotal);
+  
+  for (const auto& rule : rules) {
+    CompiledRule compiled;
     
-    if (!ruleObj["actions"].isNull()) {
-      JsonArray actionsArray = ruleObj["actions"];
-      parseActions(actionsArray, rule.actions);
+    switch (rule.triggerType) {
+      case SYM_SENSOR_THRESHOLD:
+      case SYM_SENSOR_COMBINATION:
+      case SYM_CRITICAL_EVENT: compiled.trigger = TriggerKind::SENSOR; break;
+      case SYM_SCHEDULE:       compiled.trigger = TriggerKind::SCHEDULE; break;
+      default:                 compiled.trigger = TriggerKind::UNKNOWN; break;
     }
+    compiled.timeDriven = (compiled.trigger == TriggerKind::SCHEDULE);
+    
+    compileConditions(rule.conditions, compiled.firstCondition, compiled.conditionCount);
+    compileConditions(rule.deactivationConditions, compiled.firstDeactivation, compiled.deactivationCount);
+    compileActions(rule, compiled.firstAction, compiled.actionCount);
     
-    if (!ruleObj["deactivation_conditions"].isNull()) {
-      JsonArray deactivationArray = ruleObj["deactivation_conditions"];
-      parseConditions(deactivationArray, rule.deactivationConditions);
+    // Plage horaire "HH:MM" convertie en millisecondes depuis le démarrage
+    compiled.scheduleValid = *rule.schedule.startTime && *rule.schedule.endTime;
+    compiled.scheduleStart = 0;
+    compiled.scheduleEnd = 0;
+    if (compiled.scheduleValid) {
+      compiled.scheduleStart = parseClock(rule.schedule.startTime);
+      compiled.scheduleEnd = parseClock(rule.schedule.endTime);
     }
     
-    if (!ruleObj["schedule"].isNull()) {
-      JsonObject scheduleObj = ruleObj["schedule"];
-      rule.schedule.startTime = scheduleObj["start_time"].as<String>();
-      rule.schedule.endTime = scheduleObj["end_time"].as<String>();
-      JsonArray daysArray = scheduleObj["days"];
-      for (JsonVariant day : daysArray) {
-        rule.schedule.days.push_back(day.as<String>());
+    compiledRules.push_back(compiled);
+  }
+  
+  buildDependencyIndex();
+}
+
+void Config::buildDependencyIndex() {
+  // Premier passage : compter les règles distinctes par capteur
+  int lastRule[MAX_SENSOR_SLOTS];
+  std::fill(lastRule, lastRule + sensorSlotCount, -1);
+  sensorRuleOffsets.assign(sensorSlotCount + 1, 0);
+  
+  for (size_t r = 0; r < compiledRules.size(); r++) {
+    const CompiledRule& rule = compiledRules[r];
+    uint16_t first[2] = { rule.firstCondition, rule.firstDeactivation };
+    uint16_t count[2] = { rule.conditionCount, rule.deactivationCount };
+    for (int part = 0; part < 2; part++) {
+      for (uint16_t c = first[part]; c < first[part] + count[part]; c++) {
+        int slot = conditionProgram[c].slot;
+        if (slot >= 0 && lastRule[slot] != (int)r) {
+          lastRule[slot] = r;
+          sensorRuleOffsets[slot + 1]++;
+        }
       }
     }
+  }
+  
+  for (int s = 0; s < sensorSlotCount; s++) {
+    sensorRuleOffsets[s + 1] += sensorRuleOffsets[s];
+  }
+  
+  // Second passage : remplir l'index
+  sensorRuleIndex.assign(sensorRuleOffsets[sensorSlotCount], 0);
+  uint16_t fill[MAX_SENSOR_SLOTS];
+  std::copy(sensorRuleOffsets.begin(), sensorRuleOffsets.end() - 1, fill);
+  std::fill(lastRule, lastRule + sensorSlotCount, -1);
+  
+  for (size_t r = 0; r < compiledRules.size(); r++) {
+    const CompiledRule& rule = compiledRules[r];
+    uint16_t first[2] = { rule.firstCondition, rule.firstDeactivation };
+    uint16_t count[2] = { rule.conditionCount, rule.deactivationCount };
+    for (int part = 0; part < 2; part++) {
+      for (uint16_t c = first[part]; c < first[part] + count[part]; c++) {
+        int slot = conditionProgram[c].slot;
+        if (slot >= 0 && lastRule[slot] != (int)r) {
+          lastRule[slot] = r;
+          sensorRuleIndex[fill[slot]++] = r;
+        }
+      }
+    }
+  }
+}
+
+void Config::compileConditions(const ArenaVector<Condition>& conditions, uint16_t& first, uint16_t& count) {
+  first = conditionProgram.size();
+  count = conditions.size();
+  
+  for (const auto& condition : conditions) {
+    CompiledCondition compiled;
+    compiled.slot = findSensorSlot(condition.sensorId);
+    compiled.value = condition.value;
+    
+    switch (condition.parameter) {
+      case SYM_TEMPERATURE: compiled.field = SensorField::TEMPERATURE; break;
+      case SYM_HUMIDITY:    compiled.field = SensorField::HUMIDITY; break;
+      case SYM_GAS:         compiled.field = SensorField::GAS; break;
+      case SYM_CURRENT:     compiled.field = SensorField::CURRENT; break;
+      case SYM_LIGHT:       compiled.field = SensorField::LIGHT; break;
+      case SYM_MOTION:      compiled.field = SensorField::MOTION; break;
+      case SYM_PRESSED:     compiled.field = SensorField::PRESSED; break;
+      default:              compiled.field = SensorField::UNKNOWN; break;
+    }
+    
+    switch (condition.operator_) {
+      case SYM_GT: compiled.op = CompareOp::GT; break;
+      case SYM_LT: compiled.op = CompareOp::LT; break;
+      case SYM_EQ: compiled.op = CompareOp::EQ; break;
+      case SYM_GE: compiled.op = CompareOp::GE; break;
+      case SYM_LE: compiled.op = CompareOp::LE; break;
+      default:     compiled.op = CompareOp::UNKNOWN; break;
+    }
+    
+    switch (condition.logic) {
+      case SYM_EMPTY:
+      case SYM_AND: compiled.logic = LogicOp::AND; break;
+      case SYM_OR:  compiled.logic = LogicOp::OR; break;
+      default:      compiled.logic = LogicOp::UNKNOWN; break;
+    }
+    
+    conditionProgram.push_back(compiled);
+  }
+}
+
+void Config::compileActions(const RuleConfig& rule, uint16_t& first, uint16_t& count) {
+  first = actionProgram.size();
+  count = rule.actions.size();
+  
+  for (const auto& action : rule.actions) {
+    CompiledAction compiled;
+    compiled.actuator = findActuatorSlot(action.actuatorId);
+    compiled.duration = action.duration;
+    compiled.pattern = parseBuzzerPattern(action.pattern);
+    
+    switch (action.action) {
+      case SYM_TURN_ON:  compiled.op = ActionOp::TURN_ON; break;
+      case SYM_TURN_OFF: compiled.op = ActionOp::TURN_OFF; break;
+      case SYM_TOGGLE:   compiled.op = ActionOp::TOGGLE; break;
+      default:           compiled.op = ActionOp::UNKNOWN; break;
+    }
     
-    rules.push_back(rule);
+    if (compiled.actuator < 0) {
+      LOG_W("Rule %s: actuator %s not found", symbols.text(rule.id), symbols.text(action.actuatorId));
+    }
+    
+    actionProgram.push_back(compiled);
+  }
+}
+
+int Config::findActuatorSlot(Symbol actuatorId) const {
+  for (const auto& device : devices) {
+    if (device.type == SYM_ACTUATOR && device.id == actuatorId) {
+      return device.slot;
+    }
+  }
+  return -1;
+}
+
+int Config::findSensorSlot(Symbol sensorId) const {
+  for (const auto& device : devices) {
+    if (device.type == SYM_SENSOR && device.id == sensorId) {
+      return device.slot;
+    }
   }
+  return -1;
 }
 
-void Config::parseConditions(JsonArray& conditionsArray, std::vector<Condition>& conditions) {
+void Config::parseConditions(JsonArray& conditionsArray, ArenaVector<Condition>& conditions) {
+  conditions.reserve(conditions.size() + conditionsArray.size());
   for (JsonObject conditionObj : conditionsArray) {
     Condition condition;
-    condition.sensorId = conditionObj["sensor_id"].as<String>();
-    condition.parameter = conditionObj["parameter"].as<String>();
-    condition.operator_ = conditionObj["operator"].as<String>();
+    condition.sensorId = internValue(conditionObj["sensor_id"]);
+    condition.parameter = internValue(conditionObj["parameter"]);
+    condition.operator_ = internValue(conditionObj["operator"]);
     condition.value = conditionObj["value"].as<float>();
-    condition.logic = conditionObj["logic"].as<String>();
+    condition.logic = internValue(conditionObj["logic"]);
     conditions.push_back(condition);
   }
 }
 
-void Config::parseActions(JsonArray& actionsArray, std::vector<Action>& actions) {
+void Config::parseActions(JsonArray& actionsArray, ArenaVector<Action>& actions) {
+  actions.reserve(actions.size() + actionsArray.size());
   for (JsonObject actionObj : actionsArray) {
     Action action;
-    action.actuatorId = actionObj["actuator_id"].as<String>();
-    action.action = actionObj["action"].as<String>();
+    action.actuatorId = internValue(actionObj["actuator_id"]);
+    action.action = internValue(actionObj["action"]);
     action.duration = actionObj["duration"].as<unsigned long>();
-    action.pattern = actionObj["pattern"].as<String>();
+    action.pattern = internValue(actionObj["pattern"]);
     actions.push_back(action);
   }
 }
@@ -141,69 +660,108 @@ bool Config::saveToFile(const String& filename) {
   // Serialize devices
   JsonArray devices = doc["devices"].to<JsonArray>();
   for (const auto& device : this->devices) {
-    JsonObject deviceObj = devices.add<JsonObject>();
-    deviceObj["id"] = device.id;
-    deviceObj["name"] = device.name;
-    deviceObj["type"] = device.type;
-    if (!device.sensorType.isEmpty()) deviceObj["sensor_type"] = device.sensorType;
-    if (!device.actuatorType.isEmpty()) deviceObj["actuator_type"] = device.actuatorType;
-    deviceObj["pin"] = device.pin;
-    deviceObj["enabled"] = device.enabled;
-    if (device.readInterval > 0) deviceObj["read_interval"] = device.readInterval;
-    deviceObj["state"] = device.state;
+    writeDevice(devices.add<JsonObject>(), device);
   }
   
   // Serialize rules
   JsonArray rules = doc["rules"].to<JsonArray>();
   for (const auto& rule : this->rules) {
-    JsonObject ruleObj = rules.add<JsonObject>();
-    ruleObj["id"] = rule.id;
-    ruleObj["name"] = rule.name;
-    ruleObj["enabled"] = rule.enabled;
-    ruleObj["trigger_type"] = rule.triggerType;
-    
-    if (!rule.conditions.empty()) {
-      JsonArray conditions = ruleObj["conditions"].to<JsonArray>();
-      for (const auto& condition : rule.conditions) {
-        JsonObject conditionObj = conditions.add<JsonObject>();
-        conditionObj["sensor_id"] = condition.sensorId;
-        conditionObj["parameter"] = condition.parameter;
-        conditionObj["operator"] = condition.operator_;
-        conditionObj["value"] = condition.value;
-        if (!condition.logic.isEmpty()) conditionObj["logic"] = condition.logic;
-      }
-    }
-    
-    if (!rule.actions.empty()) {
-      JsonArray actions = ruleObj["actions"].to<JsonArray>();
-      for (const auto& action : rule.actions) {
-        JsonObject actionObj = actions.add<JsonObject>();
-        actionObj["actuator_id"] = action.actuatorId;
-        actionObj["action"] = action.action;
-        if (action.duration > 0) actionObj["duration"] = action.duration;
-        if (!action.pattern.isEmpty()) actionObj["pattern"] = action.pattern;
-      }
-    }
+    writeRule(rules.add<JsonObject>(), rule);
   }
   
   File file = SPIFFS.open(filename, "w");
   if (!file) {
-    Serial.println("Failed to open file for writing");
+    LOG_E("Failed to open file for writing");
     return false;
   }
   
   serializeJsonPretty(doc, file);
   file.close();
   
-  Serial.println("Configuration saved successfully");
+  // L'instantané doit correspondre au nouveau JSON
+  writeSnapshot(filename);
+  
+  LOG_I("Configuration saved successfully");
+  return true;
+}
+
+bool Config::writeSnapshot(const String& filename) const {
+#if CONFIG_SNAPSHOT
+  uint32_t hash = 0;
+  uint32_t size = 0;
+  if (!hashFile(filename, hash, size)) return false;
+  return saveSnapshot(snapshotPath(filename), hash, size);
+#else
   return true;
+#endif
+}
+
+void Config::writeDevice(JsonObject deviceObj, const DeviceConfig& device) {
+  deviceObj["id"] = symbols.text(device.id);
+  deviceObj["name"] = device.name;
+  deviceObj["type"] = symbols.text(device.type);
+  if (device.sensorType != SYM_EMPTY) deviceObj["sensor_type"] = symbols.text(device.sensorType);
+  if (device.actuatorType != SYM_EMPTY) deviceObj["actuator_type"] = symbols.text(device.actuatorType);
+  deviceObj["pin"] = device.pin;
+  deviceObj["enabled"] = device.enabled;
+  if (device.readInterval > 0) deviceObj["read_interval"] = device.readInterval;
+  deviceObj["state"] = device.state;
+}
+
+void Config::writeRule(JsonObject ruleObj, const RuleConfig& rule) {
+  ruleObj["id"] = symbols.text(rule.id);
+  ruleObj["name"] = rule.name;
+  ruleObj["enabled"] = rule.enabled;
+  ruleObj["trigger_type"] = symbols.text(rule.triggerType);
+  
+  if (!rule.conditions.empty()) {
+    JsonArray conditions = ruleObj["conditions"].to<JsonArray>();
+    writeConditions(conditions, rule.conditions);
+  }
+  
+  if (!rule.actions.empty()) {
+    JsonArray actions = ruleObj["actions"].to<JsonArray>();
+    for (const auto& action : rule.actions) {
+      JsonObject actionObj = actions.add<JsonObject>();
+      actionObj["actuator_id"] = symbols.text(action.actuatorId);
+      actionObj["action"] = symbols.text(action.action);
+      if (action.duration > 0) actionObj["duration"] = action.duration;
+      if (action.pattern != SYM_EMPTY) actionObj["pattern"] = symbols.text(action.pattern);
+    }
+  }
+  
+  if (!rule.deactivationConditions.empty()) {
+    JsonArray deactivation = ruleObj["deactivation_conditions"].to<JsonArray>();
+    writeConditions(deactivation, rule.deactivationConditions);
+  }
+  
+  if (*rule.schedule.startTime || *rule.schedule.endTime) {
+    JsonObject schedule = ruleObj["schedule"].to<JsonObject>();
+    schedule["start_time"] = rule.schedule.startTime;
+    schedule["end_time"] = rule.schedule.endTime;
+    JsonArray days = schedule["days"].to<JsonArray>();
+    for (Symbol day : rule.schedule.days) {
+      days.add(symbols.text(day));
+    }
+  }
+}
+
+void Config::writeConditions(JsonArray& conditionsArray, const ArenaVector<Condition>& conditions) {
+  for (const auto& condition : conditions) {
+    JsonObject conditionObj = conditionsArray.add<JsonObject>();
+    conditionObj["sensor_id"] = symbols.text(condition.sensorId);
+    conditionObj["parameter"] = symbols.text(condition.parameter);
+    conditionObj["operator"] = symbols.text(condition.operator_);
+    conditionObj["value"] = condition.value;
+    if (condition.logic != SYM_EMPTY) conditionObj["logic"] = symbols.text(condition.logic);
+  }
 }
 
 void Config::printConfig() {
-  Serial.println("=== OPENDOM Configuration ===");
-  Serial.println("WiFi SSID: " + system.wifi.ssid);
-  Serial.println("Username: " + system.auth.username);
-  Serial.println("Devices count: " + String(devices.size()));
-  Serial.println("Rules count: " + String(rules.size()));
-  Serial.println("==============================");
+  LOG_I("=== OPENDOM Configuration ===");
+  LOG_I("WiFi SSID: %s", system.wifi.ssid);
+  LOG_I("Username: %s", system.auth.username);
+  LOG_I("Devices count: %u", (unsigned)devices.size());
+  LOG_I("Rules count: %u", (unsigned)rules.size());
+  LOG_I("==============================");
 }
@@ -0,0 +1,63 @@
+#include "ConfigArena.h"
+#include <string.h>
+
+std::atomic<size_t> ConfigArena::_live(0);
+std::atomic<size_t> ConfigArena::_peak(0);
+
+ConfigArena::ConfigArena(size_t capacity) : _current(nullptr), _used(0), _capacity(0), _blocks(0) {
+  if (capacity > 0) addBlock(capacity);
+}
+
+ConfigArena::~ConfigArena() {
+  while (_current) {
+    Block* previous = _current->previous;
+    free(_current);
+    _current = previous;
+  }
+  _live.fetch_sub(_capacity + _blocks * sizeof(Block), std::memory_order_relaxed);
+}
+
+ConfigArena::Block* ConfigArena::addBlock(size_t size) {
+  Block* block = (Block*)malloc(sizeof(Block) + size);
+  if (!block) return nullptr;
+  block->previous = _current;
+  block->size = size;
+  block->top = 0;
+  _current = block;
+  _capacity += size;
+  _blocks++;
+
+  size_t live = _live.fetch_add(sizeof(Block) + size, std::memory_order_relaxed) + sizeof(Block) + size;
+  size_t peak = _peak.load(std::memory_order_relaxed);
+  while (live > peak && !_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  return block;
+}
+
+void* ConfigArena::allocate(size_t size, size_t align) {
+  // Alignement calculé sur l'adresse : malloc ne garantit que 4 octets sur ESP32
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (_current) {
+      uintptr_t base = (uintptr_t)(_current + 1);
+      uintptr_t start = (base + _current->top + align - 1) & ~(uintptr_t)(align - 1);
+      if (start + size <= base + _current->size) {
+        _used += start + size - (base + _current->top);
+        _current->top = start + size - base;
+        return (void*)start;
+      }
+    }
+    // Bloc plein : le reste est perdu jusqu'à la destruction de l'arène
+    size_t needed = size + align;
+    if (!addBlock(needed > CONFIG_ARENA_BLOCK ? needed : CONFIG_ARENA_BLOCK)) return nullptr;
+  }
+  return nullptr;
+}
+
+const char* ConfigArena::copy(const char* text) {
+  if (!text || !*text) return "";
+  size_t length = strlen(text);
+  char* stored = (char*)allocate(length + 1, 1);
+  if (!stored) return "";
+  memcpy(stored, text, length + 1);
+  return stored;
+}
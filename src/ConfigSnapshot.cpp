@@ -0,0 +1,486 @@
+#include "Config.h"
+#include <SPIFFS.h>
+#include <esp_rom_crc.h>
+#include <memory>
+#include <new>
+#include "Log.h"
+
+// Format de l'instantané : en-tête, tableaux plats d'enregistrements de taille
+// fixe, puis table de chaînes terminées par un zéro. Les chaînes sont
+// désignées par leur position dans la table. Toute modification de ces
+// structures doit incrémenter SNAPSHOT_VERSION.
+namespace {
+
+const uint32_t SNAPSHOT_MAGIC = 0x46434F44; // "DOCF"
+const uint16_t SNAPSHOT_VERSION = 1;
+
+struct SnapshotHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t sourceHash;   // FNV-1a du JSON d'origine
+  uint32_t sourceSize;
+  uint32_t payloadSize;  // Octets après l'en-tête
+  uint32_t payloadCrc;
+  uint16_t deviceCount;
+  uint16_t ruleCount;
+  uint16_t conditionCount;
+  uint16_t actionCount;
+  uint16_t dayCount;
+  uint16_t sensorSlotCount;
+  uint16_t actuatorSlotCount;
+  uint16_t padding;
+  uint32_t stringBytes;
+};
+
+struct SystemRecord {
+  uint16_t ssid;
+  uint16_t wifiPassword;
+  uint16_t username;
+  uint16_t password;
+  uint16_t rootPassword;
+  uint8_t captivePortal;
+  uint8_t padding;
+};
+
+struct DeviceRecord {
+  uint32_t readInterval;
+  uint16_t id;
+  uint16_t name;
+  uint16_t type;
+  uint16_t sensorType;
+  uint16_t actuatorType;
+  int16_t pin;
+  int8_t slot;
+  uint8_t enabled;
+  uint8_t state;
+  uint8_t padding;
+};
+
+// Conditions, désactivations et jours d'une règle : tranches contiguës des
+// tableaux communs
+struct RuleRecord {
+  uint16_t id;
+  uint16_t name;
+  uint16_t triggerType;
+  uint16_t startTime;
+  uint16_t endTime;
+  uint16_t firstCondition;
+  uint16_t conditionCount;
+  uint16_t firstDeactivation;
+  uint16_t deactivationCount;
+  uint16_t firstAction;
+  uint16_t actionCount;
+  uint16_t firstDay;
+  uint16_t dayCount;
+  uint8_t enabled;
+  uint8_t padding;
+};
+
+struct ConditionRecord {
+  float value;
+  uint16_t sensorId;
+  uint16_t parameter;
+  uint16_t operator_;
+  uint16_t logic;
+};
+
+struct ActionRecord {
+  uint32_t duration;
+  uint16_t actuatorId;
+  uint16_t action;
+  uint16_t pattern;
+  uint16_t padding;
+};
+
+static_assert(sizeof(SnapshotHeader) == 44, "snapshot header layout changed");
+static_assert(sizeof(SystemRecord) == 12, "snapshot system layout changed");
+static_assert(sizeof(DeviceRecord) == 20, "snapshot device layout changed");
+static_assert(sizeof(RuleRecord) == 28, "snapshot rule layout changed");
+static_assert(sizeof(ConditionRecord) == 12, "snapshot condition layout changed");
+static_assert(sizeof(ActionRecord) == 12, "snapshot action layout changed");
+
+// Construction de la table de chaînes, sans doublons
+class StringTable {
+public:
+  bool add(const String& value, uint16_t& offset) {
+    auto found = _offsets.find(value);
+    if (found != _offsets.end()) {
+      offset = found->second;
+      return true;
+    }
+    if (_data.size() + value.length() + 1 > 0xFFFF) return false;
+    offset = _data.size();
+    _data.insert(_data.end(), value.c_str(), value.c_str() + value.length() + 1);
+    _offsets[value] = offset;
+    return true;
+  }
+
+  const std::vector<char>& data() const { return _data; }
+
+private:
+  std::vector<char> _data;
+  std::map<String, uint16_t> _offsets;
+};
+
+// Lecture d'un tableau d'enregistrements : copie vers une structure alignée
+template <typename T>
+T recordAt(const uint8_t* base, size_t index) {
+  T record;
+  memcpy(&record, base + index * sizeof(T), sizeof(T));
+  return record;
+}
+
+template <typename T>
+void appendRecord(std::vector<uint8_t>& out, const T& record) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&record);
+  out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+}
+
+String Config::snapshotPath(const String& filename) {
+  int dot = filename.lastIndexOf('.');
+  return (dot > 0 ? filename.substring(0, dot) : filename) + ".bin";
+}
+
+bool Config::hashFile(const String& filename, uint32_t& hash, uint32_t& size) {
+  File file = SPIFFS.open(filename, "r");
+  if (!file) return false;
+
+  uint8_t buffer[256];
+  hash = 2166136261u;
+  size = 0;
+  for (;;) {
+    int count = file.read(buffer, sizeof(buffer));
+    if (count <= 0) break;
+    for (int i = 0; i < count; i++) {
+      hash = (hash ^ buffer[i]) * 16777619u;
+    }
+    size += count;
+  }
+  file.close();
+  return true;
+}
+
+bool Config::loadSnapshot(const String& path, uint32_t sourceHash, uint32_t sourceSize) {
+  File file = SPIFFS.open(path, "r");
+  if (!file) return false;
+
+  size_t fileSize = file.size();
+  if (fileSize < sizeof(SnapshotHeader)) {
+    file.close();
+    return false;
+  }
+
+  // Une seule lecture pour tout l'instantané
+  std::unique_ptr<uint8_t[]> buffer(new (std::nothrow) uint8_t[fileSize]);
+  if (!buffer) {
+    file.close();
+    return false;
+  }
+  size_t read = file.read(buffer.get(), fileSize);
+  file.close();
+  if (read != fileSize) return false;
+
+  SnapshotHeader header = recordAt<SnapshotHeader>(buffer.get(), 0);
+  if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION) {
+    LOG_I("Config snapshot: unknown format, rebuilding");
+    return false;
+  }
+  if (header.sourceHash != sourceHash || header.sourceSize != sourceSize) {
+    LOG_I("Config snapshot: JSON changed, rebuilding");
+    return false;
+  }
+
+  const uint8_t* payload = buffer.get() + sizeof(SnapshotHeader);
+  size_t expected = sizeof(SystemRecord) +
+                    header.deviceCount * sizeof(DeviceRecord) +
+                    header.ruleCount * sizeof(RuleRecord) +
+                    header.conditionCount * sizeof(ConditionRecord) +
+                    header.actionCount * sizeof(ActionRecord) +
+                    header.dayCount * sizeof(uint16_t) +
+                    header.stringBytes;
+  if (header.payloadSize != expected || fileSize != sizeof(SnapshotHeader) + expected ||
+      header.payloadCrc != esp_rom_crc32_le(0, payload, header.payloadSize)) {
+    LOG_W("Config snapshot: corrupted, rebuilding");
+    return false;
+  }
+
+  const uint8_t* systemBase = payload;
+  const uint8_t* deviceBase = systemBase + sizeof(SystemRecord);
+  const uint8_t* ruleBase = deviceBase + header.deviceCount * sizeof(DeviceRecord);
+  const uint8_t* conditionBase = ruleBase + header.ruleCount * sizeof(RuleRecord);
+  const uint8_t* actionBase = conditionBase + header.conditionCount * sizeof(ConditionRecord);
+  const uint8_t* dayBase = actionBase + header.actionCount * sizeof(ActionRecord);
+  const char* strings = reinterpret_cast<const char*>(dayBase + header.dayCount * sizeof(uint16_t));
+
+  // Table terminée par un zéro : une position valide donne toujours une chaîne bornée
+  if (header.stringBytes == 0 || strings[header.stringBytes - 1] != '\0') return false;
+  if (header.sensorSlotCount > MAX_SENSOR_SLOTS || header.actuatorSlotCount > MAX_ACTUATOR_SLOTS) return false;
+
+  // Arène dimensionnée d'après l'en-tête ; les chaînes partagées dans la
+  // table sont recopiées à chaque usage
+  ConfigExtent extent;
+  extent.devices = header.deviceCount;
+  extent.rules = header.ruleCount;
+  extent.conditions = header.conditionCount;
+  extent.actions = header.actionCount;
+  extent.days = header.dayCount;
+  auto textBytes = [&](uint16_t offset) -> size_t {
+    size_t length = offset < header.stringBytes ? strlen(strings + offset) : 0;
+    return length ? length + 1 : 0;
+  };
+  SystemRecord systemRecord = recordAt<SystemRecord>(systemBase, 0);
+  extent.textBytes = textBytes(systemRecord.ssid) + textBytes(systemRecord.wifiPassword) +
+                     textBytes(systemRecord.username) + textBytes(systemRecord.password) +
+                     textBytes(systemRecord.rootPassword);
+  for (size_t i = 0; i < header.deviceCount; i++) {
+    extent.textBytes += textBytes(recordAt<DeviceRecord>(deviceBase, i).name);
+  }
+  for (size_t i = 0; i < header.ruleCount; i++) {
+    RuleRecord record = recordAt<RuleRecord>(ruleBase, i);
+    extent.textBytes += textBytes(record.name) + textBytes(record.startTime) + textBytes(record.endTime);
+  }
+
+  Config loaded(extent.arenaBytes());
+  ConfigArena& arena = *loaded._arena;
+  bool valid = true;
+  auto text = [&](uint16_t offset) -> const char* {
+    if (offset >= header.stringBytes) {
+      valid = false;
+      return "";
+    }
+    return arena.copy(strings + offset);
+  };
+  auto symbol = [&](uint16_t offset) -> Symbol {
+    if (offset >= header.stringBytes) {
+      valid = false;
+      return SYM_EMPTY;
+    }
+    return symbols.intern(strings + offset);
+  };
+  auto slice = [&](uint16_t first, uint16_t count, uint16_t total) {
+    if ((uint32_t)first + count > total) valid = false;
+    return valid;
+  };
+
+  loaded.system.wifi.ssid = text(systemRecord.ssid);
+  loaded.system.wifi.password = text(systemRecord.wifiPassword);
+  loaded.system.auth.username = text(systemRecord.username);
+  loaded.system.auth.password = text(systemRecord.password);
+  loaded.system.auth.rootPassword = text(systemRecord.rootPassword);
+  loaded.system.captivePortal = systemRecord.captivePortal;
+
+  loaded.devices.reserve(header.deviceCount);
+  for (size_t i = 0; i < header.deviceCount; i++) {
+    DeviceRecord record = recordAt<DeviceRecord>(deviceBase, i);
+    DeviceConfig device;
+    device.id = symbol(record.id);
+    device.name = text(record.name);
+    device.type = symbol(record.type);
+    device.sensorType = symbol(record.sensorType);
+    device.actuatorType = symbol(record.actuatorType);
+    device.pin = record.pin;
+    device.enabled = record.enabled;
+    device.readInterval = record.readInterval;
+    device.state = record.state;
+    device.slot = record.slot;
+    loaded.devices.push_back(device);
+  }
+  loaded.sensorSlotCount = header.sensorSlotCount;
+  loaded.actuatorSlotCount = header.actuatorSlotCount;
+
+  loaded.rules.reserve(header.ruleCount);
+  for (size_t i = 0; i < header.ruleCount && valid; i++) {
+    RuleRecord record = recordAt<RuleRecord>(ruleBase, i);
+    loaded.rules.emplace_back(&arena);
+    RuleConfig& rule = loaded.rules.back();
+    rule.id = symbol(record.id);
+    rule.name = text(record.name);
+    rule.enabled = record.enabled;
+    rule.triggerType = symbol(record.triggerType);
+    rule.schedule.startTime = text(record.startTime);
+    rule.schedule.endTime = text(record.endTime);
+
+    if (!slice(record.firstCondition, record.conditionCount, header.conditionCount) ||
+        !slice(record.firstDeactivation, record.deactivationCount, header.conditionCount) ||
+        !slice(record.firstAction, record.actionCount, header.actionCount) ||
+        !slice(record.firstDay, record.dayCount, header.dayCount)) {
+      break;
+    }
+
+    uint16_t first[2] = { record.firstCondition, record.firstDeactivation };
+    uint16_t count[2] = { record.conditionCount, record.deactivationCount };
+    ArenaVector<Condition>* targets[2] = { &rule.conditions, &rule.deactivationConditions };
+    for (int part = 0; part < 2; part++) {
+      targets[part]->reserve(count[part]);
+      for (uint16_t c = first[part]; c < first[part] + count[part]; c++) {
+        ConditionRecord conditionRecord = recordAt<ConditionRecord>(conditionBase, c);
+        Condition condition;
+        condition.sensorId = symbol(conditionRecord.sensorId);
+        condition.parameter = symbol(conditionRecord.parameter);
+        condition.operator_ = symbol(conditionRecord.operator_);
+        condition.value = conditionRecord.value;
+        condition.logic = symbol(conditionRecord.logic);
+        targets[part]->push_back(condition);
+      }
+    }
+
+    rule.actions.reserve(record.actionCount);
+    for (uint16_t a = record.firstAction; a < record.firstAction + record.actionCount; a++) {
+      ActionRecord actionRecord = recordAt<ActionRecord>(actionBase, a);
+      Action action;
+      action.actuatorId = symbol(actionRecord.actuatorId);
+      action.action = symbol(actionRecord.action);
+      action.duration = actionRecord.duration;
+      action.pattern = symbol(actionRecord.pattern);
+      rule.actions.push_back(action);
+    }
+
+    rule.schedule.days.reserve(record.dayCount);
+    for (uint16_t d = record.firstDay; d < record.firstDay + record.dayCount; d++) {
+      rule.schedule.days.push_back(symbol(recordAt<uint16_t>(dayBase, d)));
+    }
+  }
+
+  if (!valid) {
+    LOG_W("Config snapshot: inconsistent, rebuilding");
+    return false;
+  }
+
+  loaded.compileRules();
+  // L'ancienne configuration part avec loaded
+  swap(loaded);
+  return true;
+}
+
+bool Config::saveSnapshot(const String& path, uint32_t sourceHash, uint32_t sourceSize) const {
+  StringTable strings;
+  std::vector<uint8_t> devicesOut, rulesOut, conditionsOut, actionsOut, daysOut;
+  bool ok = true;
+  uint16_t conditionCount = 0, actionCount = 0, dayCount = 0;
+
+  SystemRecord systemRecord = {};
+  ok &= strings.add(system.wifi.ssid, systemRecord.ssid);
+  ok &= strings.add(system.wifi.password, systemRecord.wifiPassword);
+  ok &= strings.add(system.auth.username, systemRecord.username);
+  ok &= strings.add(system.auth.password, systemRecord.password);
+  ok &= strings.add(system.auth.rootPassword, systemRecord.rootPassword);
+  systemRecord.captivePortal = system.captivePortal;
+
+  for (const auto& device : devices) {
+    DeviceRecord record = {};
+    ok &= strings.add(symbols.text(device.id), record.id);
+    ok &= strings.add(device.name, record.name);
+    ok &= strings.add(symbols.text(device.type), record.type);
+    ok &= strings.add(symbols.text(device.sensorType), record.sensorType);
+    ok &= strings.add(symbols.text(device.actuatorType), record.actuatorType);
+    record.pin = device.pin;
+    record.enabled = device.enabled;
+    record.readInterval = device.readInterval;
+    record.state = device.state;
+    record.slot = device.slot;
+    appendRecord(devicesOut, record);
+  }
+
+  for (const auto& rule : rules) {
+    RuleRecord record = {};
+    ok &= strings.add(symbols.text(rule.id), record.id);
+    ok &= strings.add(rule.name, record.name);
+    ok &= strings.add(symbols.text(rule.triggerType), record.triggerType);
+    ok &= strings.add(rule.schedule.startTime, record.startTime);
+    ok &= strings.add(rule.schedule.endTime, record.endTime);
+    record.enabled = rule.enabled;
+
+    const ArenaVector<Condition>* sources[2] = { &rule.conditions, &rule.deactivationConditions };
+    uint16_t* firsts[2] = { &record.firstCondition, &record.firstDeactivation };
+    uint16_t* counts[2] = { &record.conditionCount, &record.deactivationCount };
+    for (int part = 0; part < 2; part++) {
+      *firsts[part] = conditionCount;
+      *counts[part] = sources[part]->size();
+      for (const auto& condition : *sources[part]) {
+        ConditionRecord conditionRecord = {};
+        conditionRecord.value = condition.value;
+        ok &= strings.add(symbols.text(condition.sensorId), conditionRecord.sensorId);
+        ok &= strings.add(symbols.text(condition.parameter), conditionRecord.parameter);
+        ok &= strings.add(symbols.text(condition.operator_), conditionRecord.operator_);
+        ok &= strings.add(symbols.text(condition.logic), conditionRecord.logic);
+        appendRecord(conditionsOut, conditionRecord);
+        conditionCount++;
+      }
+    }
+
+    record.firstAction = actionCount;
+    record.actionCount = rule.actions.size();
+    for (const auto& action : rule.actions) {
+      ActionRecord actionRecord = {};
+      actionRecord.duration = action.duration;
+      ok &= strings.add(symbols.text(action.actuatorId), actionRecord.actuatorId);
+      ok &= strings.add(symbols.text(action.action), actionRecord.action);
+      ok &= strings.add(symbols.text(action.pattern), actionRecord.pattern);
+      appendRecord(actionsOut, actionRecord);
+      actionCount++;
+    }
+
+    record.firstDay = dayCount;
+    record.dayCount = rule.schedule.days.size();
+    for (Symbol day : rule.schedule.days) {
+      uint16_t offset = 0;
+      ok &= strings.add(symbols.text(day), offset);
+      appendRecord(daysOut, offset);
+      dayCount++;
+    }
+
+    appendRecord(rulesOut, record);
+  }
+
+  if (!ok || devices.size() > 0xFFFF || rules.size() > 0xFFFF) {
+    LOG_W("Config snapshot: configuration too large, not saved");
+    return false;
+  }
+
+  std::vector<uint8_t> payload;
+  payload.reserve(sizeof(SystemRecord) + devicesOut.size() + rulesOut.size() + conditionsOut.size() +
+                  actionsOut.size() + daysOut.size() + strings.data().size());
+  appendRecord(payload, systemRecord);
+  payload.insert(payload.end(), devicesOut.begin(), devicesOut.end());
+  payload.insert(payload.end(), rulesOut.begin(), rulesOut.end());
+  payload.insert(payload.end(), conditionsOut.begin(), conditionsOut.end());
+  payload.insert(payload.end(), actionsOut.begin(), actionsOut.end());
+  payload.insert(payload.end(), daysOut.begin(), daysOut.end());
+  payload.insert(payload.end(), strings.data().begin(), strings.data().end());
+
+  SnapshotHeader header = {};
+  header.magic = SNAPSHOT_MAGIC;
+  header.version = SNAPSHOT_VERSION;
+  header.sourceHash = sourceHash;
+  header.sourceSize = sourceSize;
+  header.payloadSize = payload.size();
+  header.payloadCrc = esp_rom_crc32_le(0, payload.data(), payload.size());
+  header.deviceCount = devices.size();
+  header.ruleCount = rules.size();
+  header.conditionCount = conditionCount;
+  header.actionCount = actionCount;
+  header.dayCount = dayCount;
+  header.sensorSlotCount = sensorSlotCount;
+  header.actuatorSlotCount = actuatorSlotCount;
+  header.stringBytes = strings.data().size();
+
+  File file = SPIFFS.open(path, "w");
+  if (!file) {
+    LOG_W("Config snapshot: cannot write %s", path.c_str());
+    return false;
+  }
+  // Écriture interrompue : détectée au prochain démarrage par la taille et le CRC
+  bool written = file.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header)) == sizeof(header) &&
+                 file.write(payload.data(), payload.size()) == payload.size();
+  file.close();
+
+  if (!written) {
+    SPIFFS.remove(path);
+    return false;
+  }
+  LOG_I("Config snapshot saved: %u bytes", (unsigned)(sizeof(header) + payload.size()));
+  return true;
+}
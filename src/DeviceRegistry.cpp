@@ -0,0 +1,45 @@
+#include "DeviceRegistry.h"
+
+// Taille des réserves : nombre maximal de dispositifs actifs par modèle. Le
+// DHT11 est borné par les canaux RMT, les autres par l'usage courant d'une
+// installation ; la mémoire est réservée même pour les modèles absents.
+// Au-delà, les dispositifs d'un modèle sont ignorés au chargement.
+const SensorDriver sensorDrivers[] = {
+  deviceDriver<BaseSensor, DHT11Sensor, 4 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseSensor, MQ2Sensor, 4 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseSensor, ASCSensor, 4 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseSensor, LDRSensor, 4 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseSensor, PIRSensor, 4 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseSensor, ButtonSensor, 8 * DEVICE_POOL_SCALE>(),
+};
+const size_t sensorDriverCount = sizeof(sensorDrivers) / sizeof(sensorDrivers[0]);
+
+const ActuatorDriver actuatorDrivers[] = {
+  deviceDriver<BaseActuator, RelayActuator, 8 * DEVICE_POOL_SCALE>(),
+  deviceDriver<BaseActuator, BuzzerActuator, 4 * DEVICE_POOL_SCALE>(),
+};
+const size_t actuatorDriverCount = sizeof(actuatorDrivers) / sizeof(actuatorDrivers[0]);
+
+const SensorDriver* findSensorDriver(Symbol model) {
+  for (size_t i = 0; i < sensorDriverCount; i++) {
+    if (sensorDrivers[i].model == model) return &sensorDrivers[i];
+  }
+  return nullptr;
+}
+
+const ActuatorDriver* findActuatorDriver(Symbol model) {
+  for (size_t i = 0; i < actuatorDriverCount; i++) {
+    if (actuatorDrivers[i].model == model) return &actuatorDrivers[i];
+  }
+  return nullptr;
+}
+
+void destroySensor(BaseSensor* sensor) {
+  const SensorDriver* driver = findSensorDriver(sensor->getModel());
+  if (driver) driver->destroy(sensor);
+}
+
+void destroyActuator(BaseActuator* actuator) {
+  const ActuatorDriver* driver = findActuatorDriver(actuator->getModel());
+  if (driver) driver->destroy(actuator);
+}
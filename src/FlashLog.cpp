@@ -0,0 +1,210 @@
+#include "FlashLog.h"
+#include <esp_rom_crc.h>
+#include <esp_spi_flash.h>
+#include "Log.h"
+
+namespace {
+
+const uint16_t PAGE_MAGIC = 0x4C53; // "SL"
+const uint16_t ERASED_MAGIC = 0xFFFF;
+
+// Type (1), longueur (1), horodatage (4)
+const size_t RECORD_HEADER = 6;
+
+static_assert(SPI_FLASH_SEC_SIZE % FLASH_LOG_PAGE_SIZE == 0, "FLASH_LOG_PAGE_SIZE must divide the flash sector size");
+
+}
+
+FlashLog::FlashLog()
+  : _partition(nullptr), _segmentCount(0), _pagesPerSegment(0), _writePage(0), _sequence(0),
+    _boot(0), _pagesWritten(0), _corruptPages(0), _pageLength(0), _pageStarted(0) {
+}
+
+bool FlashLog::begin(const char* label) {
+  const esp_partition_t* partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+  if (!partition || partition->size < 2 * SPI_FLASH_SEC_SIZE) {
+    LOG_E("FlashLog: partition '%s' not found", label);
+    return false;
+  }
+  _partition = partition;
+  _pagesPerSegment = SPI_FLASH_SEC_SIZE / FLASH_LOG_PAGE_SIZE;
+  _segmentCount = partition->size / SPI_FLASH_SEC_SIZE;
+
+  // Segment courant : celui dont la première page a la plus grande séquence
+  const PageHeader* header = reinterpret_cast<const PageHeader*>(_page);
+  int head = -1;
+  uint32_t lastSequence = 0;
+  uint32_t lastBoot = 0;
+  for (size_t segment = 0; segment < _segmentCount; segment++) {
+    if (!readPage(segment * _pagesPerSegment, _page)) continue;
+    if (head < 0 || header->sequence > lastSequence) {
+      head = segment;
+      lastSequence = header->sequence;
+      lastBoot = header->boot;
+    }
+  }
+
+  if (head < 0) {
+    // Partition vierge ou illisible : on repart du début
+    _writePage = 0;
+    _sequence = 1;
+    _boot = 1;
+  } else {
+    // Position d'écriture : première page effacée du segment courant ;
+    // une page illisible (écriture interrompue par une coupure) est sautée
+    size_t first = head * _pagesPerSegment;
+    _writePage = (first + _pagesPerSegment) % (_segmentCount * _pagesPerSegment);
+    for (size_t page = first + 1; page < first + _pagesPerSegment; page++) {
+      if (isErased(page)) {
+        _writePage = page;
+        break;
+      }
+      if (!readPage(page, _page)) {
+        _corruptPages++;
+        continue;
+      }
+      if (header->sequence > lastSequence) {
+        lastSequence = header->sequence;
+        lastBoot = header->boot;
+      }
+    }
+    _sequence = lastSequence + 1;
+    _boot = lastBoot + 1;
+  }
+
+  _pageLength = 0;
+  LOG_I("FlashLog: %u segments, boot %u, next page %u (seq %u)",
+        (unsigned)_segmentCount, (unsigned)_boot, (unsigned)_writePage, (unsigned)_sequence);
+  return true;
+}
+
+bool FlashLog::append(FlashRecordType type, uint32_t time, const void* data, uint8_t length) {
+  size_t size = RECORD_HEADER + length;
+  if (!_partition || size > PAGE_DATA) return false;
+
+  if (_pageLength + size > PAGE_DATA && !flush()) return false;
+  if (_pageLength == 0) _pageStarted = millis();
+
+  uint8_t* out = _page + sizeof(PageHeader) + _pageLength;
+  out[0] = (uint8_t)type;
+  out[1] = length;
+  memcpy(out + 2, &time, sizeof(time));
+  memcpy(out + RECORD_HEADER, data, length);
+  _pageLength += size;
+  return true;
+}
+
+void FlashLog::loop(uint32_t now) {
+  if (_pageLength > 0 && now - _pageStarted >= FLASH_LOG_FLUSH_MS) {
+    flush();
+  }
+}
+
+bool FlashLog::flush() {
+  if (!_partition || _pageLength == 0) return true;
+
+  // Entrée dans un nouveau segment : effacement du plus ancien (rétention)
+  size_t offset = _writePage * FLASH_LOG_PAGE_SIZE;
+  bool ok = true;
+  if (_writePage % _pagesPerSegment == 0) {
+    ok = esp_partition_erase_range(_partition, offset, SPI_FLASH_SEC_SIZE) == ESP_OK;
+  }
+
+  PageHeader* header = reinterpret_cast<PageHeader*>(_page);
+  header->magic = PAGE_MAGIC;
+  header->length = _pageLength;
+  header->sequence = _sequence;
+  header->boot = _boot;
+  header->crc = pageCrc(_page);
+  memset(_page + sizeof(PageHeader) + _pageLength, 0xFF, PAGE_DATA - _pageLength);
+
+  if (ok) {
+    ok = esp_partition_write(_partition, offset, _page, FLASH_LOG_PAGE_SIZE) == ESP_OK;
+  }
+  if (!ok) {
+    LOG_E("FlashLog: write failed at page %u", (unsigned)_writePage);
+  }
+
+  // La page est abandonnée en cas d'échec plutôt que réessayée indéfiniment
+  _writePage = (_writePage + 1) % (_segmentCount * _pagesPerSegment);
+  _sequence++;
+  _pageLength = 0;
+  if (ok) _pagesWritten++;
+  return ok;
+}
+
+size_t FlashLog::read(FlashRecordVisitor visitor, void* context) const {
+  if (!_partition) return 0;
+
+  size_t totalPages = _segmentCount * _pagesPerSegment;
+  alignas(4) uint8_t buffer[FLASH_LOG_PAGE_SIZE];
+  const PageHeader* header = reinterpret_cast<const PageHeader*>(buffer);
+  size_t visited = 0;
+
+  // Le plus ancien segment suit le segment courant ; si la prochaine page
+  // ouvre un segment, c'est lui le plus ancien (pas encore effacé)
+  size_t start = _writePage - _writePage % _pagesPerSegment;
+  if (_writePage % _pagesPerSegment != 0) start = (start + _pagesPerSegment) % totalPages;
+
+  for (size_t n = 0; n < totalPages; n++) {
+    size_t page = (start + n) % totalPages;
+    if (!readPage(page, buffer)) continue;
+    visited += visitRecords(buffer + sizeof(PageHeader), header->length, header->boot, visitor, context);
+  }
+
+  // Enregistrements pas encore écrits
+  visited += visitRecords(_page + sizeof(PageHeader), _pageLength, _boot, visitor, context);
+  return visited;
+}
+
+size_t FlashLog::capacity() const {
+  return _segmentCount * SPI_FLASH_SEC_SIZE;
+}
+
+bool FlashLog::readPage(size_t page, uint8_t* buffer) const {
+  if (esp_partition_read(_partition, page * FLASH_LOG_PAGE_SIZE, buffer, FLASH_LOG_PAGE_SIZE) != ESP_OK) {
+    return false;
+  }
+  const PageHeader* header = reinterpret_cast<const PageHeader*>(buffer);
+  if (header->magic != PAGE_MAGIC || header->length > PAGE_DATA) return false;
+  return header->crc == pageCrc(buffer);
+}
+
+bool FlashLog::isErased(size_t page) const {
+  alignas(4) uint8_t buffer[FLASH_LOG_PAGE_SIZE];
+  if (esp_partition_read(_partition, page * FLASH_LOG_PAGE_SIZE, buffer, FLASH_LOG_PAGE_SIZE) != ESP_OK) {
+    return false;
+  }
+  if (reinterpret_cast<const PageHeader*>(buffer)->magic != ERASED_MAGIC) return false;
+  for (size_t i = 0; i < FLASH_LOG_PAGE_SIZE; i++) {
+    if (buffer[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+uint32_t FlashLog::pageCrc(const uint8_t* page) {
+  const PageHeader* header = reinterpret_cast<const PageHeader*>(page);
+  uint32_t crc = esp_rom_crc32_le(0, page, offsetof(PageHeader, crc));
+  return esp_rom_crc32_le(crc, page + sizeof(PageHeader), header->length);
+}
+
+size_t FlashLog::visitRecords(const uint8_t* data, size_t length, uint32_t boot,
+                              FlashRecordVisitor visitor, void* context) {
+  size_t pos = 0;
+  size_t visited = 0;
+
+  while (pos + RECORD_HEADER <= length) {
+    FlashRecord record;
+    record.boot = boot;
+    record.type = (FlashRecordType)data[pos];
+    record.length = data[pos + 1];
+    memcpy(&record.time, data + pos + 2, sizeof(record.time));
+    record.data = data + pos + RECORD_HEADER;
+    if (pos + RECORD_HEADER + record.length > length) break;
+
+    visitor(record, context);
+    visited++;
+    pos += RECORD_HEADER + record.length;
+  }
+  return visited;
+}
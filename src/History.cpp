@@ -0,0 +1,381 @@
+#include "History.h"
+#include <new>
+
+namespace {
+
+const int BLOCK_BITS = HISTORY_BLOCK_SIZE * 8;
+static_assert(BLOCK_BITS <= 0xFFFF, "HISTORY_BLOCK_SIZE too large for a 16-bit bit count");
+
+// Recul d'horodatage interprété comme un rebouclage de millis()
+const uint32_t WRAP_THRESHOLD = 86400000UL;
+
+// Fenêtre XOR pas encore définie dans le bloc
+const uint8_t NO_WINDOW = 0xFF;
+
+const uint8_t tierBlocks[HISTORY_TIERS] = {
+  HISTORY_RAW_BLOCKS, HISTORY_MINUTE_BLOCKS, HISTORY_QUARTER_BLOCKS, HISTORY_HOUR_BLOCKS
+};
+
+// Écriture bit à bit (poids fort d'abord) ; ok passe à false si le bloc déborde
+struct BitWriter {
+  uint8_t* data;
+  uint32_t pos;
+  bool ok;
+
+  void write(uint32_t value, int count) {
+    if (pos + count > (uint32_t)BLOCK_BITS) {
+      ok = false;
+      return;
+    }
+    for (int i = count - 1; i >= 0; i--) {
+      uint8_t mask = 0x80 >> (pos & 7);
+      if ((value >> i) & 1) data[pos >> 3] |= mask;
+      else data[pos >> 3] &= ~mask;
+      pos++;
+    }
+  }
+};
+
+struct BitReader {
+  const uint8_t* data;
+  uint32_t pos;
+
+  uint32_t read(int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; i++) {
+      value = (value << 1) | ((data[pos >> 3] >> (7 - (pos & 7))) & 1);
+      pos++;
+    }
+    return value;
+  }
+};
+
+uint32_t floatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bitsFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+}
+
+History::History() : _series(nullptr), _seriesCount(0), _pool(nullptr), _poolBlocks(0) {
+}
+
+History::~History() {
+  delete[] _series;
+  delete[] _pool;
+}
+
+bool History::begin(size_t seriesCount) {
+  if (_series || seriesCount == 0) return false;
+  if (seriesCount > HISTORY_MAX_SERIES) seriesCount = HISTORY_MAX_SERIES;
+
+  size_t blocksPerSeries = 0;
+  for (int tier = 0; tier < HISTORY_TIERS; tier++) blocksPerSeries += tierBlocks[tier];
+
+  _series = new (std::nothrow) Series[seriesCount];
+  _pool = new (std::nothrow) Block[seriesCount * blocksPerSeries];
+  if (!_series || !_pool) {
+    delete[] _series;
+    delete[] _pool;
+    _series = nullptr;
+    _pool = nullptr;
+    return false;
+  }
+
+  _seriesCount = seriesCount;
+  _poolBlocks = seriesCount * blocksPerSeries;
+  for (size_t i = 0; i < _poolBlocks; i++) {
+    _pool[i].bits = 0;
+    _pool[i].count = 0;
+  }
+
+  Block* next = _pool;
+  for (size_t i = 0; i < seriesCount; i++) {
+    for (int tier = 0; tier < HISTORY_TIERS; tier++) {
+      Ring& ring = _series[i].rings[tier];
+      ring.blocks = next;
+      ring.capacity = tierBlocks[tier];
+      ring.head = 0;
+      ring.used = 1;
+      next += ring.capacity;
+
+      _series[i].rollups[tier].count = 0;
+    }
+  }
+  return true;
+}
+
+uint32_t History::period(HistoryTier tier) {
+  switch (tier) {
+    case HistoryTier::MINUTE:  return 60000UL;
+    case HistoryTier::QUARTER: return 900000UL;
+    case HistoryTier::HOUR:    return 3600000UL;
+    default:                   return 0;
+  }
+}
+
+void History::record(int series, uint32_t timestamp, float value) {
+  if (series < 0 || (size_t)series >= _seriesCount || isnan(value)) return;
+  Series& s = _series[series];
+
+  // Horodatages strictement croissants, sinon l'encodage delta est faussé ;
+  // après le rebouclage de millis() (~49 jours), la série repart de zéro
+  Ring& raw = s.rings[0];
+  if ((raw.used > 1 || raw.blocks[raw.head].count > 0) && timestamp <= raw.encoder.lastTime) {
+    if (raw.encoder.lastTime - timestamp < WRAP_THRESHOLD) return;
+    clear(s);
+  }
+
+  append(raw, 1, timestamp, &value);
+  accumulate(s, 1, timestamp, value, value, value, 1);
+}
+
+void History::reset(int series) {
+  if (series < 0 || (size_t)series >= _seriesCount) return;
+  clear(_series[series]);
+}
+
+void History::clear(Series& series) {
+  for (int tier = 0; tier < HISTORY_TIERS; tier++) {
+    Ring& ring = series.rings[tier];
+    ring.head = 0;
+    ring.used = 1;
+    ring.blocks[0].bits = 0;
+    ring.blocks[0].count = 0;
+    series.rollups[tier].count = 0;
+  }
+}
+
+void History::accumulate(Series& series, int tier, uint32_t timestamp, float min, float max, float sum, uint32_t count) {
+  Rollup& rollup = series.rollups[tier];
+  uint32_t length = period((HistoryTier)tier);
+  uint32_t bucket = timestamp / length;
+
+  // Intervalle terminé : enregistré à ce niveau et remonté au suivant
+  if (rollup.count > 0 && bucket != rollup.bucket) {
+    uint32_t start = rollup.bucket * length;
+    float data[3] = { rollup.min, rollup.max, rollup.sum / rollup.count };
+    append(series.rings[tier], 3, start, data);
+    if (tier + 1 < HISTORY_TIERS) {
+      accumulate(series, tier + 1, start, rollup.min, rollup.max, rollup.sum, rollup.count);
+    }
+    rollup.count = 0;
+  }
+
+  if (rollup.count == 0) {
+    rollup.bucket = bucket;
+    rollup.min = min;
+    rollup.max = max;
+    rollup.sum = sum;
+    rollup.count = count;
+  } else {
+    if (min < rollup.min) rollup.min = min;
+    if (max > rollup.max) rollup.max = max;
+    rollup.sum += sum;
+    rollup.count += count;
+  }
+}
+
+void History::append(Ring& ring, int values, uint32_t timestamp, const float* data) {
+  Block& block = ring.blocks[ring.head];
+  Encoder saved = ring.encoder;
+  uint16_t bits = block.bits;
+
+  if (encode(block, ring.encoder, values, timestamp, data)) return;
+
+  // Bloc plein : on annule l'écriture partielle et on passe au suivant,
+  // qui écrase le plus ancien une fois l'anneau rempli
+  ring.encoder = saved;
+  block.bits = bits;
+  ring.head = (ring.head + 1) % ring.capacity;
+  if (ring.used < ring.capacity) ring.used++;
+
+  Block& next = ring.blocks[ring.head];
+  next.bits = 0;
+  next.count = 0;
+  encode(next, ring.encoder, values, timestamp, data);
+}
+
+bool History::encode(Block& block, Encoder& encoder, int values, uint32_t timestamp, const float* data) {
+  BitWriter writer = { block.data, block.bits, true };
+
+  if (block.count == 0) {
+    // Premier point : horodatage dans l'en-tête, valeurs en clair
+    block.firstTime = timestamp;
+    encoder.lastTime = timestamp;
+    encoder.lastDelta = 0;
+    for (int i = 0; i < values; i++) {
+      encoder.lastValues[i] = floatBits(data[i]);
+      encoder.leading[i] = NO_WINDOW;
+      encoder.trailing[i] = 0;
+      writer.write(encoder.lastValues[i], 32);
+    }
+  } else {
+    // Horodatage : delta-de-delta, nul pour une période régulière
+    int32_t delta = (int32_t)(timestamp - encoder.lastTime);
+    int32_t dod = delta - encoder.lastDelta;
+    if (dod == 0) {
+      writer.write(0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+      writer.write(0x2, 2);
+      writer.write(dod + 63, 7);
+    } else if (dod >= -255 && dod <= 256) {
+      writer.write(0x6, 3);
+      writer.write(dod + 255, 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+      writer.write(0xE, 4);
+      writer.write(dod + 2047, 12);
+    } else {
+      writer.write(0xF, 4);
+      writer.write((uint32_t)dod, 32);
+    }
+    encoder.lastTime = timestamp;
+    encoder.lastDelta = delta;
+
+    // Valeurs : XOR avec la précédente, seuls les bits significatifs sont
+    // écrits, dans la fenêtre précédente quand ils y tiennent
+    for (int i = 0; i < values; i++) {
+      uint32_t bits = floatBits(data[i]);
+      uint32_t diff = bits ^ encoder.lastValues[i];
+      encoder.lastValues[i] = bits;
+
+      if (diff == 0) {
+        writer.write(0, 1);
+        continue;
+      }
+
+      uint8_t leading = __builtin_clz(diff);
+      uint8_t trailing = __builtin_ctz(diff);
+      if (leading > 31) leading = 31;
+
+      if (encoder.leading[i] != NO_WINDOW && leading >= encoder.leading[i] && trailing >= encoder.trailing[i]) {
+        int length = 32 - encoder.leading[i] - encoder.trailing[i];
+        writer.write(0x2, 2);
+        writer.write(diff >> encoder.trailing[i], length);
+      } else {
+        int length = 32 - leading - trailing;
+        writer.write(0x3, 2);
+        writer.write(leading, 5);
+        writer.write(length - 1, 5);
+        writer.write(diff >> trailing, length);
+        encoder.leading[i] = leading;
+        encoder.trailing[i] = trailing;
+      }
+    }
+  }
+
+  if (!writer.ok) return false;
+  block.bits = writer.pos;
+  block.count++;
+  return true;
+}
+
+size_t History::decode(const Block& block, int values, uint32_t from, uint32_t to,
+                       HistoryVisitor visitor, void* context) {
+  BitReader reader = { block.data, 0 };
+  uint32_t timestamp = block.firstTime;
+  int32_t delta = 0;
+  uint32_t last[3];
+  uint8_t leading[3] = { 0, 0, 0 };
+  uint8_t trailing[3] = { 0, 0, 0 };
+  size_t visited = 0;
+
+  for (uint16_t n = 0; n < block.count; n++) {
+    if (n == 0) {
+      for (int i = 0; i < values; i++) last[i] = reader.read(32);
+    } else {
+      int32_t dod;
+      if (reader.read(1) == 0) dod = 0;
+      else if (reader.read(1) == 0) dod = (int32_t)reader.read(7) - 63;
+      else if (reader.read(1) == 0) dod = (int32_t)reader.read(9) - 255;
+      else if (reader.read(1) == 0) dod = (int32_t)reader.read(12) - 2047;
+      else dod = (int32_t)reader.read(32);
+      delta += dod;
+      timestamp += delta;
+
+      for (int i = 0; i < values; i++) {
+        if (reader.read(1) == 0) continue;
+        if (reader.read(1) == 1) {
+          leading[i] = reader.read(5);
+          trailing[i] = 32 - leading[i] - (reader.read(5) + 1);
+        }
+        int length = 32 - leading[i] - trailing[i];
+        last[i] ^= reader.read(length) << trailing[i];
+      }
+    }
+
+    if (timestamp > to) break;
+    if (timestamp < from) continue;
+
+    HistoryPoint point;
+    point.timestamp = timestamp;
+    point.min = bitsFloat(last[0]);
+    point.max = values == 3 ? bitsFloat(last[1]) : point.min;
+    point.avg = values == 3 ? bitsFloat(last[2]) : point.min;
+    visitor(point, context);
+    visited++;
+  }
+  return visited;
+}
+
+size_t History::query(int series, HistoryTier tier, uint32_t from, uint32_t to,
+                      HistoryVisitor visitor, void* context) const {
+  if (series < 0 || (size_t)series >= _seriesCount) return 0;
+  const Ring& ring = _series[series].rings[(int)tier];
+  int values = tier == HistoryTier::RAW ? 1 : 3;
+  size_t visited = 0;
+
+  // Du bloc le plus ancien au bloc courant
+  int index = (ring.head + ring.capacity - ring.used + 1) % ring.capacity;
+  for (int n = 0; n < ring.used; n++) {
+    const Block& block = ring.blocks[index];
+    index = (index + 1) % ring.capacity;
+    if (block.count == 0) continue;
+    if (block.firstTime > to) break;
+
+    // Bloc entièrement antérieur à from : le suivant commence avant from
+    if (n + 1 < ring.used && ring.blocks[index].count > 0 && ring.blocks[index].firstTime <= from) {
+      continue;
+    }
+    visited += decode(block, values, from, to, visitor, context);
+  }
+  return visited;
+}
+
+HistoryTier History::tierFor(int series, uint32_t from, uint32_t step) const {
+  if (series < 0 || (size_t)series >= _seriesCount) return HistoryTier::RAW;
+
+  int best = -1;
+  for (int tier = 0; tier < HISTORY_TIERS; tier++) {
+    if (period((HistoryTier)tier) < step && tier + 1 < HISTORY_TIERS) continue;
+    if (best < 0) best = tier;
+
+    const Ring& ring = _series[series].rings[tier];
+    const Block& oldest = ring.blocks[(ring.head + ring.capacity - ring.used + 1) % ring.capacity];
+    if (oldest.count == 0) continue;
+
+    // Niveau non vide le plus grossier à défaut d'un niveau qui couvre from
+    best = tier;
+    if (oldest.firstTime <= from) break;
+  }
+  return (HistoryTier)best;
+}
+
+size_t History::capacity() const {
+  return _poolBlocks * sizeof(Block) + _seriesCount * sizeof(Series);
+}
+
+size_t History::used() const {
+  size_t bits = 0;
+  for (size_t i = 0; i < _poolBlocks; i++) {
+    bits += _pool[i].bits;
+  }
+  return bits / 8;
+}
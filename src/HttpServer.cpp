@@ -0,0 +1,905 @@
+#include "HttpServer.h"
+#include "Log.h"
+#include <lwip/sockets.h>
+#include <errno.h>
+#include <unistd.h>
+
+namespace {
+
+// Longueur inconnue : corps chunked (HTTP/1.1) ou délimité par la fermeture
+const size_t UNKNOWN_LENGTH = (size_t)-1;
+
+// Morceau dans _chunk : "XXXX\r\n" + données + "\r\n" (+ "0\r\n\r\n" final)
+const size_t CHUNK_PREFIX = 6;
+const size_t CHUNK_CAPACITY = HTTP_CHUNK_SIZE - CHUNK_PREFIX - 2 - 5;
+static_assert(CHUNK_CAPACITY <= 0xFFFF, "chunk size must fit in 4 hex digits");
+
+const char* statusText(int code) {
+  switch (code) {
+    case 200: return "OK";
+    case 204: return "No Content";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 401: return "Unauthorized";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 431: return "Request Header Fields Too Large";
+    case 500: return "Internal Server Error";
+    case 501: return "Not Implemented";
+    case 503: return "Service Unavailable";
+    default: return "";
+  }
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+String urlDecode(const String& text) {
+  String decoded;
+  decoded.reserve(text.length());
+
+  for (unsigned int i = 0; i < text.length(); i++) {
+    char c = text[i];
+    if (c == '+') {
+      decoded += ' ';
+    } else if (c == '%' && i + 2 < text.length() && hexValue(text[i + 1]) >= 0 && hexValue(text[i + 2]) >= 0) {
+      decoded += (char)((hexValue(text[i + 1]) << 4) | hexValue(text[i + 2]));
+      i += 2;
+    } else {
+      decoded += c;
+    }
+  }
+  return decoded;
+}
+
+String formatEvent(const char* event, const String& data) {
+  String text;
+  text.reserve(data.length() + 24);
+  text = "event: ";
+  text += event;
+  text += "\ndata: ";
+  text += data;
+  text += "\n\n";
+  return text;
+}
+
+// Motif de route : chaque "{}" correspond à un segment de chemin non vide,
+// recopié dans captures (comme UriBraces de WebServer)
+bool matchRoute(const String& pattern, const String& uri, std::vector<String>& captures) {
+  captures.clear();
+  unsigned int p = 0;
+  unsigned int u = 0;
+
+  while (p < pattern.length()) {
+    if (pattern[p] == '{' && p + 1 < pattern.length() && pattern[p + 1] == '}') {
+      int end = uri.indexOf('/', u);
+      if (end < 0) end = uri.length();
+      if ((unsigned int)end == u) return false;
+      captures.push_back(uri.substring(u, end));
+      u = end;
+      p += 2;
+    } else {
+      if (u >= uri.length() || pattern[p] != uri[u]) return false;
+      p++;
+      u++;
+    }
+  }
+  return u == uri.length();
+}
+
+bool parseMethod(const String& name, HTTPMethod& method, bool& headOnly) {
+  headOnly = false;
+  if (name == "GET") method = HTTP_GET;
+  else if (name == "POST") method = HTTP_POST;
+  else if (name == "PUT") method = HTTP_PUT;
+  else if (name == "PATCH") method = HTTP_PATCH;
+  else if (name == "DELETE") method = HTTP_DELETE;
+  else if (name == "OPTIONS") method = HTTP_OPTIONS;
+  else if (name == "HEAD") {
+    // Traité comme un GET dont on ne renvoie que les en-têtes
+    method = HTTP_GET;
+    headOnly = true;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+}
+
+HttpServer::HttpServer(uint16_t port)
+  : _port(port), _listenFd(-1), _notFoundHandler(nullptr), _requestCount(0), _lastHeartbeat(0), _wakeCycles(0),
+    _current(nullptr), _method(HTTP_GET), _headOnly(false), _responded(false), _http11(true),
+    _writer(*this), _chunked(false), _streamFailed(false), _chunkLength(0) {
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    _connections[i].fd = -1;
+    _connections[i].state = ConnectionState::FREE;
+    _connections[i].eventStream = false;
+  }
+  _unmatchedStats.requests = 0;
+  _unmatchedStats.totalMicros = 0;
+}
+
+HttpServer::~HttpServer() {
+  stop();
+}
+
+void HttpServer::begin() {
+  _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (_listenFd < 0) {
+    LOG_E("HTTP: socket() failed (%d)", errno);
+    return;
+  }
+
+  int enable = 1;
+  setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(_port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+  if (bind(_listenFd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+      listen(_listenFd, HTTP_MAX_CONNECTIONS) < 0) {
+    LOG_E("HTTP: cannot listen on port %u (%d)", (unsigned)_port, errno);
+    ::close(_listenFd);
+    _listenFd = -1;
+    return;
+  }
+
+  fcntl(_listenFd, F_SETFL, fcntl(_listenFd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+void HttpServer::stop() {
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    closeConnection(_connections[i]);
+  }
+  if (_listenFd >= 0) {
+    ::close(_listenFd);
+    _listenFd = -1;
+  }
+}
+
+void HttpServer::on(const String& uri, HttpHandler handler) {
+  on(uri, HTTP_ANY, handler);
+}
+
+void HttpServer::on(const String& uri, HTTPMethod method, HttpHandler handler) {
+  Route route;
+  route.uri = uri;
+  route.method = method;
+  route.handler = handler;
+  route.stats.requests = 0;
+  route.stats.totalMicros = 0;
+  _routes.push_back(route);
+}
+
+const char* HttpServer::methodName(HTTPMethod method) {
+  // HTTP_ANY ((HTTPMethod)255) ne fait pas partie de l'énumération
+  if (method == HTTP_ANY) return "ANY";
+  switch (method) {
+    case HTTP_GET: return "GET";
+    case HTTP_POST: return "POST";
+    case HTTP_PUT: return "PUT";
+    case HTTP_PATCH: return "PATCH";
+    case HTTP_DELETE: return "DELETE";
+    case HTTP_OPTIONS: return "OPTIONS";
+    default: return "OTHER";
+  }
+}
+
+void HttpServer::onNotFound(HttpHandler handler) {
+  _notFoundHandler = handler;
+}
+
+size_t HttpServer::activeConnections() const {
+  size_t count = 0;
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    if (_connections[i].state != ConnectionState::FREE) count++;
+  }
+  return count;
+}
+
+void HttpServer::handleClient(uint32_t waitMs) {
+  if (_listenFd < 0) return;
+
+  fd_set readSet;
+  fd_set writeSet;
+  FD_ZERO(&readSet);
+  FD_ZERO(&writeSet);
+  int maxFd = -1;
+
+  // Les connexions en surnombre attendent dans la file d'écoute
+  if (activeConnections() < HTTP_MAX_CONNECTIONS) {
+    FD_SET(_listenFd, &readSet);
+    maxFd = _listenFd;
+  }
+
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    Connection& conn = _connections[i];
+    if (conn.state == ConnectionState::READING || conn.state == ConnectionState::STREAMING) {
+      FD_SET(conn.fd, &readSet);
+    } else if (conn.state == ConnectionState::WRITING) {
+      FD_SET(conn.fd, &writeSet);
+    } else {
+      continue;
+    }
+    if (conn.fd > maxFd) maxFd = conn.fd;
+  }
+
+  struct timeval timeout;
+  timeout.tv_sec = waitMs / 1000;
+  timeout.tv_usec = (waitMs % 1000) * 1000;
+
+  int ready = (maxFd >= 0) ? select(maxFd + 1, &readSet, &writeSet, nullptr, &timeout) : 0;
+  _wakeCycles = ESP.getCycleCount();
+
+  if (ready > 0) {
+    if (FD_ISSET(_listenFd, &readSet)) {
+      acceptConnections();
+    }
+
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+      Connection& conn = _connections[i];
+      if ((conn.state == ConnectionState::READING || conn.state == ConnectionState::STREAMING) &&
+          FD_ISSET(conn.fd, &readSet)) {
+        readConnection(conn);
+      } else if (conn.state == ConnectionState::WRITING && FD_ISSET(conn.fd, &writeSet)) {
+        writeConnection(conn);
+      }
+    }
+  } else if (ready < 0 && errno != EINTR) {
+    LOG_W("HTTP: select() failed (%d)", errno);
+  }
+
+  uint32_t now = millis();
+  if ((uint32_t)(now - _lastHeartbeat) >= HTTP_EVENT_HEARTBEAT_MS) {
+    _lastHeartbeat = now;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+      if (_connections[i].state != ConnectionState::FREE && _connections[i].eventStream) {
+        queueEvent(_connections[i], ":\n\n");
+      }
+    }
+  }
+
+  // Fermer les connexions inactives ou bloquées (un abonné n'est jamais inactif)
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    Connection& conn = _connections[i];
+    if (conn.state != ConnectionState::FREE && conn.state != ConnectionState::STREAMING &&
+        (uint32_t)(now - conn.lastActivity) > HTTP_IDLE_TIMEOUT_MS) {
+      closeConnection(conn);
+    }
+  }
+}
+
+void HttpServer::acceptConnections() {
+  for (;;) {
+    Connection* conn = nullptr;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+      if (_connections[i].state == ConnectionState::FREE) {
+        conn = &_connections[i];
+        break;
+      }
+    }
+    if (!conn) return;
+
+    struct sockaddr_in peer;
+    socklen_t peerLength = sizeof(peer);
+    int fd = accept(_listenFd, (struct sockaddr*)&peer, &peerLength);
+    if (fd < 0) return;
+
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    conn->fd = fd;
+    conn->state = ConnectionState::READING;
+    conn->keepAlive = false;
+    conn->eventStream = false;
+    conn->requests = 0;
+    conn->lastActivity = millis();
+    conn->input = String();
+    conn->output = String();
+    conn->outputPos = 0;
+    conn->body = nullptr;
+    conn->bodyRemaining = 0;
+  }
+}
+
+void HttpServer::readConnection(Connection& conn) {
+  char buffer[512];
+
+  for (;;) {
+    int received = recv(conn.fd, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (received > 0) {
+      conn.input.concat(buffer, received);
+      conn.lastActivity = millis();
+      if (conn.input.length() > HTTP_MAX_HEADER_SIZE + HTTP_MAX_BODY_SIZE) break;
+    } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      // Fermée par le client ou erreur
+      closeConnection(conn);
+      return;
+    }
+  }
+
+  // Un abonné n'envoie plus de requêtes, seule sa fermeture nous intéresse
+  if (conn.eventStream) {
+    conn.input = String();
+    return;
+  }
+
+  processInput(conn);
+}
+
+void HttpServer::writeConnection(Connection& conn) {
+  if (!flushOutput(conn)) return;
+
+  completeResponse(conn);
+
+  // Requêtes pipelinées reçues pendant l'envoi
+  if (conn.state == ConnectionState::READING && conn.input.length() > 0) {
+    processInput(conn);
+  }
+}
+
+void HttpServer::closeConnection(Connection& conn) {
+  if (conn.state == ConnectionState::FREE) return;
+
+  ::close(conn.fd);
+  conn.fd = -1;
+  conn.state = ConnectionState::FREE;
+  conn.eventStream = false;
+  conn.input = String();
+  conn.output = String();
+  conn.outputPos = 0;
+  conn.body = nullptr;
+  conn.bodyRemaining = 0;
+  if (conn.file) conn.file.close();
+}
+
+void HttpServer::processInput(Connection& conn) {
+  while (conn.state == ConnectionState::READING) {
+    int headerEnd = conn.input.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+      if (conn.input.length() > HTTP_MAX_HEADER_SIZE) sendError(conn, 431);
+      return;
+    }
+
+    size_t consumed = 0;
+    if (!parseRequest(conn, headerEnd, consumed)) return;
+    conn.input.remove(0, consumed);
+
+    _current = &conn;
+    dispatch();
+    _current = nullptr;
+
+    // Client disparu au milieu d'une réponse chunked
+    if (_streamFailed) {
+      closeConnection(conn);
+      return;
+    }
+
+    // Envoi immédiat : la plupart des réponses tiennent dans le tampon TCP
+    conn.state = ConnectionState::WRITING;
+    if (!flushOutput(conn)) return;
+    completeResponse(conn);
+  }
+}
+
+bool HttpServer::parseRequest(Connection& conn, int headerEnd, size_t& consumed) {
+  // Ligne de requête : METHODE CIBLE VERSION
+  int lineEnd = conn.input.indexOf("\r\n");
+  int methodEnd = conn.input.indexOf(' ');
+  int targetEnd = (methodEnd > 0) ? conn.input.indexOf(' ', methodEnd + 1) : -1;
+  if (methodEnd <= 0 || targetEnd < 0 || targetEnd > lineEnd) {
+    sendError(conn, 400);
+    return false;
+  }
+
+  String methodName = conn.input.substring(0, methodEnd);
+  String target = conn.input.substring(methodEnd + 1, targetEnd);
+  bool http11 = conn.input.substring(targetEnd + 1, lineEnd) == "HTTP/1.1";
+  _http11 = http11;
+
+  if (!parseMethod(methodName, _method, _headOnly)) {
+    sendError(conn, 501);
+    return false;
+  }
+
+  // En-têtes
+  _headers.clear();
+  int pos = lineEnd + 2;
+  while (pos < headerEnd) {
+    int end = conn.input.indexOf("\r\n", pos);
+    int colon = conn.input.indexOf(':', pos);
+    if (colon > pos && colon < end) {
+      HttpArgument header;
+      header.name = conn.input.substring(pos, colon);
+      header.value = conn.input.substring(colon + 1, end);
+      header.value.trim();
+      _headers.push_back(header);
+    }
+    pos = end + 2;
+  }
+
+  if (hasHeader("Transfer-Encoding")) {
+    sendError(conn, 501);
+    return false;
+  }
+
+  long contentLength = header("Content-Length").toInt();
+  if (contentLength < 0) {
+    sendError(conn, 400);
+    return false;
+  }
+  if (contentLength > HTTP_MAX_BODY_SIZE) {
+    sendError(conn, 413);
+    return false;
+  }
+
+  // Attendre le corps complet
+  size_t total = headerEnd + 4 + contentLength;
+  if (conn.input.length() < total) return false;
+  consumed = total;
+
+  String connection = header("Connection");
+  connection.toLowerCase();
+  conn.keepAlive = http11 ? connection.indexOf("close") < 0 : connection.indexOf("keep-alive") >= 0;
+
+  // Chemin et arguments
+  int query = target.indexOf('?');
+  _uri = urlDecode(query >= 0 ? target.substring(0, query) : target);
+  _body = conn.input.substring(headerEnd + 4, total);
+  _args.clear();
+  if (query >= 0) {
+    parseArguments(target.substring(query + 1));
+  }
+  if (header("Content-Type").startsWith("application/x-www-form-urlencoded")) {
+    parseArguments(_body);
+  }
+  return true;
+}
+
+void HttpServer::parseArguments(const String& data) {
+  int pos = 0;
+  int length = data.length();
+
+  while (pos < length) {
+    int end = data.indexOf('&', pos);
+    if (end < 0) end = length;
+
+    int equal = data.indexOf('=', pos);
+    if (equal >= 0 && equal < end) {
+      HttpArgument argument;
+      argument.name = urlDecode(data.substring(pos, equal));
+      argument.value = urlDecode(data.substring(equal + 1, end));
+      _args.push_back(argument);
+    }
+    pos = end + 1;
+  }
+}
+
+void HttpServer::dispatch() {
+  _responded = false;
+  _extraHeaders = String();
+  // L'échec d'un flux précédent ne concerne que sa propre connexion
+  _chunked = false;
+  _streamFailed = false;
+  uint32_t start = micros();
+
+  HttpHandler handler = _notFoundHandler;
+  HttpRouteStats* stats = &_unmatchedStats;
+  for (auto& route : _routes) {
+    if ((route.method == HTTP_ANY || route.method == _method) && matchRoute(route.uri, _uri, _pathArgs)) {
+      handler = route.handler;
+      stats = &route.stats;
+      break;
+    }
+  }
+
+  if (handler) {
+    handler();
+  }
+  if (_chunked) {
+    endChunked();
+  }
+
+  if (!_responded) {
+    if (handler) {
+      LOG_W("HTTP: no response for %s", _uri.c_str());
+      send(500, "text/plain", "No response");
+    } else {
+      send(404, "text/plain", "Not found");
+    }
+  }
+
+  stats->requests++;
+  stats->totalMicros += (uint32_t)(micros() - start);
+  _requestCount++;
+}
+
+bool HttpServer::flushOutput(Connection& conn) {
+  size_t budget = HTTP_WRITE_BUDGET;
+
+  while (budget > 0) {
+    const char* data;
+    size_t length;
+    bool fromFile = false;
+    bool fromBody = false;
+
+    if (conn.outputPos < conn.output.length()) {
+      data = conn.output.c_str() + conn.outputPos;
+      length = conn.output.length() - conn.outputPos;
+    } else if (conn.bodyRemaining > 0) {
+      data = conn.body;
+      length = conn.bodyRemaining;
+      fromBody = true;
+    } else if (conn.file) {
+      length = conn.file.read(_chunk, HTTP_CHUNK_SIZE < budget ? HTTP_CHUNK_SIZE : budget);
+      if (length == 0) {
+        conn.file.close();
+        continue;
+      }
+      data = (const char*)_chunk;
+      fromFile = true;
+    } else {
+      conn.output = String();
+      conn.outputPos = 0;
+      return true;
+    }
+
+    if (length > budget) length = budget;
+    int sent = ::send(conn.fd, data, length, MSG_DONTWAIT);
+    if (sent < 0) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK) {
+        closeConnection(conn);
+        return false;
+      }
+      sent = 0;
+    }
+
+    if (sent > 0) conn.lastActivity = millis();
+    if (fromFile) {
+      // Relire au prochain tour la partie refusée par la pile TCP
+      if ((size_t)sent < length) conn.file.seek(conn.file.position() - (length - sent));
+    } else if (fromBody) {
+      conn.body += sent;
+      conn.bodyRemaining -= sent;
+    } else {
+      conn.outputPos += sent;
+    }
+
+    budget -= sent;
+    if ((size_t)sent < length) return false;
+  }
+
+  return false;
+}
+
+void HttpServer::completeResponse(Connection& conn) {
+  if (conn.eventStream) {
+    // Tout est parti : attendre le prochain événement
+    conn.state = ConnectionState::STREAMING;
+    return;
+  }
+
+  conn.requests++;
+  if (!conn.keepAlive) {
+    closeConnection(conn);
+    return;
+  }
+  conn.state = ConnectionState::READING;
+  conn.lastActivity = millis();
+}
+
+void HttpServer::sendError(Connection& conn, int code) {
+  // Requête illisible : répondre puis fermer, le reste du flux est abandonné
+  conn.keepAlive = false;
+  conn.input = String();
+  conn.output = String("HTTP/1.1 ") + code + " " + statusText(code) +
+                "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+  conn.outputPos = 0;
+  conn.state = ConnectionState::WRITING;
+  _requestCount++;
+}
+
+String HttpServer::statusHeader(int code, const char* contentType, size_t length) {
+  Connection& conn = *_current;
+
+  // Annoncer la fermeture avec la dernière réponse autorisée ; sans chunked
+  // (HTTP/1.0), la fin d'un corps de longueur inconnue est la fermeture
+  if (conn.requests + 1 >= HTTP_MAX_REQUESTS) conn.keepAlive = false;
+  if (length == UNKNOWN_LENGTH && !_http11) conn.keepAlive = false;
+
+  String header;
+  header.reserve(128 + _extraHeaders.length());
+  header = "HTTP/1.1 ";
+  header += code;
+  header += ' ';
+  header += statusText(code);
+  header += "\r\n";
+  if (contentType && *contentType) {
+    header += "Content-Type: ";
+    header += contentType;
+    header += "\r\n";
+  }
+  if (length == UNKNOWN_LENGTH) {
+    if (_http11) header += "Transfer-Encoding: chunked\r\n";
+  } else if (code != 204 && code != 304) {
+    header += "Content-Length: ";
+    header += (unsigned long)length;
+    header += "\r\n";
+  }
+  if (conn.keepAlive) {
+    header += "Connection: keep-alive\r\nKeep-Alive: timeout=";
+    header += HTTP_IDLE_TIMEOUT_MS / 1000;
+    header += "\r\n";
+  } else {
+    header += "Connection: close\r\n";
+  }
+  header += _extraHeaders;
+  header += "\r\n";
+  return header;
+}
+
+String HttpServer::arg(const String& name) const {
+  // Corps brut, comme l'argument "plain" de WebServer (copie à la demande)
+  if (name == "plain") return _body;
+  for (const auto& argument : _args) {
+    if (argument.name == name) return argument.value;
+  }
+  return String();
+}
+
+bool HttpServer::hasArg(const String& name) const {
+  if (name == "plain") return _body.length() > 0;
+  for (const auto& argument : _args) {
+    if (argument.name == name) return true;
+  }
+  return false;
+}
+
+String HttpServer::pathArg(unsigned int index) const {
+  return index < _pathArgs.size() ? _pathArgs[index] : String();
+}
+
+String HttpServer::header(const String& name) const {
+  for (const auto& header : _headers) {
+    if (header.name.equalsIgnoreCase(name)) return header.value;
+  }
+  return String();
+}
+
+bool HttpServer::hasHeader(const String& name) const {
+  for (const auto& header : _headers) {
+    if (header.name.equalsIgnoreCase(name)) return true;
+  }
+  return false;
+}
+
+void HttpServer::sendHeader(const String& name, const String& value, bool first) {
+  String line = name + ": " + value + "\r\n";
+  if (first) {
+    _extraHeaders = line + _extraHeaders;
+  } else {
+    _extraHeaders += line;
+  }
+}
+
+void HttpServer::send(int code, const char* contentType, const String& content) {
+  if (!_current || _responded) return;
+  _responded = true;
+
+  _current->output = statusHeader(code, contentType, content.length());
+  if (!_headOnly) _current->output += content;
+  _current->outputPos = 0;
+}
+
+void HttpServer::send_P(int code, const char* contentType, const char* content, size_t length) {
+  if (!_current || _responded) return;
+  _responded = true;
+
+  _current->output = statusHeader(code, contentType, length);
+  _current->outputPos = 0;
+  if (!_headOnly) {
+    _current->body = content;
+    _current->bodyRemaining = length;
+  }
+}
+
+size_t HttpServer::streamFile(File file, const String& contentType) {
+  if (!_current || _responded || !file) return 0;
+  _responded = true;
+
+  // Variante précompressée, comme WebServer
+  if (String(file.name()).endsWith(".gz") && contentType != "application/x-gzip" &&
+      contentType != "application/octet-stream") {
+    sendHeader("Content-Encoding", "gzip");
+  }
+
+  size_t size = file.size();
+  _current->output = statusHeader(200, contentType.c_str(), size);
+  _current->outputPos = 0;
+  if (!_headOnly) _current->file = file;
+  return size;
+}
+
+bool HttpServer::beginEventStream() {
+  if (!_current || _responded || _headOnly) return false;
+  _responded = true;
+
+  _current->eventStream = true;
+  _current->keepAlive = false;
+  _current->output = "HTTP/1.1 200 OK\r\nContent-Type: text/event-stream\r\n"
+                     "Cache-Control: no-cache\r\nConnection: keep-alive\r\n";
+  _current->output += _extraHeaders;
+  _current->output += "\r\nretry: 3000\n\n";
+  _current->outputPos = 0;
+  return true;
+}
+
+void HttpServer::sendEvent(const char* event, const String& data) {
+  if (!_current || !_current->eventStream) return;
+  _current->output += formatEvent(event, data);
+}
+
+void HttpServer::broadcastEvent(const char* event, const String& data) {
+  if (eventSubscribers() == 0) return;
+
+  String text = formatEvent(event, data);
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    Connection& conn = _connections[i];
+    if (conn.state != ConnectionState::FREE && conn.eventStream) {
+      queueEvent(conn, text);
+    }
+  }
+}
+
+void HttpServer::queueEvent(Connection& conn, const String& event) {
+  // Retirer la partie déjà envoyée avant d'ajouter
+  if (conn.outputPos > 0) {
+    conn.output.remove(0, conn.outputPos);
+    conn.outputPos = 0;
+  }
+
+  if (conn.output.length() + event.length() > HTTP_EVENT_BACKLOG) {
+    LOG_W("HTTP: dropping slow event subscriber");
+    closeConnection(conn);
+    return;
+  }
+
+  conn.output += event;
+  if (conn.state == ConnectionState::STREAMING) {
+    conn.state = ConnectionState::WRITING;
+    conn.lastActivity = millis();
+    if (flushOutput(conn)) completeResponse(conn);
+  }
+}
+
+size_t HttpServer::eventSubscribers() const {
+  size_t count = 0;
+  for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+    if (_connections[i].state != ConnectionState::FREE && _connections[i].eventStream) count++;
+  }
+  return count;
+}
+
+Print& HttpServer::beginChunked(int code, const char* contentType) {
+  if (!_current || _responded) return _writer;
+  _responded = true;
+
+  _chunked = true;
+  _streamFailed = false;
+  _chunkLength = 0;
+  _current->output = statusHeader(code, contentType, UNKNOWN_LENGTH);
+  _current->outputPos = 0;
+  return _writer;
+}
+
+void HttpServer::endChunked() {
+  if (!_chunked) return;
+
+  flushChunk(true);
+  _chunked = false;
+}
+
+size_t ChunkedWriter::write(const uint8_t* buffer, size_t size) {
+  return _server.appendChunk(buffer, size);
+}
+
+size_t HttpServer::appendChunk(const uint8_t* data, size_t size) {
+  if (!_chunked || _streamFailed) return 0;
+  if (_headOnly) return size;
+
+  size_t written = 0;
+  while (written < size) {
+    if (_chunkLength == CHUNK_CAPACITY && !flushChunk(false)) return written;
+
+    size_t count = size - written;
+    if (count > CHUNK_CAPACITY - _chunkLength) count = CHUNK_CAPACITY - _chunkLength;
+    memcpy(_chunk + CHUNK_PREFIX + _chunkLength, data + written, count);
+    _chunkLength += count;
+    written += count;
+  }
+  return written;
+}
+
+bool HttpServer::flushChunk(bool last) {
+  Connection& conn = *_current;
+  if (_streamFailed) return false;
+
+  // En-têtes encore en attente
+  if (conn.outputPos < conn.output.length()) {
+    if (!writeAll(conn, conn.output.c_str() + conn.outputPos, conn.output.length() - conn.outputPos)) {
+      _streamFailed = true;
+      return false;
+    }
+    conn.output = String();
+    conn.outputPos = 0;
+  }
+  if (_headOnly) return true;
+
+  const char* data = (const char*)_chunk + CHUNK_PREFIX;
+  size_t length = _chunkLength;
+
+  if (_http11) {
+    // Taille sur 4 chiffres hexadécimaux, zéros de tête autorisés
+    if (length > 0) {
+      char prefix[CHUNK_PREFIX + 1];
+      snprintf(prefix, sizeof(prefix), "%04X\r\n", (unsigned)length);
+      memcpy(_chunk, prefix, CHUNK_PREFIX);
+      memcpy(_chunk + CHUNK_PREFIX + length, "\r\n", 2);
+      data = (const char*)_chunk;
+      length += CHUNK_PREFIX + 2;
+    }
+    if (last) {
+      memcpy((char*)data + length, "0\r\n\r\n", 5);
+      length += 5;
+    }
+  }
+
+  _chunkLength = 0;
+  if (length > 0 && !writeAll(conn, data, length)) {
+    _streamFailed = true;
+    return false;
+  }
+  return true;
+}
+
+bool HttpServer::writeAll(Connection& conn, const char* data, size_t length) {
+  uint32_t lastProgress = millis();
+
+  while (length > 0) {
+    int sent = ::send(conn.fd, data, length, MSG_DONTWAIT);
+    if (sent > 0) {
+      data += sent;
+      length -= sent;
+      lastProgress = millis();
+      conn.lastActivity = lastProgress;
+      continue;
+    }
+    if (sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK) return false;
+
+    // Tampon TCP plein : attendre que le client lise, sans bloquer la tâche
+    // web au-delà de HTTP_STREAM_TIMEOUT_MS
+    if ((uint32_t)(millis() - lastProgress) > HTTP_STREAM_TIMEOUT_MS) return false;
+
+    fd_set writeSet;
+    FD_ZERO(&writeSet);
+    FD_SET(conn.fd, &writeSet);
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 50000;
+    select(conn.fd + 1, nullptr, &writeSet, nullptr, &timeout);
+  }
+  return true;
+}
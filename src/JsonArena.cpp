@@ -0,0 +1,78 @@
+#include "JsonArena.h"
+
+namespace {
+
+const size_t ALIGNMENT = 8;
+
+size_t alignUp(size_t size) {
+  return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+}
+
+}
+
+JsonArena::JsonArena()
+  : _top(0), _lastBlock(0), _liveBlocks(0), _highWater(0), _heapFallbacks(0) {
+}
+
+bool JsonArena::owns(const void* pointer) const {
+  return pointer >= _buffer && pointer < _buffer + JSON_ARENA_SIZE;
+}
+
+void* JsonArena::allocate(size_t size) {
+  size_t offset = _top;
+  size_t blockSize = alignUp(sizeof(Header) + size);
+
+  if (offset + blockSize > JSON_ARENA_SIZE) {
+    _heapFallbacks++;
+    return malloc(size);
+  }
+
+  Header* header = reinterpret_cast<Header*>(_buffer + offset);
+  header->size = size;
+  _lastBlock = offset;
+  _top = offset + blockSize;
+  _liveBlocks++;
+  if (_top > _highWater) _highWater = _top;
+
+  return header + 1;
+}
+
+void JsonArena::deallocate(void* pointer) {
+  if (!pointer) return;
+  if (!owns(pointer)) {
+    free(pointer);
+    return;
+  }
+
+  // Les blocs libérés ne sont récupérés qu'en fin de document
+  if (--_liveBlocks == 0) {
+    _top = 0;
+    _lastBlock = 0;
+  }
+}
+
+void* JsonArena::reallocate(void* pointer, size_t newSize) {
+  if (!pointer) return allocate(newSize);
+  if (!owns(pointer)) return realloc(pointer, newSize);
+
+  Header* header = reinterpret_cast<Header*>(pointer) - 1;
+  size_t offset = reinterpret_cast<uint8_t*>(header) - _buffer;
+
+  // Dernier bloc : agrandi ou réduit sur place
+  if (offset == _lastBlock) {
+    size_t blockSize = alignUp(sizeof(Header) + newSize);
+    if (offset + blockSize <= JSON_ARENA_SIZE) {
+      header->size = newSize;
+      _top = offset + blockSize;
+      if (_top > _highWater) _highWater = _top;
+      return pointer;
+    }
+  }
+
+  size_t oldSize = header->size;
+  void* moved = allocate(newSize);
+  if (!moved) return nullptr;
+  memcpy(moved, pointer, oldSize < newSize ? oldSize : newSize);
+  deallocate(pointer);
+  return moved;
+}
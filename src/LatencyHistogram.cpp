@@ -0,0 +1,37 @@
+#include "LatencyHistogram.h"
+
+void LatencyHistogram::reset() {
+  for (int i = 0; i < BUCKETS; i++) _buckets[i] = 0;
+  _count = 0;
+  _max = 0;
+}
+
+uint32_t LatencyHistogram::percentile(float fraction) const {
+  // Copie locale : l'écrivain peut continuer pendant le calcul
+  uint32_t buckets[BUCKETS];
+  uint32_t total = 0;
+  for (int i = 0; i < BUCKETS; i++) {
+    buckets[i] = _buckets[i];
+    total += buckets[i];
+  }
+  if (total == 0) return 0;
+
+  // Rang du percentile (1 .. total)
+  uint32_t rank = (uint32_t)(fraction * total + 0.5f);
+  if (rank < 1) rank = 1;
+  if (rank > total) rank = total;
+
+  uint32_t seen = 0;
+  for (int i = 0; i < BUCKETS; i++) {
+    if (seen + buckets[i] < rank) {
+      seen += buckets[i];
+      continue;
+    }
+    uint64_t low = (i == 0) ? 0 : (1ULL << i);
+    uint64_t high = 1ULL << (i + 1);
+    uint64_t value = low + (high - low) * (rank - seen) / buckets[i];
+    uint32_t maxCycles = _max;
+    return (value > maxCycles) ? maxCycles : (uint32_t)value;
+  }
+  return _max;
+}
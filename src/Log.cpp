@@ -0,0 +1,251 @@
+#include "Log.h"
+#include <atomic>
+#include <stdio.h>
+
+// Anneau multi-producteurs / consommateur unique sans verrou :
+// chaque case porte un numéro de séquence qui indique si elle est libre
+// (seq == position) ou publiée (seq == position + 1).
+namespace {
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of 2");
+
+struct LogEntry {
+  std::atomic<uint32_t> seq;
+  uint32_t timestamp;
+  LogLevel level;
+  const char* format;
+  Log::Arguments arguments;
+};
+
+LogEntry ring[LOG_RING_SIZE];
+std::atomic<uint32_t> writePos(0);
+uint32_t readPos = 0;
+std::atomic<uint32_t> droppedCount(0);
+bool ringReady = false;
+
+const char levelTags[] = { 'N', 'E', 'W', 'I', 'D', 'V' };
+
+void initRing() {
+  for (uint32_t i = 0; i < LOG_RING_SIZE; i++) {
+    ring[i].seq.store(i, std::memory_order_relaxed);
+  }
+  ringReady = true;
+}
+
+// Spécification de conversion de printf : %[drapeaux][largeur][.précision][taille]conversion
+struct Conversion {
+  char spec[48];
+  size_t length;
+  char size[3];
+  char type;
+};
+
+// Met en forme une ligne d'après le format et les arguments bruts, avec le
+// printf de la bibliothèque pour chaque conversion
+void formatEntry(char* line, size_t capacity, const char* format, const Log::Arguments& arguments) {
+  size_t used = 0;
+  uint8_t next = 0;
+  line[0] = '\0';
+
+  auto append = [&](int written) {
+    if (written > 0) used += (size_t)written;
+    if (used >= capacity) used = capacity - 1;
+  };
+
+  for (const char* p = format; *p && used + 1 < capacity;) {
+    if (*p != '%') {
+      line[used++] = *p++;
+      line[used] = '\0';
+      continue;
+    }
+    if (p[1] == '%') {
+      line[used++] = '%';
+      line[used] = '\0';
+      p += 2;
+      continue;
+    }
+
+    // Drapeaux, largeur et précision recopiés ; '*' remplacé par sa valeur
+    Conversion conversion;
+    conversion.length = 0;
+    conversion.spec[conversion.length++] = *p++;
+    while (*p && strchr("-+ #0", *p) && conversion.length < 8) conversion.spec[conversion.length++] = *p++;
+    for (int part = 0; part < 2; part++) {
+      if (part == 1) {
+        if (*p != '.') break;
+        conversion.spec[conversion.length++] = *p++;
+      }
+      if (*p == '*') {
+        int value = next < arguments.count ? (int)arguments.values[next++].integer : 0;
+        conversion.length += snprintf(conversion.spec + conversion.length, 12, "%d", value);
+        p++;
+      } else {
+        while (isdigit((unsigned char)*p) && conversion.length < 16) conversion.spec[conversion.length++] = *p++;
+      }
+    }
+
+    // Taille : les entiers sont relus depuis 64 bits, tronqués d'abord à la
+    // taille demandée
+    size_t sizeLength = 0;
+    while (*p && strchr("hlLqjzt", *p) && sizeLength < 2) conversion.size[sizeLength++] = *p++;
+    conversion.size[sizeLength] = '\0';
+    conversion.type = *p;
+    if (!*p) break;
+    p++;
+
+    if (next >= arguments.count) break;
+    const Log::Arguments::Value& value = arguments.values[next++];
+    char* out = line + used;
+    size_t room = capacity - used;
+    bool longLong = (strcmp(conversion.size, "ll") == 0 || strcmp(conversion.size, "q") == 0 ||
+                     strcmp(conversion.size, "j") == 0);
+    bool wide = longLong || (conversion.size[0] == 'l' && sizeof(long) == 8) ||
+                ((conversion.size[0] == 'z' || conversion.size[0] == 't') && sizeof(size_t) == 8);
+
+    switch (conversion.type) {
+      case 'd':
+      case 'i': {
+        long long number = value.integer;
+        if (strcmp(conversion.size, "hh") == 0) number = (signed char)number;
+        else if (strcmp(conversion.size, "h") == 0) number = (short)number;
+        else if (!wide) number = (int32_t)number;
+        strcpy(conversion.spec + conversion.length, "lld");
+        conversion.spec[conversion.length + 2] = conversion.type;
+        append(snprintf(out, room, conversion.spec, number));
+        break;
+      }
+      case 'u':
+      case 'o':
+      case 'x':
+      case 'X': {
+        unsigned long long number = value.unsignedInteger;
+        if (strcmp(conversion.size, "hh") == 0) number = (unsigned char)number;
+        else if (strcmp(conversion.size, "h") == 0) number = (unsigned short)number;
+        else if (!wide) number = (uint32_t)number;
+        strcpy(conversion.spec + conversion.length, "llu");
+        conversion.spec[conversion.length + 2] = conversion.type;
+        append(snprintf(out, room, conversion.spec, number));
+        break;
+      }
+      case 'c':
+        strcpy(conversion.spec + conversion.length, "c");
+        append(snprintf(out, room, conversion.spec, (int)value.integer));
+        break;
+      case 'f':
+      case 'F':
+      case 'e':
+      case 'E':
+      case 'g':
+      case 'G':
+      case 'a':
+      case 'A':
+        conversion.spec[conversion.length] = conversion.type;
+        conversion.spec[conversion.length + 1] = '\0';
+        append(snprintf(out, room, conversion.spec, value.real));
+        break;
+      case 's':
+        strcpy(conversion.spec + conversion.length, "s");
+        append(snprintf(out, room, conversion.spec, arguments.text + value.text));
+        break;
+      case 'p':
+        strcpy(conversion.spec + conversion.length, "p");
+        append(snprintf(out, room, conversion.spec, value.pointer));
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+void drainTask(void* parameter) {
+  for (;;) {
+    if (Log::drain() == 0) {
+      vTaskDelay(pdMS_TO_TICKS(20));
+    }
+  }
+}
+
+}
+
+namespace Log {
+
+void begin() {
+  if (!ringReady) initRing();
+  xTaskCreatePinnedToCore(drainTask, "log", 3072, nullptr, tskIDLE_PRIORITY + 1, nullptr, tskNO_AFFINITY);
+}
+
+void Arguments::add(const char* value) {
+  if (count >= LOG_MAX_ARGS) return;
+  if (!value) value = "(null)";
+  // Copie tronquée ; "" (le zéro final de la chaîne précédente) quand la
+  // place est épuisée
+  size_t room = LOG_TEXT_SIZE - textUsed;
+  if (room == 0) {
+    values[count++].text = LOG_TEXT_SIZE - 1;
+    return;
+  }
+  size_t length = strnlen(value, room - 1);
+  memcpy(text + textUsed, value, length);
+  text[textUsed + length] = '\0';
+  values[count++].text = textUsed;
+  textUsed += length + 1;
+}
+
+void commit(LogLevel level, const char* format, const Arguments& arguments) {
+  if (!ringReady) initRing();
+
+  // Réserver une case libre
+  uint32_t pos = writePos.load(std::memory_order_relaxed);
+  LogEntry* entry;
+  for (;;) {
+    entry = &ring[pos & (LOG_RING_SIZE - 1)];
+    uint32_t seq = entry->seq.load(std::memory_order_acquire);
+    int32_t diff = (int32_t)(seq - pos);
+    if (diff == 0) {
+      if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = writePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  entry->timestamp = millis();
+  entry->level = level;
+  entry->format = format;
+  // Seuls les arguments utilisés et le texte copié
+  entry->arguments.count = arguments.count;
+  entry->arguments.textUsed = arguments.textUsed;
+  memcpy(entry->arguments.values, arguments.values, arguments.count * sizeof(arguments.values[0]));
+  memcpy(entry->arguments.text, arguments.text, arguments.textUsed);
+
+  // Publier la case au consommateur
+  entry->seq.store(pos + 1, std::memory_order_release);
+}
+
+size_t drain() {
+  size_t lines = 0;
+  char text[LOG_LINE_SIZE];
+
+  for (;;) {
+    LogEntry& entry = ring[readPos & (LOG_RING_SIZE - 1)];
+    if (entry.seq.load(std::memory_order_acquire) != readPos + 1) break;
+
+    formatEntry(text, sizeof(text), entry.format, entry.arguments);
+    Serial.printf("[%lu][%c] %s\r\n", (unsigned long)entry.timestamp, levelTags[(uint8_t)entry.level], text);
+
+    // Rendre la case aux producteurs pour le tour suivant
+    entry.seq.store(readPos + LOG_RING_SIZE, std::memory_order_release);
+    readPos++;
+    lines++;
+  }
+
+  return lines;
+}
+
+uint32_t dropped() {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+}
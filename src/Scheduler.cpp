@@ -0,0 +1,168 @@
+#include "Scheduler.h"
+
+TimerWheel scheduler;
+
+Timer::Timer(TimerCallback cb, void* ctx)
+  : expires(0), callback(cb), context(ctx), level(0), slot(0) {
+  next = nullptr;
+  prev = nullptr;
+}
+
+TimerWheel::TimerWheel() : _current(0), _count(0), _started(false) {
+  for (int level = 0; level < LEVELS; level++) {
+    _occupied[level] = 0;
+    for (int slot = 0; slot < SLOTS; slot++) {
+      _slots[level][slot].next = &_slots[level][slot];
+      _slots[level][slot].prev = &_slots[level][slot];
+    }
+  }
+}
+
+void TimerWheel::schedule(Timer& timer, uint32_t expires) {
+  if (!_started) {
+    _current = millis();
+    _started = true;
+  }
+  if (timer.isArmed()) unlink(timer);
+
+  timer.expires = expires;
+  insert(timer);
+  _count++;
+}
+
+void TimerWheel::cancel(Timer& timer) {
+  if (!timer.isArmed()) return;
+  unlink(timer);
+  _count--;
+}
+
+void TimerWheel::insert(Timer& timer) {
+  int32_t delta = (int32_t)(timer.expires - _current);
+  uint32_t target = timer.expires;
+  int level;
+
+  if (delta < 0) {
+    // Déjà échu : traité au prochain tick
+    level = 0;
+    target = _current;
+  } else if (delta < (1L << SLOT_BITS)) {
+    level = 0;
+  } else if (delta < (1L << (2 * SLOT_BITS))) {
+    level = 1;
+  } else if (delta < (1L << (3 * SLOT_BITS))) {
+    level = 2;
+  } else {
+    level = 3;
+    if (delta >= (1L << (4 * SLOT_BITS))) {
+      // Hors de portée : replacé au dernier niveau lors de la cascade
+      target = _current + (1UL << (4 * SLOT_BITS)) - 1;
+    }
+  }
+
+  uint32_t slot = (target >> (level * SLOT_BITS)) & SLOT_MASK;
+  TimerLink& head = _slots[level][slot];
+
+  timer.level = level;
+  timer.slot = slot;
+  timer.next = &head;
+  timer.prev = head.prev;
+  head.prev->next = &timer;
+  head.prev = &timer;
+  _occupied[level] |= (1ULL << slot);
+}
+
+void TimerWheel::unlink(Timer& timer) {
+  timer.prev->next = timer.next;
+  timer.next->prev = timer.prev;
+  timer.next = nullptr;
+  timer.prev = nullptr;
+
+  TimerLink& head = _slots[timer.level][timer.slot];
+  if (head.next == &head) {
+    _occupied[timer.level] &= ~(1ULL << timer.slot);
+  }
+}
+
+void TimerWheel::cascade(int level, uint32_t index) {
+  TimerLink& head = _slots[level][index];
+  while (head.next != &head) {
+    Timer& timer = *static_cast<Timer*>(head.next);
+    unlink(timer);
+    insert(timer);
+  }
+}
+
+void TimerWheel::advance(uint32_t now) {
+  if (!_started) return;
+
+  while ((int32_t)(now - _current) >= 0) {
+    uint32_t index = _current & SLOT_MASK;
+
+    // Début d'un tour : faire descendre les timers des niveaux supérieurs
+    if (index == 0) {
+      for (int level = 1; level < LEVELS; level++) {
+        uint32_t levelIndex = (_current >> (level * SLOT_BITS)) & SLOT_MASK;
+        cascade(level, levelIndex);
+        if (levelIndex != 0) break;
+      }
+    }
+
+    if (!(_occupied[0] & (1ULL << index))) {
+      // Sauter directement à la prochaine case occupée ou à la fin du tour
+      uint64_t ahead = _occupied[0] & (~0ULL << index);
+      uint32_t target = ahead ? (_current & ~SLOT_MASK) + __builtin_ctzll(ahead)
+                              : (_current | SLOT_MASK) + 1;
+      if ((int32_t)(target - now) > 0) target = now + 1;
+      _current = target;
+      continue;
+    }
+
+    // Détacher la case avant d'avancer : un callback peut réarmer son timer
+    TimerLink expired;
+    TimerLink& head = _slots[0][index];
+    expired.next = head.next;
+    expired.prev = head.prev;
+    expired.next->prev = &expired;
+    expired.prev->next = &expired;
+    head.next = &head;
+    head.prev = &head;
+    _occupied[0] &= ~(1ULL << index);
+    _current++;
+
+    while (expired.next != &expired) {
+      Timer& timer = *static_cast<Timer*>(expired.next);
+      expired.next = timer.next;
+      timer.next->prev = &expired;
+      timer.next = nullptr;
+      timer.prev = nullptr;
+      _count--;
+
+      if (timer.callback) {
+        timer.callback(timer.context);
+      }
+    }
+  }
+}
+
+bool TimerWheel::nextDeadline(uint32_t& deadline) const {
+  if (_count == 0) return false;
+
+  bool found = false;
+  for (int level = 0; level < LEVELS; level++) {
+    uint64_t bits = _occupied[level];
+    if (!bits) continue;
+
+    // Prochaine frontière de ce niveau (incluse si le tick n'est pas encore traité)
+    int shift = level * SLOT_BITS;
+    uint32_t unit = (_current + (1UL << shift) - 1) >> shift;
+    uint32_t start = unit & SLOT_MASK;
+    uint64_t rotated = (bits >> start) | (start ? (bits << (SLOTS - start)) : 0);
+    uint32_t candidate = (unit + __builtin_ctzll(rotated)) << shift;
+
+    if (!found || (int32_t)(candidate - deadline) < 0) {
+      deadline = candidate;
+      found = true;
+    }
+  }
+  return found;
+}
@@ -1,88 +1,261 @@
 #include "Sensor.h"
+#include "Log.h"
 
 // BaseSensor Implementation
-BaseSensor::BaseSensor(String id, String name, int pin) 
-  : _id(id), _name(name), _pin(pin), _lastRead(0), _readInterval(1000) {}
+BaseSensor::BaseSensor(Symbol id, String name, int pin) 
+  : _id(id), _name(name), _pin(pin), _slot(-1), _lastRead(0), _readInterval(1000), _timer(nullptr, this) {}
 
 bool BaseSensor::isReady() {
   return (millis() - _lastRead) >= _readInterval;
 }
 
+bool BaseSensor::poll(SensorReading& reading) {
+  if (!isReady()) return false;
+  reading = read();
+  return true;
+}
+
+unsigned long BaseSensor::nextPollDelay() const {
+  unsigned long elapsed = millis() - _lastRead;
+  return (elapsed >= _readInterval) ? 0 : _readInterval - elapsed;
+}
+
 // DHT11Sensor Implementation
-DHT11Sensor::DHT11Sensor(String id, String name, int pin) 
-  : BaseSensor(id, name, pin), _dht(nullptr) {}
+// Trame DHT11 : réponse (80 µs bas / 80 µs haut), 40 bits (50 µs bas puis
+// 26-28 µs haut pour 0, 70 µs haut pour 1), puis 50 µs bas de fin.
+static const unsigned long DHT_START_SIGNAL_MS = 20;  // Niveau bas imposé par l'hôte (>= 18 ms)
+static const unsigned long DHT_CAPTURE_TIMEOUT_MS = 50;
+static const unsigned long DHT_RETRY_DELAY_MS = 150;
+static const uint16_t DHT_ONE_THRESHOLD_US = 40;      // Au-delà, le bit vaut 1
+static const uint16_t DHT_RMT_IDLE_US = 200;          // Fin de trame
+static const unsigned long DHT_CAPTURE_POLL_MS = 2;   // Scrutation du tampon RMT
+
+uint8_t DHT11Sensor::_channelsInUse = 0;
+
+DHT11Sensor::DHT11Sensor(Symbol id, String name, int pin) 
+  : BaseSensor(id, name, pin), _state(State::IDLE), _channel(RMT_CHANNEL_0), 
+    _ringbuf(nullptr), _rmtReady(false), _retrying(false), _stateTime(0) {
+  _result.isValid = false;
+  _result.timestamp = 0;
+}
+
+DHT11Sensor::~DHT11Sensor() {
+  if (_rmtReady) {
+    rmt_rx_stop(_channel);
+    rmt_driver_uninstall(_channel);
+    _channelsInUse &= ~(1 << _channel);
+  }
+}
 
 void DHT11Sensor::init() {
-  _dht = new DHT(_pin, DHT11);
-  _dht->begin();
-  Serial.println("DHT11 sensor initialized on pin " + String(_pin));
+  pinMode(_pin, INPUT_PULLUP);
+  
+  // Premier canal libre : les canaux sont rendus à la destruction du capteur
+  int channel = 0;
+  while (channel < RMT_CHANNEL_MAX && (_channelsInUse & (1 << channel))) channel++;
+  if (channel >= RMT_CHANNEL_MAX) {
+    LOG_E("DHT11 Sensor %s: Aucun canal RMT disponible", symbols.text(_id));
+    return;
+  }
+  _channel = (rmt_channel_t)channel;
+  
+  rmt_config_t rmtConfig = RMT_DEFAULT_CONFIG_RX((gpio_num_t)_pin, _channel);
+  rmtConfig.clk_div = 80; // 1 tick = 1 µs
+  rmtConfig.mem_block_num = 1;
+  rmtConfig.rx_config.filter_en = true;
+  rmtConfig.rx_config.filter_ticks_thresh = 100;
+  rmtConfig.rx_config.idle_threshold = DHT_RMT_IDLE_US;
+  
+  if (rmt_config(&rmtConfig) != ESP_OK ||
+      rmt_driver_install(_channel, 512, 0) != ESP_OK ||
+      rmt_get_ringbuf_handle(_channel, &_ringbuf) != ESP_OK) {
+    LOG_E("DHT11 Sensor %s: Échec d'initialisation RMT", symbols.text(_id));
+    rmt_driver_uninstall(_channel);
+    return;
+  }
+  
+  _channelsInUse |= (1 << _channel);
+  _rmtReady = true;
+  LOG_I("DHT11 sensor initialized on pin %d (RMT channel %d)", _pin, (int)_channel);
 }
 
 SensorReading DHT11Sensor::read() {
-  SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "DHT11";
-  reading.timestamp = millis();
-  reading.isValid = false; // Par défaut invalide
+  return _result;
+}
+
+bool DHT11Sensor::poll(SensorReading& reading) {
+  if (_state == State::IDLE) {
+    if (!isReady()) return false;
+    start();
+  }
   
-  if (_dht) {
-    reading.temperature = _dht->readTemperature();
-    reading.humidity = _dht->readHumidity();
-    
-    if (isnan(reading.temperature) || isnan(reading.humidity)) {
-      Serial.println("DHT11 Sensor " + _id + ": Failed to read - attempting recovery");
+  if (!update()) return false;
+  reading = _result;
+  return true;
+}
+
+unsigned long DHT11Sensor::nextPollDelay() const {
+  unsigned long elapsed = millis() - _stateTime;
+  
+  switch (_state) {
+    case State::START_SIGNAL:
+      return (elapsed >= DHT_START_SIGNAL_MS) ? 0 : DHT_START_SIGNAL_MS - elapsed;
+    case State::CAPTURE:
+      return DHT_CAPTURE_POLL_MS;
+    case State::RETRY_WAIT:
+      return (elapsed >= DHT_RETRY_DELAY_MS) ? 0 : DHT_RETRY_DELAY_MS - elapsed;
+    case State::IDLE:
+      break;
+  }
+  return BaseSensor::nextPollDelay();
+}
+
+void DHT11Sensor::start() {
+  if (!_rmtReady) {
+    // Échec immédiat, sans bloquer
+    _state = State::CAPTURE;
+    return;
+  }
+  
+  // Signal de départ : maintenir la ligne au niveau bas
+  pinMode(_pin, OUTPUT);
+  digitalWrite(_pin, LOW);
+  _stateTime = millis();
+  _state = State::START_SIGNAL;
+}
+
+bool DHT11Sensor::update() {
+  switch (_state) {
+    case State::IDLE:
+      return false;
       
-      // Tentative de réinitialisation
-      _dht->begin();
-      delay(150);
+    case State::START_SIGNAL:
+      if (millis() - _stateTime < DHT_START_SIGNAL_MS) return false;
       
-      // Seconde tentative
-      reading.temperature = _dht->readTemperature();
-      reading.humidity = _dht->readHumidity();
+      // Relâcher la ligne et capturer la réponse du capteur
+      pinMode(_pin, INPUT_PULLUP);
+      rmt_set_gpio(_channel, RMT_MODE_RX, (gpio_num_t)_pin, false);
+      rmt_rx_start(_channel, true);
+      _stateTime = millis();
+      _state = State::CAPTURE;
+      return false;
       
-      if (isnan(reading.temperature) || isnan(reading.humidity)) {
-        Serial.println("DHT11 Sensor " + _id + ": Capteur déconnecté - pas de données");
-        reading.isValid = false; // Lecture invalide
-        return reading; // Ne pas retourner de valeurs
-      } else {
-        Serial.println("DHT11 Sensor " + _id + ": Récupération réussie");
-        reading.isValid = true;
+    case State::CAPTURE: {
+      if (!_rmtReady) {
+        LOG_E("DHT11 Sensor %s: Non initialisé - pas de données", symbols.text(_id));
+        complete(false, NAN, NAN);
+        return true;
       }
-    } else {
-      reading.isValid = true; // Lecture réussie
-    }
-    
-    // Validation des plages réalistes seulement si la lecture est valide
-    if (reading.isValid) {
-      if (reading.temperature < -40 || reading.temperature > 80) {
-        reading.isValid = false; // Valeur aberrante
+      
+      size_t rxSize = 0;
+      rmt_item32_t* items = (rmt_item32_t*)xRingbufferReceive(_ringbuf, &rxSize, 0);
+      if (items == nullptr) {
+        if (millis() - _stateTime < DHT_CAPTURE_TIMEOUT_MS) return false;
+        rmt_rx_stop(_channel);
+        handleFailure();
+        return _state == State::IDLE;
       }
-      if (reading.humidity < 0 || reading.humidity > 100) {
-        reading.isValid = false; // Valeur aberrante
+      
+      rmt_rx_stop(_channel);
+      float temperature = NAN;
+      float humidity = NAN;
+      bool decoded = decode(items, rxSize / sizeof(rmt_item32_t), temperature, humidity);
+      vRingbufferReturnItem(_ringbuf, items);
+      
+      if (!decoded) {
+        handleFailure();
+        return _state == State::IDLE;
+      }
+      
+      if (_retrying) {
+        LOG_I("DHT11 Sensor %s: Récupération réussie", symbols.text(_id));
       }
+      complete(true, temperature, humidity);
+      return true;
     }
-  } else {
-    Serial.println("DHT11 Sensor " + _id + ": Non initialisé - pas de données");
-    reading.isValid = false;
+      
+    case State::RETRY_WAIT:
+      if (millis() - _stateTime < DHT_RETRY_DELAY_MS) return false;
+      start();
+      return false;
+  }
+  
+  return false;
+}
+
+void DHT11Sensor::handleFailure() {
+  if (!_retrying) {
+    // Seconde tentative après une pause, sans bloquer la boucle
+    LOG_W("DHT11 Sensor %s: Failed to read - attempting recovery", symbols.text(_id));
+    _retrying = true;
+    _stateTime = millis();
+    _state = State::RETRY_WAIT;
+    return;
   }
   
+  LOG_W("DHT11 Sensor %s: Capteur déconnecté - pas de données", symbols.text(_id));
+  complete(false, NAN, NAN);
+}
+
+void DHT11Sensor::complete(bool isValid, float temperature, float humidity) {
+  _result.temperature = temperature;
+  _result.humidity = humidity;
+  _result.timestamp = millis();
+  _result.isValid = isValid;
+  
+  // Validation des plages réalistes seulement si la lecture est valide
+  if (_result.isValid) {
+    if (_result.temperature < -40 || _result.temperature > 80) {
+      _result.isValid = false; // Valeur aberrante
+    }
+    if (_result.humidity < 0 || _result.humidity > 100) {
+      _result.isValid = false; // Valeur aberrante
+    }
+  }
+  
+  _retrying = false;
+  _state = State::IDLE;
   _lastRead = millis();
-  return reading;
+}
+
+bool DHT11Sensor::decode(const rmt_item32_t* items, size_t count, float& temperature, float& humidity) {
+  // Le dernier élément est le niveau bas de fin (durée haute nulle)
+  size_t end = count;
+  if (end > 0 && items[end - 1].duration1 == 0) end--;
+  if (end < 40) return false;
+  
+  uint8_t data[5] = {0, 0, 0, 0, 0};
+  const rmt_item32_t* bits = items + (end - 40);
+  for (int i = 0; i < 40; i++) {
+    data[i / 8] <<= 1;
+    if (bits[i].duration1 > DHT_ONE_THRESHOLD_US) {
+      data[i / 8] |= 1;
+    }
+  }
+  
+  uint8_t checksum = data[0] + data[1] + data[2] + data[3];
+  if (checksum != data[4]) return false;
+  
+  humidity = data[0] + data[1] * 0.1f;
+  temperature = data[2];
+  if (data[3] & 0x80) {
+    temperature = -1 - temperature;
+  }
+  temperature += (data[3] & 0x0f) * 0.1f;
+  return true;
 }
 
 // MQ2Sensor Implementation
-MQ2Sensor::MQ2Sensor(String id, String name, int pin) 
+MQ2Sensor::MQ2Sensor(Symbol id, String name, int pin) 
   : BaseSensor(id, name, pin) {}
 
 void MQ2Sensor::init() {
   pinMode(_pin, INPUT);
-  Serial.println("MQ2 sensor initialized on pin " + String(_pin));
+  LOG_I("MQ2 sensor initialized on pin %d", _pin);
 }
 
 SensorReading MQ2Sensor::read() {
   SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "MQ2";
   reading.timestamp = millis();
   
   // Lectures multiples pour stabilité
@@ -103,7 +276,7 @@ SensorReading MQ2Sensor::read() {
                      (rawValue2 < 4080);
   
   if (!isConnected) {
-    Serial.println("MQ2 Sensor " + _id + ": Capteur déconnecté - pas de données");
+    LOG_W("MQ2 Sensor %s: Capteur déconnecté - pas de données", symbols.text(_id));
     reading.isValid = false;
   } else {
     // Utiliser la moyenne des 3 lectures
@@ -122,18 +295,16 @@ SensorReading MQ2Sensor::read() {
 }
 
 // ASCSensor Implementation
-ASCSensor::ASCSensor(String id, String name, int pin) 
+ASCSensor::ASCSensor(Symbol id, String name, int pin) 
   : BaseSensor(id, name, pin), _sensitivity(0.1), _voltage(3.3) {}
 
 void ASCSensor::init() {
   pinMode(_pin, INPUT);
-  Serial.println("ASC sensor initialized on pin " + String(_pin));
+  LOG_I("ASC sensor initialized on pin %d", _pin);
 }
 
 SensorReading ASCSensor::read() {
   SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "ASC";
   reading.timestamp = millis();
   
   // Lectures multiples pour stabilité
@@ -154,7 +325,7 @@ SensorReading ASCSensor::read() {
                      (rawValue2 < 4080);
   
   if (!isConnected) {
-    Serial.println("ASC Sensor " + _id + ": Capteur déconnecté - pas de données");
+    LOG_W("ASC Sensor %s: Capteur déconnecté - pas de données", symbols.text(_id));
     reading.isValid = false;
   } else {
     // Utiliser la moyenne des 3 lectures
@@ -178,18 +349,16 @@ SensorReading ASCSensor::read() {
 }
 
 // LDRSensor Implementation
-LDRSensor::LDRSensor(String id, String name, int pin) 
+LDRSensor::LDRSensor(Symbol id, String name, int pin) 
   : BaseSensor(id, name, pin) {}
 
 void LDRSensor::init() {
   pinMode(_pin, INPUT);
-  Serial.println("LDR sensor initialized on pin " + String(_pin));
+  LOG_I("LDR sensor initialized on pin %d", _pin);
 }
 
 SensorReading LDRSensor::read() {
   SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "LDR";
   reading.timestamp = millis();
   
   // Lectures multiples pour stabilité
@@ -210,7 +379,7 @@ SensorReading LDRSensor::read() {
                      (rawValue2 < 4080);
   
   if (!isConnected) {
-    Serial.println("LDR Sensor " + _id + ": Capteur déconnecté - pas de données");
+    LOG_W("LDR Sensor %s: Capteur déconnecté - pas de données", symbols.text(_id));
     reading.isValid = false;
   } else {
     // Utiliser la moyenne des 3 lectures
@@ -229,19 +398,17 @@ SensorReading LDRSensor::read() {
 }
 
 // PIRSensor Implementation
-PIRSensor::PIRSensor(String id, String name, int pin) 
+PIRSensor::PIRSensor(Symbol id, String name, int pin) 
   : BaseSensor(id, name, pin), _lastState(false) {}
 
 void PIRSensor::init() {
   pinMode(_pin, INPUT);
   _lastState = digitalRead(_pin);
-  Serial.println("PIR sensor initialized on pin " + String(_pin));
+  LOG_I("PIR sensor initialized on pin %d", _pin);
 }
 
 SensorReading PIRSensor::read() {
   SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "PIR";
   reading.timestamp = millis();
   
   bool currentState = digitalRead(_pin);
@@ -254,19 +421,17 @@ SensorReading PIRSensor::read() {
 }
 
 // ButtonSensor Implementation
-ButtonSensor::ButtonSensor(String id, String name, int pin) 
+ButtonSensor::ButtonSensor(Symbol id, String name, int pin) 
   : BaseSensor(id, name, pin), _lastState(true), _debounceTime(50), _lastDebounceTime(0) {}
 
 void ButtonSensor::init() {
   pinMode(_pin, INPUT_PULLUP);
   _lastState = digitalRead(_pin);
-  Serial.println("Button sensor initialized on pin " + String(_pin));
+  LOG_I("Button sensor initialized on pin %d", _pin);
 }
 
 SensorReading ButtonSensor::read() {
   SensorReading reading;
-  reading.sensorId = _id;
-  reading.type = "BUTTON";
   reading.timestamp = millis();
   
   bool currentState = digitalRead(_pin);
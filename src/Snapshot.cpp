@@ -0,0 +1,47 @@
+#include "Snapshot.h"
+
+ReadingSnapshot::ReadingSnapshot() : _generation(0) {
+  for (int i = 0; i < MAX_SENSOR_SLOTS; i++) {
+    _seq[i].store(0, std::memory_order_relaxed);
+    _data[i] = PublishedReading();
+  }
+}
+
+void ReadingSnapshot::publish(int slot, const SensorReading& reading) {
+  if (slot < 0 || slot >= MAX_SENSOR_SLOTS) return;
+
+  // Séquence impaire pendant l'écriture
+  uint32_t seq = _seq[slot].load(std::memory_order_relaxed);
+  _seq[slot].store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  PublishedReading& data = _data[slot];
+  data.temperature = reading.temperature;
+  data.humidity = reading.humidity;
+  data.gas = reading.gas;
+  data.current = reading.current;
+  data.light = reading.light;
+  data.motion = reading.motion;
+  data.pressed = reading.pressed;
+  data.isValid = reading.isValid;
+  data.timestamp = reading.timestamp;
+
+  _seq[slot].store(seq + 2, std::memory_order_release);
+  _generation.fetch_add(1, std::memory_order_release);
+}
+
+bool ReadingSnapshot::read(int slot, PublishedReading& out) const {
+  if (slot < 0 || slot >= MAX_SENSOR_SLOTS) return false;
+
+  for (;;) {
+    uint32_t before = _seq[slot].load(std::memory_order_acquire);
+    if (before & 1) continue; // Publication en cours
+
+    out = _data[slot];
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (_seq[slot].load(std::memory_order_relaxed) == before) {
+      return out.isValid;
+    }
+  }
+}
@@ -1,9 +1,14 @@
 #include "StatusLED.h"
+#include "Log.h"
 
 StatusLED::StatusLED(int redPin, int greenPin, int bluePin) 
   : _redPin(redPin), _greenPin(greenPin), _bluePin(bluePin),
     _currentStatus(LEDStatus::SYSTEM_NORMAL_IDLE), _blinkState(false), 
-    _lastBlink(0), _blinkInterval(500) {}
+    _lastBlink(0), _blinkInterval(500), _blinkTimer(onBlinkTimer, this) {}
+
+void StatusLED::onBlinkTimer(void* context) {
+  static_cast<StatusLED*>(context)->update();
+}
 
 void StatusLED::init() {
   pinMode(_redPin, OUTPUT);
@@ -15,28 +20,31 @@ void StatusLED::init() {
   delay(300);
   setBlue();
   
-  Serial.println("Status LED initialized on pins R:" + String(_redPin) + 
-                 " G:" + String(_greenPin) + " B:" + String(_bluePin));
+  LOG_I("Status LED initialized on pins R:%d G:%d B:%d", _redPin, _greenPin, _bluePin);
 }
 
 void StatusLED::setStatus(LEDStatus status) {
   if (_currentStatus != status) {
     _currentStatus = status;
+    scheduler.cancel(_blinkTimer);
     
     switch (status) {
       case LEDStatus::SYSTEM_NORMAL_IDLE:
-        Serial.println("Status LED: BLUE - System normal, no actuators active");
+        LOG_I("Status LED: BLUE - System normal, no actuators active");
         setBlue();
         break;
         
       case LEDStatus::SYSTEM_NORMAL_ACTIVE:
-        Serial.println("Status LED: GREEN - System normal, actuator(s) active");
+        LOG_I("Status LED: GREEN - System normal, actuator(s) active");
         setGreen();
         break;
         
       case LEDStatus::ALARM_ACTIVE:
-        Serial.println("Status LED: RED - ALARM ACTIVE");
+        LOG_W("Status LED: RED - ALARM ACTIVE");
         setRed();
+        _blinkState = true;
+        _lastBlink = millis();
+        scheduler.schedule(_blinkTimer, _lastBlink + _blinkInterval);
         break;
     }
   }
@@ -55,6 +63,7 @@ void StatusLED::update() {
         setOff();
       }
     }
+    scheduler.schedule(_blinkTimer, _lastBlink + _blinkInterval);
   }
 }
 
@@ -0,0 +1,126 @@
+#include "Symbols.h"
+#include <string.h>
+
+SymbolTable symbols;
+
+namespace {
+
+const char* const predefinedText[] = {
+  "",
+  "sensor", "actuator",
+  "DHT11", "MQ2", "ASC", "LDR", "PIR", "BUTTON",
+  "RELAY", "BUZZER",
+  "temperature", "humidity", "gas", "current", "light", "motion", "pressed",
+  ">", "<", "==", ">=", "<=",
+  "AND", "OR",
+  "turn_on", "turn_off", "toggle",
+  "alarm", "beep",
+  "sensor_threshold", "sensor_combination", "critical_event", "schedule",
+};
+
+static_assert(sizeof(predefinedText) / sizeof(predefinedText[0]) == PREDEFINED_SYMBOLS,
+              "predefinedText must list every predefined symbol");
+
+uint32_t hashText(const char* text, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+  }
+  return hash;
+}
+
+}
+
+SymbolTable::SymbolTable() : _count(0), _text(nullptr), _textUsed(0), _bytes(0) {
+  for (size_t i = 0; i < MAX_BLOCKS; i++) _blocks[i] = nullptr;
+  _index.assign(128, SYMBOL_UNKNOWN);
+  for (size_t i = 0; i < PREDEFINED_SYMBOLS; i++) {
+    intern(predefinedText[i]);
+  }
+}
+
+uint32_t SymbolTable::fingerprint(const char* text) {
+  if (!text) text = "";
+  return hashText(text, strlen(text));
+}
+
+Symbol SymbolTable::lookup(const char* text, size_t length, uint32_t hash, size_t& position) const {
+  size_t mask = _index.size() - 1;
+  size_t count = _count.load(std::memory_order_relaxed);
+  for (position = hash & mask;; position = (position + 1) & mask) {
+    Symbol symbol = _index[position];
+    if (symbol == SYMBOL_UNKNOWN) return SYMBOL_UNKNOWN;
+    if (symbol < count) {
+      const char* candidate = _blocks[symbol / BLOCK_SYMBOLS][symbol % BLOCK_SYMBOLS];
+      if (strncmp(candidate, text, length) == 0 && candidate[length] == '\0') return symbol;
+    }
+  }
+}
+
+Symbol SymbolTable::find(const char* text) const {
+  if (!text) text = "";
+  std::lock_guard<std::mutex> lock(_mutex);
+  size_t length = strlen(text);
+  size_t position;
+  return lookup(text, length, hashText(text, length), position);
+}
+
+Symbol SymbolTable::intern(const char* text) {
+  if (!text) text = "";
+  std::lock_guard<std::mutex> lock(_mutex);
+  size_t length = strlen(text);
+  uint32_t hash = hashText(text, length);
+  size_t position;
+  Symbol found = lookup(text, length, hash, position);
+  if (found != SYMBOL_UNKNOWN) return found;
+
+  size_t count = _count.load(std::memory_order_relaxed);
+  if (count >= MAX_BLOCKS * BLOCK_SYMBOLS || length >= TEXT_BLOCK_SIZE) return SYMBOL_UNKNOWN;
+
+  // Texte recopié dans le bloc courant, ou dans un nouveau bloc s'il n'y tient plus
+  if (!_text || _textUsed + length + 1 > TEXT_BLOCK_SIZE) {
+    char* block = (char*)malloc(TEXT_BLOCK_SIZE);
+    if (!block) return SYMBOL_UNKNOWN;
+    _text = block;
+    _textUsed = 0;
+  }
+  char* stored = _text + _textUsed;
+  memcpy(stored, text, length + 1);
+  _textUsed += length + 1;
+  _bytes += length + 1;
+
+  const char**& block = _blocks[count / BLOCK_SYMBOLS];
+  if (!block) {
+    block = (const char**)malloc(BLOCK_SYMBOLS * sizeof(const char*));
+    if (!block) return SYMBOL_UNKNOWN;
+  }
+  block[count % BLOCK_SYMBOLS] = stored;
+
+  // Publication : text() ne voit le symbole qu'une fois son texte en place
+  Symbol symbol = count;
+  _count.store(count + 1, std::memory_order_release);
+  _index[position] = symbol;
+
+  // Facteur de charge maximal 1/2
+  if ((count + 1) * 2 > _index.size()) grow();
+  return symbol;
+}
+
+void SymbolTable::grow() {
+  std::vector<Symbol> previous;
+  previous.swap(_index);
+  _index.assign(previous.size() * 2, SYMBOL_UNKNOWN);
+  size_t mask = _index.size() - 1;
+  for (Symbol symbol : previous) {
+    if (symbol == SYMBOL_UNKNOWN) continue;
+    const char* stored = text(symbol);
+    size_t position = hashText(stored, strlen(stored)) & mask;
+    while (_index[position] != SYMBOL_UNKNOWN) position = (position + 1) & mask;
+    _index[position] = symbol;
+  }
+}
+
+const char* SymbolTable::text(Symbol symbol) const {
+  if (symbol >= _count.load(std::memory_order_acquire)) return "";
+  return _blocks[symbol / BLOCK_SYMBOLS][symbol % BLOCK_SYMBOLS];
+}
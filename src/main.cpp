@@ -1,18 +1,47 @@
 #include <Arduino.h>
 #include <WiFi.h>
-#include <WebServer.h>
 #include <SPIFFS.h>
 #include <DNSServer.h>
 #include <ArduinoJson.h>
 #include <vector>
-#include <map>
+#include <atomic>
+#include <algorithm>
 #include "Config.h"
 #include "Sensor.h"
 #include "Actuator.h"
 #include "StatusLED.h"
+#include "Snapshot.h"
+#include "Scheduler.h"
+#include "Log.h"
+#include "AssetBundle.h"
+#include "JsonArena.h"
+#include "History.h"
+#include "FlashLog.h"
+#include "LatencyHistogram.h"
+#include "EngineMetrics.h"
+#include "Symbols.h"
+#include "DeviceRegistry.h"
+
+// HTTP_LEGACY_SERVER : ancien WebServer synchrone, conservé pour comparaison
+#ifdef HTTP_LEGACY_SERVER
+#include <WebServer.h>
+#include <StreamString.h>
+#include <uri/UriBraces.h>
+#else
+#include "HttpServer.h"
+#endif
+
+// Port de l'interface web (8080 pour env:native, sans privilèges)
+#ifndef HTTP_PORT
+  #define HTTP_PORT 80
+#endif
 
 // Global objects
-WebServer server(80);
+#ifdef HTTP_LEGACY_SERVER
+WebServer server(HTTP_PORT);
+#else
+HttpServer server(HTTP_PORT);
+#endif
 DNSServer dnsServer;
 Config config;
 
@@ -20,6 +49,12 @@ Config config;
 std::vector<BaseSensor*> sensors;
 std::vector<BaseActuator*> actuators;
 
+// Capteur associé à chaque index de lecture (fixé au démarrage)
+BaseSensor* sensorSlots[MAX_SENSOR_SLOTS] = {nullptr};
+
+// Actionneur associé à chaque index d'action compilée (fixé au démarrage)
+BaseActuator* actuatorSlots[MAX_ACTUATOR_SLOTS] = {nullptr};
+
 // Status LED (pins RGB)
 StatusLED statusLED(25, 26, 27); // Rouge=25, Vert=26, Bleu=27
 
@@ -29,49 +64,269 @@ String currentUser = "";
 unsigned long lastSensorRead = 0;
 const unsigned long sensorReadInterval = 1000;
 
+// Pipeline multi-cœur : capteurs et règles sur APP_CPU, WiFi/DNS/HTTP sur PRO_CPU
+const BaseType_t controlCore = 1;
+const BaseType_t webCore = 0;
+TaskHandle_t controlTaskHandle = nullptr;
+TaskHandle_t webTaskHandle = nullptr;
+
+// Commandes envoyées par la tâche web à la tâche de contrôle
+enum class CommandType : uint8_t { ACTUATOR, APPLY_CONFIG };
+enum class ActuatorCommand : uint8_t { TURN_ON, TURN_OFF, TOGGLE };
+
+struct ControlCommand {
+  CommandType type;
+  uint8_t actuatorIndex;
+  ActuatorCommand action;
+  Config* config;         // APPLY_CONFIG : configuration validée, échangée avec l'actuelle
+  TaskHandle_t requester; // Notifiée une fois la commande appliquée
+};
+
+QueueHandle_t commandQueue = nullptr;
+const TickType_t commandTimeout = pdMS_TO_TICKS(500);
+
+// Configuration modifiée par l'API : écrite à côté de l'actuelle, elle ne
+// remplace /configuration.json qu'une fois chargée et appliquée
+const char* configPath = "/configuration.json";
+const char* pendingConfigPath = "/configuration.new";
+
+// Lectures publiées pour les gestionnaires HTTP, qui ne bloquent jamais le contrôle
+ReadingSnapshot readingSnapshot;
+
+// Fichiers statiques décrits par /assets.json (tools/compress_assets.py)
+struct StaticAsset {
+  String path;
+  String etag;
+  bool gzip;
+};
+std::vector<StaticAsset> staticAssets;
+
+// Durée de cache navigateur des fichiers statiques hors HTML (secondes)
+#ifndef STATIC_MAX_AGE
+  #define STATIC_MAX_AGE 86400
+#endif
+
+// État des actionneurs (un bit par index), publié par la tâche de contrôle
+static_assert(MAX_ACTUATOR_SLOTS <= 32, "actuatorStates holds one bit per actuator slot");
+std::atomic<uint32_t> actuatorStates(0);
+
+#ifndef HTTP_LEGACY_SERVER
+// Dernier état diffusé aux abonnés de /api/events (tâche web uniquement)
+uint32_t pushedGeneration = 0;
+PublishedReading pushedReadings[MAX_SENSOR_SLOTS];
+uint32_t pushedActuatorStates = 0;
+#endif
+
+// Réponses JSON de l'API (tâche web uniquement) : un document réutilisé, alloué
+// dans une arène fixe, et sérialisé directement vers la socket
+JsonArena jsonArena;
+JsonDocument responseDoc(&jsonArena);
+#ifdef HTTP_LEGACY_SERVER
+StreamString legacyResponse;
+const char* legacyContentType = "application/json";
+#endif
+
+// Historique compressé des mesures (tâche web uniquement) : une série par
+// grandeur mesurée, alimentée à partir des lectures publiées
+enum class ReadingField : uint8_t { TEMPERATURE, HUMIDITY, GAS, CURRENT, LIGHT, MOTION, PRESSED };
+
+struct HistoryField {
+  Symbol model;
+  ReadingField field;
+  const char* name;
+};
+
+const HistoryField historyFields[] = {
+  { SYM_DHT11,  ReadingField::TEMPERATURE, "temperature" },
+  { SYM_DHT11,  ReadingField::HUMIDITY,    "humidity" },
+  { SYM_MQ2,    ReadingField::GAS,         "gas" },
+  { SYM_ASC,    ReadingField::CURRENT,     "current" },
+  { SYM_LDR,    ReadingField::LIGHT,       "light" },
+  { SYM_PIR,    ReadingField::MOTION,      "motion" },
+  { SYM_BUTTON, ReadingField::PRESSED,     "pressed" },
+};
+
+const int MAX_SENSOR_CHANNELS = 2;
+
+struct SensorHistory {
+  uint8_t channels;
+  int8_t series[MAX_SENSOR_CHANNELS];
+  const HistoryField* fields[MAX_SENSOR_CHANNELS];
+  unsigned long lastTimestamp;
+  unsigned long persistedAt;              // Dernière lecture écrite dans le journal flash
+  float persisted[MAX_SENSOR_CHANNELS];
+};
+
+History history;
+SensorHistory sensorHistory[MAX_SENSOR_SLOTS];
+uint32_t historyGeneration = 0;
+
+// Journal flash des lectures et événements (écrit par la tâche web) ; la
+// tâche de contrôle y dépose ses événements par une file, sans attendre
+FlashLog flashLog;
+
+// Source par son symbole, stable pendant tout le démarrage : l'empreinte
+// est calculée par la tâche web
+struct LoggedEvent {
+  FlashRecordType type;
+  Symbol source;
+  uint8_t state;
+  uint32_t time;
+};
+
+QueueHandle_t eventQueue = nullptr;
+
+// Une lecture par capteur et par intervalle dans le journal ; les entrées
+// tout-ou-rien (mouvement, bouton) sont aussi écrites à chaque changement
+#ifndef FLASH_LOG_READING_INTERVAL_MS
+  #define FLASH_LOG_READING_INTERVAL_MS 60000
+#endif
+
+// Fenêtre de /api/history sans paramètre from
+const uint32_t defaultHistoryWindow = 3600000UL;
+
+// Mesures de latence du pipeline
+struct PipelineStats {
+  volatile uint32_t lastSampleMicros;       // Horodatage de la dernière lecture stockée
+  volatile uint32_t lastActuationUs;        // Lecture -> écriture actionneur (dernière)
+  volatile uint32_t maxActuationUs;         // Lecture -> écriture actionneur (max)
+  volatile uint32_t maxSampleLatenessMs;    // Retard max d'une lecture sur son échéance
+};
+PipelineStats pipelineStats = {0, 0, 0, 0};
+
+// Durée de chaque étape des boucles de contrôle et web, et de chaque
+// scrutation de capteur, en cycles CPU (voir /api/system/latency)
+enum class LoopStage : uint8_t {
+  SCHEDULER, RULES, STATUS_LED, PUBLISH,  // controlTask
+  DNS, HTTP, EVENTS, HISTORY, FLASH_LOG,  // webTask
+  COUNT
+};
+
+const char* const loopStageNames[] = {
+  "control.scheduler", "control.rules", "control.statusLed", "control.publish",
+  "web.dns", "web.http", "web.events", "web.history", "web.flashLog",
+};
+
+LatencyHistogram stageLatency[(int)LoopStage::COUNT];
+LatencyHistogram sensorLatency[MAX_SENSOR_SLOTS];  // Écrit par la tâche de contrôle
+
+inline uint32_t recordStage(LoopStage stage, uint32_t start) {
+  return stageLatency[(int)stage].recordSince(start);
+}
+
+// Compteurs du moteur exposés par /metrics (EngineMetrics.h)
+EngineMetrics engineMetrics = {};
+
+// Enregistrements modifiables un à un par l'API REST
+enum class ResourceKind : uint8_t { DEVICE, RULE };
+
 // Function prototypes
 void initWiFi();
 void initSPIFFS();
 void initDevices();
+BaseSensor* createSensor(const DeviceConfig& deviceConfig);
+BaseActuator* createActuator(const DeviceConfig& deviceConfig);
+void reconfigure(Config& next);
+void applyConfig(Config& next);
+void recoverPendingConfig();
+void remapWebState(const Symbol* previousIds);
 void initWebServer();
 void handleRoot();
 void handleLogin();
 void handleAPI();
 void handleDevices();
 void handleSensorData();
+void writeSensorData(Print& out);
+void handleEvents();
+void pushEvents();
+void serializeReading(JsonObject sensorObj, const BaseSensor* sensor, const PublishedReading& reading);
+Print& beginStreamedResponse(const char* contentType);
+void endStreamedResponse();
+void publishActuatorStates();
+uint32_t currentActuatorStates();
 void handleActuatorControl();
 void handleConfig();
+void handleDeviceResource();
+void handleRuleResource();
+void handleResource(ResourceKind kind);
+void mergePatch(JsonObject target, JsonObjectConst patch);
+void sendValidationError(const char* error);
+#ifdef HTTP_LEGACY_SERVER
+String requestBody();
+#else
+const String& requestBody();
+#endif
 void handleSystemStats();
+void handleLatencyStats();
+void handleMetrics();
+void writeMetricHeader(Print& out, const char* name, const char* type, const char* help);
+void writeLabelValue(Print& out, const char* value);
+void writeLatency(JsonObject obj, const LatencyHistogram& histogram, float cyclesPerUs);
+void handleHistory();
+void initHistory();
+void recordHistory();
+void initFlashLog();
+void persistReading(int slot, SensorHistory& entry, const PublishedReading& reading);
+void persistEvents();
+void logEvent(FlashRecordType type, Symbol source, uint8_t state);
+void handleLogExport();
+float readingValue(const PublishedReading& reading, ReadingField field);
 void handleNotFound();
-void updateSensors();
+void loadStaticAssets();
+bool serveStatic(const String& path);
+bool sendCacheValidators(const String& path, const String& etag, bool varies);
+void updateSensor(BaseSensor* sensor);
+void storeReading(BaseSensor* sensor, const SensorReading& reading);
+void onSensorTimer(void* context);
+void onScheduleTimer(void* context);
+TickType_t timeUntilNextDeadline();
 void processRules();
+void markDependentRulesDirty(int slot);
 void updateStatusLED();
-void evaluateRule(const RuleConfig& rule);
-bool evaluateConditions(const std::vector<Condition>& conditions, const std::map<String, SensorReading>& readings);
-bool evaluateSchedule(const Schedule& schedule);
-void executeActions(const std::vector<Action>& actions);
+void evaluateRule(size_t index, const RuleConfig& rule, const CompiledRule& program);
+bool evaluateConditions(const CompiledCondition* program, const ArenaVector<Condition>& conditions);
+bool evaluateSchedule(const CompiledRule& program);
+void executeActions(const CompiledAction* actions, uint16_t count);
 String getContentType(String filename);
 bool checkAuthentication();
+void controlTask(void* parameter);
+void webTask(void* parameter);
+void processCommands(TickType_t wait);
+bool sendCommand(const ControlCommand& command, TickType_t timeout = commandTimeout);
+void recordActuation();
 
-// Sensor readings storage
-std::map<String, SensorReading> latestReadings;
+// Sensor readings storage : une case par capteur, indexée par BaseSensor::getSlot()
+// La validité est portée par SensorReading::isValid, aucune allocation après le démarrage
+SensorReading sensorReadings[MAX_SENSOR_SLOTS];
+
+// Règles à réévaluer (nouvelle lecture d'un capteur dont elles dépendent)
+std::vector<uint8_t> dirtyRules;
+
+// Dernier état de chaque règle, pour ne journaliser que les transitions
+std::vector<uint8_t> activeRules;
+const unsigned long scheduleCheckInterval = 1000;
+Timer scheduleTimer(onScheduleTimer, nullptr);
 
 void setup() {
   Serial.begin(115200);
-  Serial.println("OPENDOM System Starting...");
+  Log::begin();
+  LOG_I("OPENDOM System Starting...");
   
   // Initialize SPIFFS
   initSPIFFS();
   
   // Load configuration
-  if (!config.loadFromFile("/configuration.json")) {
-    Serial.println("Failed to load configuration!");
+  recoverPendingConfig();
+  if (!config.loadFromFile(configPath)) {
+    LOG_E("Failed to load configuration!");
     return;
   }
   config.printConfig();
   
   // Initialize devices
   initDevices();
+  initHistory();
+  initFlashLog();
   
   // Initialize status LED
   statusLED.init();
@@ -82,127 +337,401 @@ void setup() {
   // Initialize web server
   initWebServer();
   
-  Serial.println("OPENDOM System Ready!");
-  Serial.println("Connect to WiFi: " + config.system.wifi.ssid);
-  Serial.println("Password: " + config.system.wifi.password);
-  Serial.println("Access interface at: http://192.168.4.1");
+  // Vérification périodique des règles horaires
+  scheduler.schedule(scheduleTimer, millis());
+  
+  // Start the control and web pipelines on separate cores
+  commandQueue = xQueueCreate(8, sizeof(ControlCommand));
+  eventQueue = xQueueCreate(32, sizeof(LoggedEvent));
+  xTaskCreatePinnedToCore(controlTask, "control", 8192, nullptr, 2, &controlTaskHandle, controlCore);
+  xTaskCreatePinnedToCore(webTask, "web", 8192, nullptr, 1, &webTaskHandle, webCore);
+  
+  LOG_I("OPENDOM System Ready!");
+  LOG_I("Connect to WiFi: %s", config.system.wifi.ssid);
+  LOG_I("Password: %s", config.system.wifi.password);
+  LOG_I("Access interface at: http://192.168.4.1");
 }
 
 void loop() {
-  // Handle DNS requests (captive portal)
-  dnsServer.processNextRequest();
-  
-  // Handle web server requests
-  server.handleClient();
-  
-  // Update sensors
-  updateSensors();
-  
-  // Process automation rules
-  processRules();
-  
-  // Update status LED
-  updateStatusLED();
-  statusLED.update();
+  // Le travail est réparti entre controlTask et webTask
+  vTaskDelete(nullptr);
+}
+
+void controlTask(void* parameter) {
+  for (;;) {
+    uint32_t start = ESP.getCycleCount();
+    
+    // Déclencher les échéances : scrutation des capteurs, durées des relais,
+    // motifs du buzzer et clignotement de la LED
+    scheduler.advance(millis());
+    start = recordStage(LoopStage::SCHEDULER, start);
+    
+    // Process automation rules
+    processRules();
+    start = recordStage(LoopStage::RULES, start);
+    
+    // Update status LED
+    updateStatusLED();
+    start = recordStage(LoopStage::STATUS_LED, start);
+    
+    // Rendre visibles les changements d'état aux abonnés web
+    publishActuatorStates();
+    recordStage(LoopStage::PUBLISH, start);
+    
+    // Dormir jusqu'à la prochaine échéance ou une commande web
+    processCommands(timeUntilNextDeadline());
+  }
+}
+
+TickType_t timeUntilNextDeadline() {
+  uint32_t deadline;
+  if (!scheduler.nextDeadline(deadline)) {
+    return portMAX_DELAY;
+  }
+  int32_t remaining = (int32_t)(deadline - millis());
+  return (remaining > 0) ? pdMS_TO_TICKS(remaining) : 0;
+}
+
+void webTask(void* parameter) {
+  for (;;) {
+    uint32_t start = ESP.getCycleCount();
+    
+    // Handle DNS requests (captive portal)
+    dnsServer.processNextRequest();
+    start = recordStage(LoopStage::DNS, start);
+    
+    // Handle web server requests
+#ifdef HTTP_LEGACY_SERVER
+    server.handleClient();
+    recordStage(LoopStage::HTTP, start);
+    vTaskDelay(1);
+    start = ESP.getCycleCount();
+#else
+    // select() borné pour laisser passer les requêtes DNS ; l'attente n'est
+    // pas comptée dans la durée de l'étape
+    server.handleClient(10);
+    start = recordStage(LoopStage::HTTP, server.wakeCycles());
+    
+    // Diffuser les lectures et états qui ont changé
+    pushEvents();
+    start = recordStage(LoopStage::EVENTS, start);
+#endif
+    
+    // Archiver les nouvelles lectures et les événements de la tâche de contrôle
+    recordHistory();
+    start = recordStage(LoopStage::HISTORY, start);
+    persistEvents();
+    flashLog.loop(millis());
+    recordStage(LoopStage::FLASH_LOG, start);
+  }
+}
+
+void processCommands(TickType_t wait) {
+  ControlCommand command;
   
-  // Update actuators (for timed operations)
-  for (auto* actuator : actuators) {
-    RelayActuator* relay = static_cast<RelayActuator*>(actuator);
-    BuzzerActuator* buzzer = static_cast<BuzzerActuator*>(actuator);
-    
-    // Check actuator type and update accordingly
-    for (const auto& deviceConfig : config.devices) {
-      if (deviceConfig.id == actuator->getId()) {
-        if (deviceConfig.actuatorType == "RELAY") {
-          relay = static_cast<RelayActuator*>(actuator);
-          relay->update();
-        } else if (deviceConfig.actuatorType == "BUZZER") {
-          buzzer = static_cast<BuzzerActuator*>(actuator);
-          buzzer->update();
-        }
-        break;
+  // Attendre au plus wait, puis vider les commandes déjà en file
+  while (xQueueReceive(commandQueue, &command, wait) == pdTRUE) {
+    wait = 0;
+    
+    if (command.type == CommandType::ACTUATOR && command.actuatorIndex < actuators.size()) {
+      BaseActuator* actuator = actuators[command.actuatorIndex];
+      switch (command.action) {
+        case ActuatorCommand::TURN_ON:  actuator->turnOn(); break;
+        case ActuatorCommand::TURN_OFF: actuator->turnOff(); break;
+        case ActuatorCommand::TOGGLE:   actuator->toggle(); break;
       }
+    } else if (command.type == CommandType::APPLY_CONFIG && command.config) {
+      reconfigure(*command.config);
+    }
+    
+    if (command.requester) {
+      xTaskNotifyGive(command.requester);
     }
   }
+}
+
+bool sendCommand(const ControlCommand& command, TickType_t timeout) {
+  ControlCommand queued = command;
+  queued.requester = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, 0);
   
-  delay(10);
+  if (xQueueSend(commandQueue, &queued, timeout) != pdTRUE) {
+    return false;
+  }
+  return ulTaskNotifyTake(pdTRUE, timeout) > 0;
+}
+
+void recordActuation() {
+  uint32_t latency = micros() - pipelineStats.lastSampleMicros;
+  pipelineStats.lastActuationUs = latency;
+  if (latency > pipelineStats.maxActuationUs) {
+    pipelineStats.maxActuationUs = latency;
+  }
 }
 
 void initSPIFFS() {
   if (!SPIFFS.begin(true)) {
-    Serial.println("SPIFFS initialization failed!");
+    LOG_E("SPIFFS initialization failed!");
     return;
   }
-  Serial.println("SPIFFS initialized successfully");
+  LOG_I("SPIFFS initialized successfully");
 }
 
 void initWiFi() {
   WiFi.mode(WIFI_AP);
-  WiFi.softAP(config.system.wifi.ssid.c_str(), config.system.wifi.password.c_str());
+  WiFi.softAP(config.system.wifi.ssid, config.system.wifi.password);
   
   IPAddress IP = WiFi.softAPIP();
-  Serial.println("WiFi AP started");
-  Serial.print("IP address: ");
-  Serial.println(IP);
+  LOG_I("WiFi AP started");
+  LOG_I("IP address: %s", IP.toString().c_str());
   
   // Start DNS server for captive portal
   if (config.system.captivePortal) {
     dnsServer.start(53, "*", IP);
-    Serial.println("Captive portal DNS started");
+    LOG_I("Captive portal DNS started");
   }
 }
 
 void initDevices() {
-  Serial.println("Initializing devices...");
+  LOG_I("Initializing devices...");
   
-  // Initialize sensors
   for (const auto& deviceConfig : config.devices) {
-    if (deviceConfig.type == "sensor" && deviceConfig.enabled) {
-      BaseSensor* sensor = nullptr;
-      
-      if (deviceConfig.sensorType == "DHT11") {
-        sensor = new DHT11Sensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.sensorType == "MQ2") {
-        sensor = new MQ2Sensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.sensorType == "ASC") {
-        sensor = new ASCSensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.sensorType == "LDR") {
-        sensor = new LDRSensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.sensorType == "PIR") {
-        sensor = new PIRSensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.sensorType == "BUTTON") {
-        sensor = new ButtonSensor(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      }
-      
+    // Initialize sensors
+    if (deviceConfig.type == SYM_SENSOR && deviceConfig.enabled) {
+      BaseSensor* sensor = createSensor(deviceConfig);
       if (sensor) {
-        sensor->setReadInterval(deviceConfig.readInterval);
-        sensor->init();
         sensors.push_back(sensor);
+        if (deviceConfig.slot >= 0) sensorSlots[deviceConfig.slot] = sensor;
       }
     }
     
     // Initialize actuators
-    if (deviceConfig.type == "actuator" && deviceConfig.enabled) {
-      BaseActuator* actuator = nullptr;
-      
-      if (deviceConfig.actuatorType == "RELAY") {
-        actuator = new RelayActuator(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      } else if (deviceConfig.actuatorType == "BUZZER") {
-        actuator = new BuzzerActuator(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
-      }
-      
+    if (deviceConfig.type == SYM_ACTUATOR && deviceConfig.enabled) {
+      BaseActuator* actuator = createActuator(deviceConfig);
       if (actuator) {
-        actuator->init();
-        actuator->setState(deviceConfig.state);
         actuators.push_back(actuator);
+        if (deviceConfig.slot >= 0) actuatorSlots[deviceConfig.slot] = actuator;
+      }
+    }
+  }
+  
+  LOG_I("Devices initialized: %u sensors, %u actuators", (unsigned)sensors.size(), (unsigned)actuators.size());
+}
+
+// Modèle cherché dans le registre (src/DeviceRegistry.cpp), objet placé
+// dans la réserve statique du modèle
+BaseSensor* createSensor(const DeviceConfig& deviceConfig) {
+  const SensorDriver* driver = findSensorDriver(deviceConfig.sensorType);
+  if (!driver) {
+    LOG_W("Unknown sensor type: %s", symbols.text(deviceConfig.sensorType));
+    return nullptr;
+  }
+  BaseSensor* sensor = driver->create(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
+  if (!sensor) {
+    LOG_W("Sensor pool full (%u %s), ignoring: %s", (unsigned)driver->capacity,
+          symbols.text(driver->model), symbols.text(deviceConfig.id));
+    return nullptr;
+  }
+  
+  sensor->setReadInterval(deviceConfig.readInterval);
+  sensor->setSlot(deviceConfig.slot);
+  sensor->init();
+  
+  // Première scrutation immédiate, les suivantes selon nextPollDelay()
+  sensor->timer().callback = onSensorTimer;
+  sensor->timer().context = sensor;
+  scheduler.schedule(sensor->timer(), millis());
+  return sensor;
+}
+
+BaseActuator* createActuator(const DeviceConfig& deviceConfig) {
+  const ActuatorDriver* driver = findActuatorDriver(deviceConfig.actuatorType);
+  if (!driver) {
+    LOG_W("Unknown actuator type: %s", symbols.text(deviceConfig.actuatorType));
+    return nullptr;
+  }
+  BaseActuator* actuator = driver->create(deviceConfig.id, deviceConfig.name, deviceConfig.pin);
+  if (!actuator) {
+    LOG_W("Actuator pool full (%u %s), ignoring: %s", (unsigned)driver->capacity,
+          symbols.text(driver->model), symbols.text(deviceConfig.id));
+    return nullptr;
+  }
+  
+  actuator->init();
+  actuator->setState(deviceConfig.state);
+  return actuator;
+}
+
+// Position dans devices d'un dispositif actif de même identifiant, type et
+// broche, ou -1 s'il doit être reconstruit
+int findUnchangedDevice(const Config& next, Symbol id, Symbol type, Symbol model, int pin) {
+  for (size_t i = 0; i < next.devices.size(); i++) {
+    const DeviceConfig& device = next.devices[i];
+    if (device.id != id) continue;
+    Symbol deviceModel = (device.type == SYM_SENSOR) ? device.sensorType : device.actuatorType;
+    if (device.type == type && device.enabled && deviceModel == model && device.pin == pin) return i;
+    return -1;
+  }
+  return -1;
+}
+
+// Même définition (déclencheur, conditions, actions, plage horaire) : une
+// règle active le reste après la reconfiguration, sans nouvelle activation
+bool sameConditions(const ArenaVector<Condition>& a, const ArenaVector<Condition>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].sensorId != b[i].sensorId || a[i].parameter != b[i].parameter || a[i].operator_ != b[i].operator_ ||
+        a[i].value != b[i].value || a[i].logic != b[i].logic) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool sameRule(const RuleConfig& a, const RuleConfig& b) {
+  if (a.id != b.id || a.enabled != b.enabled || a.triggerType != b.triggerType) return false;
+  if (!sameConditions(a.conditions, b.conditions) ||
+      !sameConditions(a.deactivationConditions, b.deactivationConditions)) {
+    return false;
+  }
+  if (a.actions.size() != b.actions.size()) return false;
+  for (size_t i = 0; i < a.actions.size(); i++) {
+    if (a.actions[i].actuatorId != b.actions[i].actuatorId || a.actions[i].action != b.actions[i].action ||
+        a.actions[i].duration != b.actions[i].duration || a.actions[i].pattern != b.actions[i].pattern) {
+      return false;
+    }
+  }
+  return strcmp(a.schedule.startTime, b.schedule.startTime) == 0 &&
+         strcmp(a.schedule.endTime, b.schedule.endTime) == 0 && a.schedule.days == b.schedule.days;
+}
+
+// Reconfiguration à chaud (tâche de contrôle) : seuls les dispositifs
+// ajoutés, retirés ou dont le modèle ou la broche a changé sont
+// reconstruits. Les autres gardent leur lecture en cache et leur état ;
+// leur échéance de scrutation aussi, sauf si l'intervalle a changé. Les
+// règles inchangées gardent leur état actif. La tâche web attend la fin de la commande et ne
+// touche pas aux dispositifs pendant ce temps.
+void reconfigure(Config& next) {
+  // Dispositifs conservés, indexés comme next.devices ; les autres sont
+  // détruits avant toute création (une broche ou un emplacement de réserve
+  // peut changer de propriétaire)
+  std::vector<BaseSensor*> keptSensors(next.devices.size(), nullptr);
+  std::vector<BaseActuator*> keptActuators(next.devices.size(), nullptr);
+  size_t removed = 0;
+  
+  for (BaseSensor* sensor : sensors) {
+    int index = findUnchangedDevice(next, sensor->getId(), SYM_SENSOR, sensor->getModel(), sensor->getPin());
+    if (index >= 0 && !keptSensors[index]) {
+      keptSensors[index] = sensor;
+    } else {
+      destroySensor(sensor);
+      removed++;
+    }
+  }
+  for (BaseActuator* actuator : actuators) {
+    int index = findUnchangedDevice(next, actuator->getId(), SYM_ACTUATOR, actuator->getModel(), actuator->getPin());
+    if (index >= 0 && !keptActuators[index]) {
+      keptActuators[index] = actuator;
+    } else {
+      actuator->turnOff();
+      destroyActuator(actuator);
+      removed++;
+    }
+  }
+  
+  // Les cases changent avec l'ordre des dispositifs : les lectures suivent leur capteur
+  std::vector<SensorReading> previousReadings(sensorReadings, sensorReadings + MAX_SENSOR_SLOTS);
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    sensorReadings[slot] = SensorReading();
+    sensorSlots[slot] = nullptr;
+    sensorLatency[slot].reset();
+  }
+  for (int slot = 0; slot < MAX_ACTUATOR_SLOTS; slot++) {
+    actuatorSlots[slot] = nullptr;
+  }
+  sensors.clear();
+  actuators.clear();
+  size_t added = 0;
+  
+  for (size_t i = 0; i < next.devices.size(); i++) {
+    const DeviceConfig& device = next.devices[i];
+    if (!device.enabled) continue;
+    
+    if (device.type == SYM_SENSOR) {
+      BaseSensor* sensor = keptSensors[i];
+      if (sensor) {
+        sensor->setName(device.name);
+        unsigned long previousInterval = sensor->getReadInterval();
+        sensor->setReadInterval(device.readInterval);
+        if (sensor->getReadInterval() != previousInterval) {
+          // Un intervalle raccourci s'applique tout de suite, sans attendre
+          // la fin de l'ancien
+          scheduler.scheduleIn(sensor->timer(), sensor->nextPollDelay());
+        }
+        if (sensor->getSlot() >= 0 && device.slot >= 0) {
+          sensorReadings[device.slot] = previousReadings[sensor->getSlot()];
+        }
+        sensor->setSlot(device.slot);
+      } else {
+        sensor = createSensor(device);
+        if (!sensor) continue;
+        added++;
+      }
+      sensors.push_back(sensor);
+      if (device.slot >= 0) sensorSlots[device.slot] = sensor;
+    } else if (device.type == SYM_ACTUATOR) {
+      BaseActuator* actuator = keptActuators[i];
+      if (actuator) {
+        actuator->setName(device.name);
+      } else {
+        actuator = createActuator(device);
+        if (!actuator) continue;
+        added++;
       }
+      actuators.push_back(actuator);
+      if (device.slot >= 0) actuatorSlots[device.slot] = actuator;
+    }
+  }
+  
+  // État actif repris des règles inchangées, indexé comme les nouvelles règles
+  std::vector<uint8_t> keptActive(next.rules.size(), 0);
+  for (size_t i = 0; i < next.rules.size(); i++) {
+    int previous = config.findRule(next.rules[i].id);
+    if (previous >= 0 && (size_t)previous < activeRules.size() && activeRules[previous] &&
+        sameRule(config.rules[previous], next.rules[i])) {
+      keptActive[i] = 1;
     }
   }
   
-  Serial.println("Devices initialized: " + String(sensors.size()) + " sensors, " + String(actuators.size()) + " actuators");
+  // Nouvelles règles compilées, indexées sur les nouvelles cases ; l'ancienne
+  // configuration et son arène sont libérées avec next
+  config.swap(next);
+  dirtyRules.assign(config.rules.size(), 1);
+  activeRules.swap(keptActive);
+  
+  // Les cases et les index de règles ont pu changer : compteurs remis à zéro,
+  // ce que Prometheus traite comme un redémarrage
+  memset((void*)&engineMetrics, 0, sizeof(engineMetrics));
+  
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    readingSnapshot.publish(slot, sensorReadings[slot]);
+  }
+  // Seuls les index ont changé : pas d'événement dans le journal
+  actuatorStates.store(currentActuatorStates(), std::memory_order_release);
+  
+  LOG_I("Reconfiguration: %u devices kept, %u removed, %u added",
+        (unsigned)(sensors.size() + actuators.size() - added), (unsigned)removed, (unsigned)added);
 }
 
 void initWebServer() {
+  loadStaticAssets();
+  
+#ifdef HTTP_LEGACY_SERVER
+  // WebServer ne conserve que les en-têtes demandés
+  const char* headerKeys[] = { "Accept-Encoding", "If-None-Match", "X-Root-Password" };
+  server.collectHeaders(headerKeys, 3);
+#endif
+  
   // Serve static files
   server.on("/", handleRoot);
   server.on("/login", HTTP_POST, handleLogin);
@@ -210,25 +739,124 @@ void initWebServer() {
   server.on("/api/actuators", HTTP_POST, handleActuatorControl);
   server.on("/api/config", HTTP_GET, handleConfig);
   server.on("/api/config", HTTP_POST, handleConfig);
+#ifdef HTTP_LEGACY_SERVER
+  server.on(UriBraces("/api/devices/{}"), handleDeviceResource);
+  server.on(UriBraces("/api/rules/{}"), handleRuleResource);
+#else
+  server.on("/api/devices/{}", handleDeviceResource);
+  server.on("/api/rules/{}", handleRuleResource);
+#endif
   server.on("/api/system", HTTP_GET, handleSystemStats);
+  server.on("/api/system/latency", HTTP_GET, handleLatencyStats);
+  server.on("/metrics", HTTP_GET, handleMetrics);
+  server.on("/api/history", HTTP_GET, handleHistory);
+  server.on("/api/log", HTTP_GET, handleLogExport);
+#ifndef HTTP_LEGACY_SERVER
+  server.on("/api/events", HTTP_GET, handleEvents);
+#endif
   
   // Serve static files
   server.onNotFound(handleNotFound);
   
   server.begin();
-  Serial.println("Web server started");
+  LOG_I("Web server started");
 }
 
 void handleRoot() {
-  File file = SPIFFS.open("/index.html", "r");
-  if (file) {
-    server.streamFile(file, "text/html");
-    file.close();
-  } else {
+  if (!serveStatic("/index.html")) {
     server.send(404, "text/plain", "File not found");
   }
 }
 
+void loadStaticAssets() {
+  staticAssets.clear();
+  
+  File file = SPIFFS.open("/assets.json", "r");
+  if (!file) {
+    if (AssetBundle::count() == 0) {
+      LOG_W("No /assets.json: static files served uncompressed, without ETag");
+    }
+    return;
+  }
+  
+  JsonDocument doc;
+  DeserializationError error = deserializeJson(doc, file);
+  file.close();
+  if (error) {
+    LOG_E("Failed to parse /assets.json: %s", error.c_str());
+    return;
+  }
+  
+  for (JsonPair entry : doc.as<JsonObject>()) {
+    StaticAsset asset;
+    asset.path = entry.key().c_str();
+    asset.etag = entry.value()["etag"].as<String>();
+    asset.gzip = entry.value()["gzip"] | false;
+    staticAssets.push_back(asset);
+  }
+  
+  LOG_I("Static assets: %u indexed, %u embedded", (unsigned)staticAssets.size(), (unsigned)AssetBundle::count());
+}
+
+bool serveStatic(const String& path) {
+  bool acceptsGzip = server.header("Accept-Encoding").indexOf("gzip") >= 0;
+  
+  // Bundle embarqué : ni système de fichiers ni tampon, le corps part de la flash
+  const EmbeddedAsset* embedded = AssetBundle::find(path.c_str());
+  if (embedded && (acceptsGzip || !embedded->gzip)) {
+    if (sendCacheValidators(path, embedded->etag, embedded->gzip)) return true;
+    if (embedded->gzip) {
+      server.sendHeader("Content-Encoding", "gzip");
+    }
+    server.send_P(200, embedded->contentType, (const char*)embedded->data, embedded->length);
+    return true;
+  }
+  
+  const StaticAsset* asset = nullptr;
+  for (const auto& candidate : staticAssets) {
+    if (candidate.path == path) {
+      asset = &candidate;
+      break;
+    }
+  }
+  
+  // Fichier hors manifeste : servi tel quel, sauf l'instantané de configuration
+  if (!asset) {
+    if (path.endsWith(".bin") || !SPIFFS.exists(path)) return false;
+    File file = SPIFFS.open(path, "r");
+    server.streamFile(file, getContentType(path));
+    return true;
+  }
+  
+  bool gzip = asset->gzip && acceptsGzip;
+  File file = SPIFFS.open(gzip ? path + ".gz" : path, "r");
+  if (!file) return false;
+  
+  String etag = "\"" + asset->etag + (gzip ? "-gz\"" : "\"");
+  if (sendCacheValidators(path, etag, asset->gzip)) return true;
+  server.streamFile(file, getContentType(path));
+  return true;
+}
+
+bool sendCacheValidators(const String& path, const String& etag, bool varies) {
+  // Le HTML et le service worker sont revalidés à chaque chargement pour que
+  // les mises à jour soient vues tout de suite ; le reste reste en cache
+  bool revalidate = path.endsWith(".html") || path == "/sw.js";
+  server.sendHeader("ETag", etag);
+  server.sendHeader("Cache-Control", revalidate ? String("no-cache") : String("public, max-age=") + STATIC_MAX_AGE);
+  if (varies) {
+    server.sendHeader("Vary", "Accept-Encoding");
+  }
+  
+  // Copie du navigateur à jour : 304 sans corps
+  String ifNoneMatch = server.header("If-None-Match");
+  if (ifNoneMatch.length() > 0 && (ifNoneMatch.indexOf(etag) >= 0 || ifNoneMatch == "*")) {
+    server.send(304);
+    return true;
+  }
+  return false;
+}
+
 void handleLogin() {
   if (server.hasArg("username") && server.hasArg("password")) {
     String username = server.arg("username");
@@ -249,55 +877,238 @@ void handleLogin() {
 void handleSensorData() {
   if (!checkAuthentication()) return;
   
+  writeSensorData(beginStreamedResponse("application/json"));
+  endStreamedResponse();
+}
+
+void writeSensorData(Print& out) {
+  out.print("{\"sensors\":[");
+  
+  bool first = true;
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    const BaseSensor* sensor = sensorSlots[slot];
+    PublishedReading reading;
+    
+    // Ne inclure que les lectures valides dans l'API
+    if (sensor && readingSnapshot.read(slot, reading)) {
+      // Un capteur à la fois : la mémoire ne dépend pas du nombre de capteurs
+      responseDoc.clear();
+      serializeReading(responseDoc.to<JsonObject>(), sensor, reading);
+      if (!first) out.print(',');
+      serializeJson(responseDoc, out);
+      first = false;
+    }
+  }
+  
+  out.print("]}");
+  responseDoc.clear();
+}
+
+Print& beginStreamedResponse(const char* contentType) {
+#ifdef HTTP_LEGACY_SERVER
+  // WebServer n'envoie qu'un corps complet : accumulation puis send()
+  legacyContentType = contentType;
+  legacyResponse = "";
+  return legacyResponse;
+#else
+  return server.beginChunked(200, contentType);
+#endif
+}
+
+void endStreamedResponse() {
+#ifdef HTTP_LEGACY_SERVER
+  server.send(200, legacyContentType, legacyResponse);
+  legacyResponse = "";
+#else
+  server.endChunked();
+#endif
+}
+
+void serializeReading(JsonObject sensorObj, const BaseSensor* sensor, const PublishedReading& reading) {
+  Symbol model = sensor->getModel();
+  sensorObj["id"] = symbols.text(sensor->getId());
+  sensorObj["type"] = symbols.text(model);
+  sensorObj["timestamp"] = reading.timestamp;
+  sensorObj["isValid"] = reading.isValid;
+  if (!reading.isValid) return;
+  
+  switch (model) {
+    case SYM_DHT11:
+      sensorObj["temperature"] = reading.temperature;
+      sensorObj["humidity"] = reading.humidity;
+      break;
+    case SYM_MQ2:    sensorObj["gas"] = reading.gas; break;
+    case SYM_ASC:    sensorObj["current"] = reading.current; break;
+    case SYM_LDR:    sensorObj["light"] = reading.light; break;
+    case SYM_PIR:    sensorObj["motion"] = reading.motion; break;
+    case SYM_BUTTON: sensorObj["pressed"] = reading.pressed; break;
+  }
+}
+
+uint32_t currentActuatorStates() {
+  uint32_t states = 0;
+  for (int slot = 0; slot < MAX_ACTUATOR_SLOTS; slot++) {
+    if (actuatorSlots[slot] && actuatorSlots[slot]->getState()) {
+      states |= (1UL << slot);
+    }
+  }
+  return states;
+}
+
+void publishActuatorStates() {
+  uint32_t states = currentActuatorStates();
+  
+  // Seule la tâche de contrôle écrit actuatorStates : l'ancienne valeur est la sienne
+  uint32_t changed = states ^ actuatorStates.load(std::memory_order_relaxed);
+  for (int slot = 0; changed; slot++, changed >>= 1) {
+    if (changed & 1) {
+      engineMetrics.actuatorToggles[slot]++;
+      // Case vidée par une reconfiguration : actionneur retiré, source inconnue
+      Symbol source = actuatorSlots[slot] ? actuatorSlots[slot]->getId() : SYMBOL_UNKNOWN;
+      logEvent(FlashRecordType::ACTUATOR, source, (states >> slot) & 1);
+    }
+  }
+  actuatorStates.store(states, std::memory_order_release);
+}
+
+void logEvent(FlashRecordType type, Symbol source, uint8_t state) {
+  if (!eventQueue) return;
+  LoggedEvent event = { type, source, state, (uint32_t)millis() };
+  // Jamais bloquant : l'événement est perdu si la tâche web a pris du retard
+  xQueueSend(eventQueue, &event, 0);
+}
+
+#ifndef HTTP_LEGACY_SERVER
+void handleEvents() {
+  if (!checkAuthentication()) return;
+  if (!server.beginEventStream()) return;
+  
+  // État complet pour le nouvel abonné, les événements suivants ne portent
+  // que les changements
   JsonDocument doc;
   JsonArray sensorsArray = doc["sensors"].to<JsonArray>();
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    PublishedReading reading;
+    if (sensorSlots[slot]) {
+      readingSnapshot.read(slot, reading);
+      serializeReading(sensorsArray.add<JsonObject>(), sensorSlots[slot], reading);
+    }
+  }
   
-  for (const auto& reading : latestReadings) {
-    // Ne inclure que les lectures valides dans l'API
-    if (reading.second.isValid) {
-      JsonObject sensorObj = sensorsArray.add<JsonObject>();
-      sensorObj["id"] = reading.second.sensorId;
-      sensorObj["type"] = reading.second.type;
-      sensorObj["timestamp"] = reading.second.timestamp;
-      sensorObj["isValid"] = reading.second.isValid;
+  String payload;
+  serializeJson(doc, payload);
+  server.sendEvent("sensors", payload);
+  
+  doc.clear();
+  JsonArray actuatorsArray = doc["actuators"].to<JsonArray>();
+  uint32_t states = actuatorStates.load(std::memory_order_acquire);
+  for (int slot = 0; slot < MAX_ACTUATOR_SLOTS; slot++) {
+    if (actuatorSlots[slot]) {
+      JsonObject actuatorObj = actuatorsArray.add<JsonObject>();
+      actuatorObj["id"] = symbols.text(actuatorSlots[slot]->getId());
+      actuatorObj["state"] = (states & (1UL << slot)) != 0;
+    }
+  }
+  
+  payload = String();
+  serializeJson(doc, payload);
+  server.sendEvent("actuators", payload);
+}
+
+// Deux NaN (lecture invalide) sont égaux : sinon un capteur en panne
+// produirait un événement à chaque scrutation
+bool sameValue(float a, float b) {
+  return a == b || (isnan(a) && isnan(b));
+}
+
+bool sameReading(const PublishedReading& a, const PublishedReading& b) {
+  // L'horodatage change à chaque scrutation, seules les valeurs comptent
+  return a.isValid == b.isValid &&
+         sameValue(a.temperature, b.temperature) && sameValue(a.humidity, b.humidity) &&
+         sameValue(a.gas, b.gas) && sameValue(a.current, b.current) && sameValue(a.light, b.light) &&
+         a.motion == b.motion && a.pressed == b.pressed;
+}
+
+void pushEvents() {
+  // Sérialisation unique par changement, quel que soit le nombre d'abonnés.
+  // Sans abonné, la référence suit quand même l'état courant : un nouvel
+  // abonné reçoit l'état complet puis les écarts à cet état
+  bool listening = server.eventSubscribers() > 0;
+  
+  uint32_t generation = readingSnapshot.generation();
+  if (generation != pushedGeneration) {
+    pushedGeneration = generation;
+    
+    JsonDocument doc;
+    JsonArray sensorsArray = doc["sensors"].to<JsonArray>();
+    for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+      PublishedReading reading;
+      if (!sensorSlots[slot]) continue;
+      readingSnapshot.read(slot, reading);
+      if (sameReading(reading, pushedReadings[slot])) continue;
       
-      if (reading.second.type == "DHT11") {
-        sensorObj["temperature"] = reading.second.temperature;
-        sensorObj["humidity"] = reading.second.humidity;
-      } else if (reading.second.type == "MQ2") {
-        sensorObj["gas"] = reading.second.gas;
-      } else if (reading.second.type == "ASC") {
-        sensorObj["current"] = reading.second.current;
-      } else if (reading.second.type == "LDR") {
-        sensorObj["light"] = reading.second.light;
-      } else if (reading.second.type == "PIR") {
-        sensorObj["motion"] = reading.second.motion;
-      } else if (reading.second.type == "BUTTON") {
-        sensorObj["pressed"] = reading.second.pressed;
-      }
+      pushedReadings[slot] = reading;
+      if (listening) serializeReading(sensorsArray.add<JsonObject>(), sensorSlots[slot], reading);
+    }
+    
+    if (sensorsArray.size() > 0) {
+      String payload;
+      serializeJson(doc, payload);
+      server.broadcastEvent("sensors", payload);
     }
   }
   
-  String response;
-  serializeJson(doc, response);
-  server.send(200, "application/json", response);
+  uint32_t states = actuatorStates.load(std::memory_order_acquire);
+  if (states != pushedActuatorStates) {
+    uint32_t changed = states ^ pushedActuatorStates;
+    pushedActuatorStates = states;
+    if (!listening) return;
+    
+    JsonDocument doc;
+    JsonArray actuatorsArray = doc["actuators"].to<JsonArray>();
+    for (int slot = 0; slot < MAX_ACTUATOR_SLOTS; slot++) {
+      if (!(changed & (1UL << slot)) || !actuatorSlots[slot]) continue;
+      JsonObject actuatorObj = actuatorsArray.add<JsonObject>();
+      actuatorObj["id"] = symbols.text(actuatorSlots[slot]->getId());
+      actuatorObj["state"] = (states & (1UL << slot)) != 0;
+    }
+    
+    String payload;
+    serializeJson(doc, payload);
+    server.broadcastEvent("actuators", payload);
+  }
 }
+#endif
 
 void handleActuatorControl() {
   if (!checkAuthentication()) return;
   
   if (server.hasArg("id") && server.hasArg("action")) {
-    String actuatorId = server.arg("id");
+    Symbol actuatorId = symbols.find(server.arg("id"));
     String action = server.arg("action");
     
-    for (auto* actuator : actuators) {
+    for (size_t i = 0; i < actuators.size(); i++) {
+      BaseActuator* actuator = actuators[i];
       if (actuator->getId() == actuatorId) {
+        // L'actionneur appartient à la tâche de contrôle : passer par la file de commandes
+        ControlCommand command;
+        command.type = CommandType::ACTUATOR;
+        command.actuatorIndex = i;
+        command.config = nullptr;
         if (action == "turn_on") {
-          actuator->turnOn();
+          command.action = ActuatorCommand::TURN_ON;
         } else if (action == "turn_off") {
-          actuator->turnOff();
+          command.action = ActuatorCommand::TURN_OFF;
         } else if (action == "toggle") {
-          actuator->toggle();
+          command.action = ActuatorCommand::TOGGLE;
+        } else {
+          server.send(400, "application/json", "{\"success\":false,\"error\":\"Unknown action\"}");
+          return;
+        }
+        
+        if (!sendCommand(command)) {
+          server.send(503, "application/json", "{\"success\":false,\"error\":\"Control task busy\"}");
+          return;
         }
         
         server.send(200, "application/json", "{\"success\":true,\"state\":" + String(actuator->getState() ? "true" : "false") + "}");
@@ -316,75 +1127,840 @@ void handleConfig() {
   
   if (server.method() == HTTP_GET) {
     // Return current configuration
-    File file = SPIFFS.open("/configuration.json", "r");
+    File file = SPIFFS.open(configPath, "r");
     if (file) {
       server.streamFile(file, "application/json");
-      file.close();
     } else {
       server.send(404, "application/json", "{\"error\":\"Configuration file not found\"}");
     }
   } else if (server.method() == HTTP_POST) {
-    // Update configuration (requires root password)
-    if (!server.hasArg("root_password")) {
+    // Update configuration (requires root password, X-Root-Password header)
+    if (!server.hasHeader("X-Root-Password")) {
       server.send(401, "application/json", "{\"error\":\"Root password required\"}");
       return;
     }
     
-    String rootPassword = server.arg("root_password");
-    if (rootPassword != config.system.auth.rootPassword) {
+    if (server.header("X-Root-Password") != config.system.auth.rootPassword) {
       server.send(401, "application/json", "{\"error\":\"Invalid root password\"}");
       return;
     }
     
-    // Save new configuration
-    String body = server.arg("plain");
-    File file = SPIFFS.open("/configuration.json", "w");
-    if (file) {
-      file.print(body);
-      file.close();
-      
-      // Reload configuration
-      config.loadFromFile("/configuration.json");
-      
-      server.send(200, "application/json", "{\"success\":true}");
-    } else {
+    // Save new configuration : à côté de l'actuelle, qui reste en place si
+    // la nouvelle est refusée
+    File file = SPIFFS.open(pendingConfigPath, "w");
+    if (!file) {
       server.send(500, "application/json", "{\"error\":\"Failed to save configuration\"}");
+      return;
+    }
+    file.print(requestBody());
+    file.close();
+    
+    Config next;
+    if (!next.loadFromFile(pendingConfigPath)) {
+      SPIFFS.remove(pendingConfigPath);
+      server.send(400, "application/json", "{\"error\":\"Invalid configuration\"}");
+      return;
+    }
+    const char* invalid = next.validate();
+    if (invalid) {
+      SPIFFS.remove(pendingConfigPath);
+      sendValidationError(invalid);
+      return;
     }
+    applyConfig(next);
+    
+    server.send(200, "application/json", "{\"success\":true}");
   }
 }
 
-void handleSystemStats() {
-  if (!checkAuthentication()) return;
+// Appliquée par la tâche de contrôle, qui possède la configuration et les
+// dispositifs ; attente sans limite, les dispositifs pouvant être détruits.
+// next reçoit l'ancienne configuration, libérée par l'appelant.
+void applyConfig(Config& next) {
+  // Capteur de chaque case avant la reconfiguration
+  Symbol previousIds[MAX_SENSOR_SLOTS];
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    previousIds[slot] = sensorSlots[slot] ? sensorSlots[slot]->getId() : SYMBOL_UNKNOWN;
+  }
   
-  JsonDocument doc;
+  ControlCommand command;
+  command.type = CommandType::APPLY_CONFIG;
+  command.actuatorIndex = 0;
+  command.action = ActuatorCommand::TURN_OFF;
+  command.config = &next;
+  sendCommand(command, portMAX_DELAY);
   
-  // Récupérer les statistiques système ESP32
-  doc["freeMemory"] = String(ESP.getFreeHeap() / 1024) + " KB";
-  doc["totalMemory"] = String(ESP.getHeapSize() / 1024) + " KB";
-  doc["cpuFreq"] = String(ESP.getCpuFreqMHz()) + " MHz";
-  doc["uptime"] = String(millis() / 1000) + " sec";
-  doc["flashSize"] = String(ESP.getFlashChipSize() / 1024 / 1024) + " MB";
-  doc["wifiRSSI"] = String(WiFi.RSSI()) + " dBm";
-  doc["connectedClients"] = WiFi.softAPgetStationNum();
+  // SPIFFS ne renomme pas sur un fichier existant : une coupure entre les
+  // deux appels est rattrapée au démarrage par recoverPendingConfig()
+  SPIFFS.remove(configPath);
+  SPIFFS.rename(pendingConfigPath, configPath);
+  remapWebState(previousIds);
+}
+
+// /configuration.new sans /configuration.json : coupure au milieu du
+// remplacement par applyConfig(), le fichier en attente était déjà validé.
+// Avec /configuration.json, il n'avait pas encore été appliqué.
+void recoverPendingConfig() {
+  if (!SPIFFS.exists(pendingConfigPath)) return;
+  if (SPIFFS.exists(configPath)) {
+    SPIFFS.remove(pendingConfigPath);
+  } else if (SPIFFS.rename(pendingConfigPath, configPath)) {
+    LOG_W("Configuration recovered from %s", pendingConfigPath);
+  }
+}
+
+#ifdef HTTP_LEGACY_SERVER
+String requestBody() {
+  return server.arg("plain");
+}
+#else
+const String& requestBody() {
+  return server.body();
+}
+#endif
+
+// 400 avec le message de Config::validate()
+void sendValidationError(const char* error) {
+  String body = "{\"error\":\"";
+  body += error;
+  body += "\"}";
+  server.send(400, "application/json", body);
+}
+
+// JSON merge-patch (RFC 7396) : null retire la clé, un objet est fusionné
+// récursivement, toute autre valeur remplace l'existante
+void mergePatch(JsonObject target, JsonObjectConst patch) {
+  for (JsonPairConst member : patch) {
+    JsonVariantConst value = member.value();
+    if (value.isNull()) {
+      target.remove(member.key());
+    } else if (value.is<JsonObjectConst>()) {
+      JsonObject child = target[member.key()].is<JsonObject>()
+                         ? target[member.key()].as<JsonObject>()
+                         : target[member.key()].to<JsonObject>();
+      mergePatch(child, value.as<JsonObjectConst>());
+    } else {
+      target[member.key()] = value;
+    }
+  }
+}
+
+// /api/devices/{id} et /api/rules/{id} : GET, PUT (création ou
+// remplacement), PATCH (merge-patch) et DELETE. Seul l'enregistrement
+// concerné est analysé puis modifié dans une copie de la configuration ; le
+// reste du fichier, y compris les clés inconnues, est recopié tel quel.
+void handleResource(ResourceKind kind) {
+  if (!checkAuthentication()) return;
+  
+  String id = server.pathArg(0);
+  bool isDevice = (kind == ResourceKind::DEVICE);
+  HTTPMethod method = server.method();
+  
+  if (method == HTTP_GET) {
+    Symbol symbol = symbols.find(id);
+    int index = isDevice ? config.findDevice(symbol) : config.findRule(symbol);
+    if (index < 0) {
+      server.send(404, "application/json", "{\"error\":\"Not found\"}");
+      return;
+    }
+    JsonDocument& doc = responseDoc;
+    doc.clear();
+    if (isDevice) {
+      Config::writeDevice(doc.to<JsonObject>(), config.devices[index]);
+    } else {
+      Config::writeRule(doc.to<JsonObject>(), config.rules[index]);
+    }
+    serializeJson(doc, beginStreamedResponse("application/json"));
+    doc.clear();
+    endStreamedResponse();
+    return;
+  }
+  
+  if (method != HTTP_PUT && method != HTTP_PATCH && method != HTTP_DELETE) {
+    server.send(405, "application/json", "{\"error\":\"Method not allowed\"}");
+    return;
+  }
+  
+  // Modification : mot de passe root dans l'en-tête X-Root-Password
+  if (server.header("X-Root-Password") != config.system.auth.rootPassword) {
+    server.send(401, "application/json", "{\"error\":\"Invalid root password\"}");
+    return;
+  }
+  
+  // Corps complet déjà reçu, analysé dans l'arène
+  JsonDocument& patch = responseDoc;
+  patch.clear();
+  if (method != HTTP_DELETE) {
+    DeserializationError error = deserializeJson(patch, requestBody());
+    if (error || !patch.is<JsonObject>()) {
+      patch.clear();
+      server.send(400, "application/json", "{\"error\":\"Invalid JSON object\"}");
+      return;
+    }
+    if (!patch["id"].isNull() && patch["id"].as<String>() != id) {
+      patch.clear();
+      server.send(400, "application/json", "{\"error\":\"id does not match the URL\"}");
+      return;
+    }
+  }
+  
+  JsonDocument fileDoc;
+  File file = SPIFFS.open(configPath, "r");
+  DeserializationError error = file ? deserializeJson(fileDoc, file) : DeserializationError::InvalidInput;
+  if (file) file.close();
+  if (error) {
+    patch.clear();
+    server.send(500, "application/json", "{\"error\":\"Failed to read configuration\"}");
+    return;
+  }
+  
+  const char* section = isDevice ? "devices" : "rules";
+  JsonArray records = fileDoc[section].is<JsonArray>() ? fileDoc[section].as<JsonArray>()
+                                                       : fileDoc[section].to<JsonArray>();
+  int position = -1;
+  for (size_t i = 0; i < records.size(); i++) {
+    if (records[i]["id"].as<String>() == id) {
+      position = i;
+      break;
+    }
+  }
+  if (position < 0 && method != HTTP_PUT) {
+    patch.clear();
+    server.send(404, "application/json", "{\"error\":\"Not found\"}");
+    return;
+  }
+  
+  Config next = config;
+  if (method == HTTP_DELETE) {
+    records.remove(position);
+    if (isDevice) {
+      next.removeDevice(symbols.find(id));
+    } else {
+      next.removeRule(symbols.find(id));
+    }
+  } else {
+    JsonObject record;
+    if (position < 0) {
+      record = records.add<JsonObject>();
+    } else {
+      record = records[position].as<JsonObject>();
+      if (method == HTTP_PUT) record.clear();
+    }
+    if (method == HTTP_PUT) {
+      record.set(patch.as<JsonObjectConst>());
+    } else {
+      mergePatch(record, patch.as<JsonObjectConst>());
+    }
+    record["id"] = id;
+    patch.clear();
+    
+    if (isDevice && record["type"] == "sensor") {
+      if (!findSensorDriver(symbols.find(record["sensor_type"].as<String>()))) {
+        server.send(400, "application/json", "{\"error\":\"Unknown sensor_type\"}");
+        return;
+      }
+    } else if (isDevice && record["type"] == "actuator") {
+      if (!findActuatorDriver(symbols.find(record["actuator_type"].as<String>()))) {
+        server.send(400, "application/json", "{\"error\":\"Unknown actuator_type\"}");
+        return;
+      }
+    } else if (isDevice) {
+      server.send(400, "application/json", "{\"error\":\"type must be sensor or actuator\"}");
+      return;
+    }
+    if (isDevice) {
+      next.putDevice(record);
+    } else {
+      next.putRule(record);
+    }
+  }
+  
+  // Règle modifiée, ou règles qui désignent un dispositif retiré ou changé
+  const char* invalid = next.validate();
+  if (invalid) {
+    sendValidationError(invalid);
+    return;
+  }
+  
+  file = SPIFFS.open(pendingConfigPath, "w");
+  if (!file) {
+    server.send(500, "application/json", "{\"error\":\"Failed to save configuration\"}");
+    return;
+  }
+  serializeJsonPretty(fileDoc, file);
+  file.close();
+  fileDoc.clear();
+  
+  next.writeSnapshot(pendingConfigPath);
+  applyConfig(next);
+  
+  server.send(position < 0 ? 201 : 200, "application/json", "{\"success\":true}");
+}
+
+void handleDeviceResource() {
+  handleResource(ResourceKind::DEVICE);
+}
+
+void handleRuleResource() {
+  handleResource(ResourceKind::RULE);
+}
+
+void handleSystemStats() {
+  if (!checkAuthentication()) return;
+  
+  JsonDocument& doc = responseDoc;
+  doc.clear();
+  
+  // Récupérer les statistiques système ESP32
+  doc["freeMemory"] = String(ESP.getFreeHeap() / 1024) + " KB";
+  doc["totalMemory"] = String(ESP.getHeapSize() / 1024) + " KB";
+  doc["cpuFreq"] = String(ESP.getCpuFreqMHz()) + " MHz";
+  doc["uptime"] = String(millis() / 1000) + " sec";
+  doc["flashSize"] = String(ESP.getFlashChipSize() / 1024 / 1024) + " MB";
+  doc["wifiRSSI"] = String(WiFi.RSSI()) + " dBm";
+  doc["connectedClients"] = WiFi.softAPgetStationNum();
   
   // Température interne (approximative)
-  float temp = (esp_random() % 10) + 35; // Simulation entre 35-44°C
-  doc["cpuTemp"] = String(temp, 1) + "°C";
+  doc["cpuTemp"] = String(temperatureRead(), 1) + "°C";
+  
+  // Latences du pipeline capteur -> actionneur
+  JsonObject pipeline = doc["pipeline"].to<JsonObject>();
+  pipeline["lastActuationUs"] = pipelineStats.lastActuationUs;
+  pipeline["maxActuationUs"] = pipelineStats.maxActuationUs;
+  pipeline["maxSampleLatenessMs"] = pipelineStats.maxSampleLatenessMs;
+  
+  // Mémoire de l'historique : réservée / occupée par les données compressées
+  JsonObject historyStats = doc["history"].to<JsonObject>();
+  historyStats["series"] = history.seriesCount();
+  historyStats["capacity"] = history.capacity();
+  historyStats["used"] = history.used();
+  
+  // Dernier chargement de la configuration, et son arène ; arenaPeak est le
+  // maximum atteint par toutes les arènes vivantes (rechargements compris)
+  JsonObject configLoad = doc["configLoad"].to<JsonObject>();
+  configLoad["source"] = config.loadedFromSnapshot ? "snapshot" : "json";
+  configLoad["us"] = config.loadMicros;
+  const ConfigArena* configArena = config.arena();
+  configLoad["arenaBytes"] = configArena ? configArena->capacity() : 0;
+  configLoad["arenaUsed"] = configArena ? configArena->used() : 0;
+  configLoad["arenaBlocks"] = configArena ? configArena->blocks() : 0;
+  configLoad["arenaPeak"] = ConfigArena::peakBytes();
+  
+  // Réserves statiques des pilotes : dispositifs créés / capacité par modèle
+  JsonObject pools = doc["devicePools"].to<JsonObject>();
+  for (size_t i = 0; i < sensorDriverCount; i++) {
+    JsonObject pool = pools[symbols.text(sensorDrivers[i].model)].to<JsonObject>();
+    pool["used"] = sensorDrivers[i].used();
+    pool["capacity"] = sensorDrivers[i].capacity;
+  }
+  for (size_t i = 0; i < actuatorDriverCount; i++) {
+    JsonObject pool = pools[symbols.text(actuatorDrivers[i].model)].to<JsonObject>();
+    pool["used"] = actuatorDrivers[i].used();
+    pool["capacity"] = actuatorDrivers[i].capacity;
+  }
+  
+  // Journal flash : taille de la partition, pages écrites depuis le démarrage
+  JsonObject logStats = doc["flashLog"].to<JsonObject>();
+  logStats["capacity"] = flashLog.capacity();
+  logStats["boot"] = flashLog.boot();
+  logStats["pagesWritten"] = flashLog.pagesWritten();
+  logStats["corruptPages"] = flashLog.corruptPages();
+  
+  // Occupation de l'arène JSON : un repli sur le tas signale une arène trop petite
+  JsonObject arena = doc["jsonArena"].to<JsonObject>();
+  arena["size"] = JSON_ARENA_SIZE;
+  arena["highWater"] = jsonArena.highWater();
+  arena["heapFallbacks"] = jsonArena.heapFallbacks();
+  
+  serializeJson(doc, beginStreamedResponse("application/json"));
+  doc.clear();
+  endStreamedResponse();
+}
+
+// Distribution des durées des étapes de boucle et des scrutations de capteurs
+void handleLatencyStats() {
+  if (!checkAuthentication()) return;
+  
+  JsonDocument& doc = responseDoc;
+  doc.clear();
+  
+  float cyclesPerUs = ESP.getCpuFreqMHz();
+  doc["cpuMHz"] = ESP.getCpuFreqMHz();
+  
+  JsonObject stages = doc["stages"].to<JsonObject>();
+  for (int i = 0; i < (int)LoopStage::COUNT; i++) {
+    writeLatency(stages[loopStageNames[i]].to<JsonObject>(), stageLatency[i], cyclesPerUs);
+  }
+  
+  JsonArray sensorStats = doc["sensors"].to<JsonArray>();
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    const BaseSensor* sensor = sensorSlots[slot];
+    if (!sensor) continue;
+    JsonObject entry = sensorStats.add<JsonObject>();
+    entry["id"] = symbols.text(sensor->getId());
+    entry["type"] = sensor->getTypeName();
+    writeLatency(entry, sensorLatency[slot], cyclesPerUs);
+  }
+  
+  serializeJson(doc, beginStreamedResponse("application/json"));
+  doc.clear();
+  endStreamedResponse();
+}
+
+void writeLatency(JsonObject obj, const LatencyHistogram& histogram, float cyclesPerUs) {
+  obj["count"] = histogram.count();
+  obj["p50Us"] = histogram.percentile(0.50f) / cyclesPerUs;
+  obj["p99Us"] = histogram.percentile(0.99f) / cyclesPerUs;
+  obj["maxUs"] = histogram.maxCycles() / cyclesPerUs;
+}
+
+// Compteurs au format texte de Prometheus (version 0.0.4), écrits directement
+// dans la réponse sans document intermédiaire
+void handleMetrics() {
+  if (!checkAuthentication()) return;
   
-  String response;
-  serializeJson(doc, response);
-  server.send(200, "application/json", response);
+  Print& out = beginStreamedResponse("text/plain; version=0.0.4");
+  
+  writeMetricHeader(out, "opendom_sensor_reads_total", "counter", "Sensor acquisitions, valid or not");
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    if (!sensorSlots[slot]) continue;
+    out.print("opendom_sensor_reads_total{sensor=");
+    writeLabelValue(out, symbols.text(sensorSlots[slot]->getId()));
+    out.printf(",type=\"%s\"} %u\n", sensorSlots[slot]->getTypeName(), (unsigned)engineMetrics.sensorReads[slot]);
+  }
+  
+  writeMetricHeader(out, "opendom_sensor_invalid_reads_total", "counter", "Sensor acquisitions that failed");
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    if (!sensorSlots[slot]) continue;
+    out.print("opendom_sensor_invalid_reads_total{sensor=");
+    writeLabelValue(out, symbols.text(sensorSlots[slot]->getId()));
+    out.printf(",type=\"%s\"} %u\n", sensorSlots[slot]->getTypeName(), (unsigned)engineMetrics.sensorInvalidReads[slot]);
+  }
+  
+  size_t ruleCount = config.rules.size() < MAX_RULE_METRICS ? config.rules.size() : MAX_RULE_METRICS;
+  writeMetricHeader(out, "opendom_rule_evaluations_total", "counter", "Rule evaluations");
+  for (size_t i = 0; i < ruleCount; i++) {
+    out.print("opendom_rule_evaluations_total{rule=");
+    writeLabelValue(out, symbols.text(config.rules[i].id));
+    out.printf("} %u\n", (unsigned)engineMetrics.ruleEvaluations[i]);
+  }
+  
+  writeMetricHeader(out, "opendom_rule_activations_total", "counter", "Rule transitions to the active state");
+  for (size_t i = 0; i < ruleCount; i++) {
+    out.print("opendom_rule_activations_total{rule=");
+    writeLabelValue(out, symbols.text(config.rules[i].id));
+    out.printf("} %u\n", (unsigned)engineMetrics.ruleActivations[i]);
+  }
+  
+  writeMetricHeader(out, "opendom_actuator_toggles_total", "counter", "Actuator state changes");
+  for (int slot = 0; slot < MAX_ACTUATOR_SLOTS; slot++) {
+    if (!actuatorSlots[slot]) continue;
+    out.print("opendom_actuator_toggles_total{actuator=");
+    writeLabelValue(out, symbols.text(actuatorSlots[slot]->getId()));
+    out.printf(",type=\"%s\"} %u\n", actuatorSlots[slot]->getTypeName(), (unsigned)engineMetrics.actuatorToggles[slot]);
+  }
+  
+#ifndef HTTP_LEGACY_SERVER
+  // Requêtes servies et durée des gestionnaires, par route enregistrée
+  writeMetricHeader(out, "opendom_http_requests_total", "counter", "HTTP requests by route");
+  for (size_t i = 0; i <= server.routeCount(); i++) {
+    bool matched = i < server.routeCount();
+    const HttpRouteStats& stats = matched ? server.routeStats(i) : server.unmatchedStats();
+    out.print("opendom_http_requests_total{route=");
+    writeLabelValue(out, matched ? server.routeUri(i).c_str() : "unmatched");
+    out.printf(",method=\"%s\"} %u\n", matched ? HttpServer::methodName(server.routeMethod(i)) : "ANY",
+               (unsigned)stats.requests);
+  }
+  
+  writeMetricHeader(out, "opendom_http_request_duration_seconds", "summary", "HTTP handler time by route");
+  for (size_t i = 0; i <= server.routeCount(); i++) {
+    bool matched = i < server.routeCount();
+    const HttpRouteStats& stats = matched ? server.routeStats(i) : server.unmatchedStats();
+    const char* method = matched ? HttpServer::methodName(server.routeMethod(i)) : "ANY";
+    const char* route = matched ? server.routeUri(i).c_str() : "unmatched";
+    out.print("opendom_http_request_duration_seconds_sum{route=");
+    writeLabelValue(out, route);
+    out.printf(",method=\"%s\"} %.6f\n", method, stats.totalMicros / 1e6);
+    out.print("opendom_http_request_duration_seconds_count{route=");
+    writeLabelValue(out, route);
+    out.printf(",method=\"%s\"} %u\n", method, (unsigned)stats.requests);
+  }
+#endif
+  
+  writeMetricHeader(out, "opendom_heap_free_bytes", "gauge", "Free heap");
+  out.printf("opendom_heap_free_bytes %u\n", (unsigned)ESP.getFreeHeap());
+  writeMetricHeader(out, "opendom_heap_min_free_bytes", "gauge", "Lowest free heap since boot");
+  out.printf("opendom_heap_min_free_bytes %u\n", (unsigned)ESP.getMinFreeHeap());
+  writeMetricHeader(out, "opendom_uptime_seconds", "gauge", "Time since boot");
+  out.printf("opendom_uptime_seconds %lu\n", millis() / 1000);
+  writeMetricHeader(out, "opendom_cpu_temperature_celsius", "gauge", "Internal temperature sensor");
+  out.printf("opendom_cpu_temperature_celsius %.1f\n", temperatureRead());
+  
+  endStreamedResponse();
+}
+
+void writeMetricHeader(Print& out, const char* name, const char* type, const char* help) {
+  out.printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+// Valeur d'étiquette entre guillemets, échappée comme l'exige le format texte
+void writeLabelValue(Print& out, const char* value) {
+  out.write('"');
+  for (; *value; value++) {
+    char c = *value;
+    if (c == '\\' || c == '"') {
+      out.write('\\');
+      out.write(c);
+    } else if (c == '\n') {
+      out.print("\\n");
+    } else {
+      out.write(c);
+    }
+  }
+  out.write('"');
+}
+
+void initHistory() {
+  size_t seriesCount = 0;
+  
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    SensorHistory& entry = sensorHistory[slot];
+    entry.channels = 0;
+    entry.lastTimestamp = 0;
+    entry.persistedAt = 0;
+    if (!sensorSlots[slot]) continue;
+    
+    Symbol model = sensorSlots[slot]->getModel();
+    for (const HistoryField& field : historyFields) {
+      if (field.model != model || entry.channels == MAX_SENSOR_CHANNELS) continue;
+      if (seriesCount == HISTORY_MAX_SERIES) {
+        LOG_W("History: no series left for %s", symbols.text(sensorSlots[slot]->getId()));
+        break;
+      }
+      entry.series[entry.channels] = seriesCount++;
+      entry.fields[entry.channels] = &field;
+      entry.channels++;
+    }
+  }
+  
+  if (seriesCount == 0) return;
+  if (!history.begin(seriesCount)) {
+    LOG_E("History: allocation failed (%u series)", (unsigned)seriesCount);
+    for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) sensorHistory[slot].channels = 0;
+    return;
+  }
+  LOG_I("History: %u series, %u bytes", (unsigned)seriesCount, (unsigned)history.capacity());
+}
+
+// Après une reconfiguration : les séries d'historique et l'état diffusé
+// suivent les capteurs conservés dans leur nouvelle case ; les séries des
+// capteurs retirés sont vidées et reprises par les nouveaux
+void remapWebState(const Symbol* previousIds) {
+  SensorHistory previous[MAX_SENSOR_SLOTS];
+  memcpy(previous, sensorHistory, sizeof(previous));
+  bool seriesUsed[HISTORY_MAX_SERIES] = { false };
+  
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    SensorHistory& entry = sensorHistory[slot];
+    entry.channels = 0;
+    entry.lastTimestamp = 0;
+    entry.persistedAt = 0;
+    if (!sensorSlots[slot]) continue;
+    
+    for (int old = 0; old < MAX_SENSOR_SLOTS; old++) {
+      if (previous[old].channels == 0 || previousIds[old] != sensorSlots[slot]->getId()) continue;
+      if (previous[old].fields[0]->model != sensorSlots[slot]->getModel()) continue;
+      entry = previous[old];
+      for (int channel = 0; channel < entry.channels; channel++) {
+        seriesUsed[entry.series[channel]] = true;
+      }
+      break;
+    }
+  }
+  
+  size_t seriesCount = history.seriesCount();
+  for (size_t series = 0; series < seriesCount; series++) {
+    if (!seriesUsed[series]) history.reset(series);
+  }
+  
+  // Les séries sont réservées au démarrage : un capteur ajouté n'a
+  // d'historique que s'il en reste une libre
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    SensorHistory& entry = sensorHistory[slot];
+    if (!sensorSlots[slot] || entry.channels > 0) continue;
+    
+    Symbol model = sensorSlots[slot]->getModel();
+    for (const HistoryField& field : historyFields) {
+      if (field.model != model || entry.channels == MAX_SENSOR_CHANNELS) continue;
+      size_t series = 0;
+      while (series < seriesCount && seriesUsed[series]) series++;
+      if (series == seriesCount) {
+        LOG_W("History: no series left for %s", symbols.text(sensorSlots[slot]->getId()));
+        break;
+      }
+      seriesUsed[series] = true;
+      entry.series[entry.channels] = series;
+      entry.fields[entry.channels] = &field;
+      entry.channels++;
+    }
+  }
+  
+#ifndef HTTP_LEGACY_SERVER
+  // Tout rediffuser aux abonnés SSE
+  memset(pushedReadings, 0, sizeof(pushedReadings));
+  pushedActuatorStates = ~actuatorStates.load(std::memory_order_acquire);
+#endif
+}
+
+void recordHistory() {
+  uint32_t generation = readingSnapshot.generation();
+  if (generation == historyGeneration) return;
+  historyGeneration = generation;
+  
+  for (int slot = 0; slot < MAX_SENSOR_SLOTS; slot++) {
+    SensorHistory& entry = sensorHistory[slot];
+    PublishedReading reading;
+    if (entry.channels == 0 || !readingSnapshot.read(slot, reading)) continue;
+    if (reading.timestamp == entry.lastTimestamp) continue;
+    entry.lastTimestamp = reading.timestamp;
+    
+    for (int channel = 0; channel < entry.channels; channel++) {
+      history.record(entry.series[channel], reading.timestamp, readingValue(reading, entry.fields[channel]->field));
+    }
+    persistReading(slot, entry, reading);
+  }
+}
+
+void initFlashLog() {
+  if (!flashLog.begin()) return;
+  
+  uint8_t reason = (uint8_t)esp_reset_reason();
+  flashLog.append(FlashRecordType::BOOT, millis(), &reason, sizeof(reason));
+}
+
+void persistReading(int slot, SensorHistory& entry, const PublishedReading& reading) {
+  if (!flashLog.isReady()) return;
+  
+  // Couples (grandeur, valeur) précédés de l'empreinte du capteur
+  uint8_t record[sizeof(uint32_t) + MAX_SENSOR_CHANNELS * (1 + sizeof(float))];
+  size_t length = sizeof(uint32_t);
+  bool changed = false;
+  uint32_t source = sensorSlots[slot] ? symbols.fingerprint(sensorSlots[slot]->getId()) : 0;
+  memcpy(record, &source, sizeof(source));
+  
+  for (int channel = 0; channel < entry.channels; channel++) {
+    ReadingField field = entry.fields[channel]->field;
+    float value = readingValue(reading, field);
+    if ((field == ReadingField::MOTION || field == ReadingField::PRESSED) && value != entry.persisted[channel]) {
+      changed = true;
+    }
+    record[length++] = (uint8_t)field;
+    memcpy(record + length, &value, sizeof(value));
+    length += sizeof(value);
+  }
+  
+  bool due = entry.persistedAt == 0 || reading.timestamp - entry.persistedAt >= FLASH_LOG_READING_INTERVAL_MS;
+  if (!due && !changed) return;
+  
+  if (flashLog.append(FlashRecordType::READING, reading.timestamp, record, length)) {
+    entry.persistedAt = reading.timestamp;
+    for (int channel = 0; channel < entry.channels; channel++) {
+      entry.persisted[channel] = readingValue(reading, entry.fields[channel]->field);
+    }
+  }
+}
+
+void persistEvents() {
+  LoggedEvent event;
+  while (eventQueue && xQueueReceive(eventQueue, &event, 0) == pdTRUE) {
+    uint8_t record[sizeof(uint32_t) + 1];
+    uint32_t source = symbols.fingerprint(event.source);
+    memcpy(record, &source, sizeof(source));
+    record[sizeof(source)] = event.state;
+    flashLog.append(event.type, event.time, record, sizeof(record));
+  }
+}
+
+const char* readingFieldName(uint8_t field) {
+  for (const HistoryField& entry : historyFields) {
+    if ((uint8_t)entry.field == field) return entry.name;
+  }
+  return "unknown";
+}
+
+// Empreintes de tous les symboles internés depuis le démarrage, y compris
+// ceux d'identifiants retirés depuis par une reconfiguration
+struct LogExport {
+  Print* out;
+  std::vector<uint32_t> fingerprints;
+};
+
+// Une ligne CSV par valeur : boot,time,kind,source,field,value
+void writeLogRecord(const FlashRecord& record, void* context) {
+  LogExport& output = *static_cast<LogExport*>(context);
+  Print& out = *output.out;
+  
+  // Source par l'empreinte de son identifiant ; les anciens formats ne
+  // portent qu'un index, écrit "#index"
+  String source;
+  size_t header = sizeof(uint32_t);
+  const char* kind = "boot";
+  switch (record.type) {
+    case FlashRecordType::BOOT:
+      header = 1;
+      break;
+    case FlashRecordType::READING:           kind = "reading"; break;
+    case FlashRecordType::ACTUATOR:          kind = "actuator"; break;
+    case FlashRecordType::RULE:              kind = "rule"; break;
+    case FlashRecordType::READING_BY_INDEX:  kind = "reading"; header = 1; break;
+    case FlashRecordType::ACTUATOR_BY_INDEX: kind = "actuator"; header = 1; break;
+    case FlashRecordType::RULE_BY_INDEX:     kind = "rule"; header = 1; break;
+    default:
+      return;
+  }
+  if (record.length < header) return;
+  if (record.type == FlashRecordType::BOOT) {
+    out.printf("%u,%u,boot,,reset_reason,%u\n", (unsigned)record.boot, (unsigned)record.time, record.data[0]);
+    return;
+  }
+  if (header == 1) {
+    source = "#" + String(record.data[0]);
+  } else {
+    uint32_t fingerprint;
+    memcpy(&fingerprint, record.data, sizeof(fingerprint));
+    std::vector<uint32_t>::const_iterator found =
+      std::find(output.fingerprints.begin(), output.fingerprints.end(), fingerprint);
+    if (found != output.fingerprints.end()) {
+      source = symbols.text(found - output.fingerprints.begin());
+    } else {
+      source = "#" + String(fingerprint, HEX);
+    }
+  }
+  
+  bool reading = (record.type == FlashRecordType::READING || record.type == FlashRecordType::READING_BY_INDEX);
+  if (reading) {
+    for (size_t pos = header; pos + 1 + sizeof(float) <= record.length; pos += 1 + sizeof(float)) {
+      float value;
+      memcpy(&value, record.data + pos + 1, sizeof(value));
+      out.printf("%u,%u,%s,%s,%s,", (unsigned)record.boot, (unsigned)record.time, kind, source.c_str(),
+                 readingFieldName(record.data[pos]));
+      out.print(value, 2);
+      out.print('\n');
+    }
+  } else if (record.length > header) {
+    out.printf("%u,%u,%s,%s,%s,%u\n", (unsigned)record.boot, (unsigned)record.time, kind, source.c_str(),
+               strcmp(kind, "rule") == 0 ? "active" : "state", record.data[header]);
+  }
+}
+
+void handleLogExport() {
+  if (!checkAuthentication()) return;
+  
+  LogExport output;
+  size_t count = symbols.count();
+  output.fingerprints.reserve(count);
+  for (size_t symbol = 0; symbol < count; symbol++) {
+    output.fingerprints.push_back(symbols.fingerprint((Symbol)symbol));
+  }
+  
+  // Lecture directe des segments, page par page, vers le flux chunked
+  output.out = &beginStreamedResponse("text/csv");
+  output.out->print("boot,time,kind,source,field,value\n");
+  flashLog.read(writeLogRecord, &output);
+  endStreamedResponse();
+}
+
+float readingValue(const PublishedReading& reading, ReadingField field) {
+  switch (field) {
+    case ReadingField::TEMPERATURE: return reading.temperature;
+    case ReadingField::HUMIDITY:    return reading.humidity;
+    case ReadingField::GAS:         return reading.gas;
+    case ReadingField::CURRENT:     return reading.current;
+    case ReadingField::LIGHT:       return reading.light;
+    case ReadingField::MOTION:      return reading.motion ? 1.0f : 0.0f;
+    case ReadingField::PRESSED:     return reading.pressed ? 1.0f : 0.0f;
+  }
+  return NAN;
+}
+
+struct HistoryOutput {
+  Print* out;
+  bool first;
+  bool raw;
+};
+
+void writeHistoryPoint(const HistoryPoint& point, void* context) {
+  HistoryOutput& output = *static_cast<HistoryOutput*>(context);
+  Print& out = *output.out;
+  
+  out.print(output.first ? "[" : ",[");
+  output.first = false;
+  out.print(point.timestamp);
+  out.print(',');
+  if (output.raw) {
+    out.print(point.avg, 2);
+  } else {
+    out.print(point.min, 2);
+    out.print(',');
+    out.print(point.max, 2);
+    out.print(',');
+    out.print(point.avg, 2);
+  }
+  out.print(']');
+}
+
+void handleHistory() {
+  if (!checkAuthentication()) return;
+  
+  Symbol id = symbols.find(server.arg("sensor"));
+  int slot = -1;
+  for (int i = 0; i < MAX_SENSOR_SLOTS; i++) {
+    if (sensorSlots[i] && sensorSlots[i]->getId() == id) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0 || sensorHistory[slot].channels == 0) {
+    server.send(404, "application/json", "{\"error\":\"Unknown sensor\"}");
+    return;
+  }
+  
+  // Bornes en millis(), comme les timestamp de /api/sensors ; step en ms
+  uint32_t to = server.hasArg("to") ? strtoul(server.arg("to").c_str(), nullptr, 10) : millis();
+  uint32_t from = server.hasArg("from") ? strtoul(server.arg("from").c_str(), nullptr, 10)
+                                        : (to > defaultHistoryWindow ? to - defaultHistoryWindow : 0);
+  uint32_t step = server.hasArg("step") ? strtoul(server.arg("step").c_str(), nullptr, 10) : 0;
+  
+  const SensorHistory& entry = sensorHistory[slot];
+  HistoryTier tier = history.tierFor(entry.series[0], from, step);
+  
+  // Points bruts : [t, valeur] ; agrégats : [t, min, max, moyenne]
+  Print& out = beginStreamedResponse("application/json");
+  out.print("{\"sensor\":");
+  responseDoc.set(symbols.text(id));
+  serializeJson(responseDoc, out);
+  responseDoc.clear();
+  out.print(",\"step\":");
+  out.print(History::period(tier));
+  out.print(",\"series\":[");
+  
+  for (int channel = 0; channel < entry.channels; channel++) {
+    out.print(channel ? ",{\"channel\":\"" : "{\"channel\":\"");
+    out.print(entry.fields[channel]->name);
+    out.print("\",\"points\":[");
+    HistoryOutput output = { &out, true, tier == HistoryTier::RAW };
+    history.query(entry.series[channel], tier, from, to, writeHistoryPoint, &output);
+    out.print("]}");
+  }
+  
+  out.print("]}");
+  endStreamedResponse();
 }
 
 void handleNotFound() {
   String path = server.uri();
   
-  if (SPIFFS.exists(path)) {
-    File file = SPIFFS.open(path, "r");
-    String contentType = getContentType(path);
-    server.streamFile(file, contentType);
-    file.close();
-  } else {
+  if (!serveStatic(path)) {
     // Captive portal redirect
     if (config.system.captivePortal) {
       server.sendHeader("Location", "http://192.168.4.1/", true);
@@ -395,256 +1971,308 @@ void handleNotFound() {
   }
 }
 
-void updateSensors() {
-  for (auto* sensor : sensors) {
-    if (sensor->isReady()) {
-      SensorReading reading = sensor->read();
-      
-      // Ne stocker que les lectures valides
-      if (reading.isValid) {
-        latestReadings[sensor->getId()] = reading;
-      } else {
-        // Supprimer les lectures invalides du cache
-        latestReadings.erase(sensor->getId());
-        Serial.println("Sensor " + sensor->getId() + ": Removed invalid reading from cache");
-      }
+void onSensorTimer(void* context) {
+  BaseSensor* sensor = static_cast<BaseSensor*>(context);
+  updateSensor(sensor);
+  scheduler.scheduleIn(sensor->timer(), sensor->nextPollDelay());
+}
+
+void updateSensor(BaseSensor* sensor) {
+  unsigned long previousRead = sensor->getLastRead();
+  SensorReading reading;
+  
+  // Acquisition non bloquante : rien de nouveau tant que poll() retourne false
+  uint32_t start = ESP.getCycleCount();
+  bool acquired = sensor->poll(reading);
+  if (sensor->getSlot() >= 0) {
+    sensorLatency[sensor->getSlot()].recordSince(start);
+  }
+  if (!acquired) return;
+  
+  // Retard de la lecture par rapport à son échéance
+  if (previousRead != 0) {
+    unsigned long lateness = reading.timestamp - previousRead - sensor->getReadInterval();
+    if (lateness > pipelineStats.maxSampleLatenessMs) {
+      pipelineStats.maxSampleLatenessMs = lateness;
     }
   }
+  
+  storeReading(sensor, reading);
+}
+
+// Lecture acquise : cache, instantané publié et règles dépendantes
+void storeReading(BaseSensor* sensor, const SensorReading& reading) {
+  int slot = sensor->getSlot();
+  if (slot < 0) return;
+  SensorReading& stored = sensorReadings[slot];
+  
+  engineMetrics.sensorReads[slot]++;
+  if (!reading.isValid) engineMetrics.sensorInvalidReads[slot]++;
+  
+  // Ne conserver que les lectures valides
+  if (reading.isValid) {
+    stored = reading;
+    readingSnapshot.publish(slot, stored);
+    pipelineStats.lastSampleMicros = micros();
+    markDependentRulesDirty(slot);
+  } else if (stored.isValid) {
+    // Invalider la lecture en cache
+    stored.isValid = false;
+    readingSnapshot.publish(slot, stored);
+    pipelineStats.lastSampleMicros = micros();
+    markDependentRulesDirty(slot);
+    LOG_W("Sensor %s: Invalidated cached reading", symbols.text(sensor->getId()));
+  }
 }
 
 void updateStatusLED() {
-  // Vérifier s'il y a une alarme active (buzzer en marche)
+  // Alarme si un buzzer est actif, sinon vert si un relais est actif
   bool alarmActive = false;
+  bool anyActuatorActive = false;
   for (auto* actuator : actuators) {
-    for (const auto& deviceConfig : config.devices) {
-      if (deviceConfig.id == actuator->getId() && deviceConfig.actuatorType == "BUZZER") {
-        if (actuator->getState()) {
-          alarmActive = true;
-          break;
-        }
-      }
+    if (!actuator->getState()) continue;
+    
+    if (actuator->getType() == ActuatorType::BUZZER) {
+      alarmActive = true;
+      break;
+    }
+    if (actuator->getType() == ActuatorType::RELAY) {
+      anyActuatorActive = true;
     }
-    if (alarmActive) break;
   }
   
   if (alarmActive) {
     statusLED.setStatus(LEDStatus::ALARM_ACTIVE);
-    return;
+  } else if (anyActuatorActive) {
+    statusLED.setStatus(LEDStatus::SYSTEM_NORMAL_ACTIVE);
+  } else {
+    statusLED.setStatus(LEDStatus::SYSTEM_NORMAL_IDLE);
   }
+}
+
+void markDependentRulesDirty(int slot) {
+  if (slot >= config.sensorSlotCount) return;
   
-  // Vérifier si des actionneurs sont actifs
-  bool anyActuatorActive = false;
-  for (auto* actuator : actuators) {
-    for (const auto& deviceConfig : config.devices) {
-      if (deviceConfig.id == actuator->getId() && deviceConfig.actuatorType == "RELAY") {
-        if (actuator->getState()) {
-          anyActuatorActive = true;
-          break;
-        }
-      }
+  for (uint16_t i = config.sensorRuleOffsets[slot]; i < config.sensorRuleOffsets[slot + 1]; i++) {
+    uint16_t ruleIndex = config.sensorRuleIndex[i];
+    if (ruleIndex < dirtyRules.size()) {
+      dirtyRules[ruleIndex] = 1;
     }
-    if (anyActuatorActive) break;
   }
-  
-  if (anyActuatorActive) {
-    statusLED.setStatus(LEDStatus::SYSTEM_NORMAL_ACTIVE);
-  } else {
-    statusLED.setStatus(LEDStatus::SYSTEM_NORMAL_IDLE);
+}
+
+// Les règles horaires ne dépendent d'aucun capteur, elles sont vérifiées périodiquement
+void onScheduleTimer(void* context) {
+  for (size_t i = 0; i < config.compiledRules.size() && i < dirtyRules.size(); i++) {
+    if (config.compiledRules[i].timeDriven) {
+      dirtyRules[i] = 1;
+    }
   }
+  scheduler.scheduleIn(scheduleTimer, scheduleCheckInterval);
 }
 
 void processRules() {
-  for (const auto& rule : config.rules) {
-    if (rule.enabled) {
-      evaluateRule(rule);
+  // Nouvelle configuration : tout réévaluer
+  if (dirtyRules.size() != config.rules.size()) {
+    dirtyRules.assign(config.rules.size(), 1);
+    activeRules.assign(config.rules.size(), 0);
+  }
+  
+  for (size_t i = 0; i < config.rules.size(); i++) {
+    const CompiledRule& program = config.compiledRules[i];
+    if (!dirtyRules[i]) {
+      continue;
+    }
+    dirtyRules[i] = 0;
+    
+    if (config.rules[i].enabled) {
+      evaluateRule(i, config.rules[i], program);
     }
   }
 }
 
-void evaluateRule(const RuleConfig& rule) {
-  Serial.println("Evaluating rule: " + rule.name + " (ID: " + rule.id + ")");
+void evaluateRule(size_t index, const RuleConfig& rule, const CompiledRule& program) {
+  LOG_D("Evaluating rule: %s (ID: %s)", rule.name, symbols.text(rule.id));
   
   bool shouldActivate = false;
+  if (index < MAX_RULE_METRICS) engineMetrics.ruleEvaluations[index]++;
   
-  if (rule.triggerType == "sensor_threshold" || rule.triggerType == "sensor_combination") {
-    Serial.println("Rule type: " + rule.triggerType);
-    shouldActivate = evaluateConditions(rule.conditions, latestReadings);
-  } else if (rule.triggerType == "critical_event") {
-    Serial.println("Rule type: critical_event");
-    shouldActivate = evaluateConditions(rule.conditions, latestReadings);
-  } else if (rule.triggerType == "schedule") {
-    Serial.println("Rule type: schedule");
-    shouldActivate = evaluateSchedule(rule.schedule);
+  switch (program.trigger) {
+    case TriggerKind::SENSOR:
+      LOG_D("Rule type: %s", symbols.text(rule.triggerType));
+      shouldActivate = evaluateConditions(config.conditionProgram.data() + program.firstCondition, rule.conditions);
+      break;
+    case TriggerKind::SCHEDULE:
+      LOG_D("Rule type: schedule");
+      shouldActivate = evaluateSchedule(program);
+      break;
+    case TriggerKind::UNKNOWN:
+      break;
   }
   
-  Serial.println("Rule result: " + String(shouldActivate ? "ACTIVATE" : "NO ACTION"));
+  LOG_D("Rule result: %s", shouldActivate ? "ACTIVATE" : "NO ACTION");
   
   if (shouldActivate) {
-    Serial.println("Activating rule: " + rule.name);
-    executeActions(rule.actions);
-  } else if (!rule.deactivationConditions.empty()) {
-    bool shouldDeactivate = evaluateConditions(rule.deactivationConditions, latestReadings);
+    LOG_D("Activating rule: %s", rule.name);
+    if (!activeRules[index]) {
+      activeRules[index] = 1;
+      if (index < MAX_RULE_METRICS) engineMetrics.ruleActivations[index]++;
+      logEvent(FlashRecordType::RULE, rule.id, 1);
+    }
+    executeActions(config.actionProgram.data() + program.firstAction, program.actionCount);
+    if (program.trigger == TriggerKind::SENSOR) recordActuation();
+  } else if (program.deactivationCount > 0) {
+    bool shouldDeactivate = evaluateConditions(config.conditionProgram.data() + program.firstDeactivation, 
+                                               rule.deactivationConditions);
     if (shouldDeactivate) {
-      Serial.println("Deactivating rule: " + rule.name);
+      LOG_D("Deactivating rule: %s", rule.name);
+      if (activeRules[index]) {
+        activeRules[index] = 0;
+        logEvent(FlashRecordType::RULE, rule.id, 0);
+      }
       // Turn off associated actuators
-      for (const auto& action : rule.actions) {
-        for (auto* actuator : actuators) {
-          if (actuator->getId() == action.actuatorId) {
-            Serial.println("Turning off actuator: " + action.actuatorId);
-            actuator->turnOff();
-          }
+      const CompiledAction* actions = config.actionProgram.data() + program.firstAction;
+      for (uint16_t i = 0; i < program.actionCount; i++) {
+        BaseActuator* actuator = actions[i].actuator >= 0 ? actuatorSlots[actions[i].actuator] : nullptr;
+        if (actuator) {
+          LOG_D("Turning off actuator: %s", symbols.text(actuator->getId()));
+          actuator->turnOff();
         }
       }
+      recordActuation();
     }
+  } else if (activeRules[index]) {
+    // Sans conditions de désactivation, la règle redevient inactive dès que
+    // ses conditions tombent : la prochaine activation est une transition
+    activeRules[index] = 0;
+    logEvent(FlashRecordType::RULE, rule.id, 0);
   }
   
-  Serial.println("Rule evaluation completed for: " + rule.name);
+  LOG_D("Rule evaluation completed for: %s", rule.name);
 }
 
-bool evaluateConditions(const std::vector<Condition>& conditions, const std::map<String, SensorReading>& readings) {
+// Évalue un programme de conditions compilé ; conditions ne sert qu'aux messages de log
+bool evaluateConditions(const CompiledCondition* program, const ArenaVector<Condition>& conditions) {
   if (conditions.empty()) return false;
   
   bool result = true;
-  String lastLogic = "AND";
+  LogicOp lastLogic = LogicOp::AND;
   bool firstCondition = true;
   
-  for (const auto& condition : conditions) {
-    auto it = readings.find(condition.sensorId);
-    if (it == readings.end()) {
-      Serial.println("Rule evaluation: Sensor " + condition.sensorId + " not found or disconnected");
-      continue;
-    }
-    
-    const SensorReading& reading = it->second;
+  for (size_t i = 0; i < conditions.size(); i++) {
+    const CompiledCondition& condition = program[i];
     
-    // Ignorer les capteurs avec des lectures invalides
-    if (!reading.isValid) {
-      Serial.println("Rule evaluation: Sensor " + condition.sensorId + " has invalid reading, skipping");
+    // Ignorer les capteurs absents ou avec des lectures invalides
+    if (condition.slot < 0 || !sensorReadings[condition.slot].isValid) {
+      LOG_D("Rule evaluation: Sensor %s not found or disconnected", symbols.text(conditions[i].sensorId));
       continue;
     }
+    const SensorReading& reading = sensorReadings[condition.slot];
     bool conditionResult = false;
     
     float sensorValue = 0;
-    if (condition.parameter == "temperature") sensorValue = reading.temperature;
-    else if (condition.parameter == "humidity") sensorValue = reading.humidity;
-    else if (condition.parameter == "gas") sensorValue = reading.gas;
-    else if (condition.parameter == "current") sensorValue = reading.current;
-    else if (condition.parameter == "light") sensorValue = reading.light;
-    else if (condition.parameter == "motion") sensorValue = reading.motion ? 1 : 0;
-    else if (condition.parameter == "pressed") sensorValue = reading.pressed ? 1 : 0;
-    
-    // Plus de valeurs d'erreur -999, toutes les valeurs sont maintenant valides
-    // Les capteurs déconnectés retournent des valeurs par défaut sécurisées
-    
-    if (condition.operator_ == ">") conditionResult = sensorValue > condition.value;
-    else if (condition.operator_ == "<") conditionResult = sensorValue < condition.value;
-    else if (condition.operator_ == "==") conditionResult = abs(sensorValue - condition.value) < 0.1;
-    else if (condition.operator_ == ">=") conditionResult = sensorValue >= condition.value;
-    else if (condition.operator_ == "<=") conditionResult = sensorValue <= condition.value;
-    
-    Serial.println("Rule evaluation: " + condition.sensorId + "." + condition.parameter + 
-                   " (" + String(sensorValue) + ") " + condition.operator_ + " " + 
-                   String(condition.value) + " = " + (conditionResult ? "true" : "false"));
+    switch (condition.field) {
+      case SensorField::TEMPERATURE: sensorValue = reading.temperature; break;
+      case SensorField::HUMIDITY:    sensorValue = reading.humidity; break;
+      case SensorField::GAS:         sensorValue = reading.gas; break;
+      case SensorField::CURRENT:     sensorValue = reading.current; break;
+      case SensorField::LIGHT:       sensorValue = reading.light; break;
+      case SensorField::MOTION:      sensorValue = reading.motion ? 1 : 0; break;
+      case SensorField::PRESSED:     sensorValue = reading.pressed ? 1 : 0; break;
+      case SensorField::UNKNOWN:     break;
+    }
+    
+    switch (condition.op) {
+      case CompareOp::GT: conditionResult = sensorValue > condition.value; break;
+      case CompareOp::LT: conditionResult = sensorValue < condition.value; break;
+      case CompareOp::EQ: conditionResult = abs(sensorValue - condition.value) < 0.1; break;
+      case CompareOp::GE: conditionResult = sensorValue >= condition.value; break;
+      case CompareOp::LE: conditionResult = sensorValue <= condition.value; break;
+      case CompareOp::UNKNOWN: break;
+    }
+    
+    LOG_D("Rule evaluation: %s.%s (%.2f) %s %.2f = %s", symbols.text(conditions[i].sensorId), 
+          symbols.text(conditions[i].parameter), sensorValue, symbols.text(conditions[i].operator_), 
+          condition.value, conditionResult ? "true" : "false");
     
     if (firstCondition) {
       result = conditionResult;
       firstCondition = false;
     } else {
-      if (lastLogic == "AND") {
+      if (lastLogic == LogicOp::AND) {
         result = result && conditionResult;
-      } else if (lastLogic == "OR") {
+      } else if (lastLogic == LogicOp::OR) {
         result = result || conditionResult;
       }
     }
     
-    lastLogic = condition.logic.isEmpty() ? "AND" : condition.logic;
+    lastLogic = condition.logic;
   }
   
   return result;
 }
 
-bool evaluateSchedule(const Schedule& schedule) {
+bool evaluateSchedule(const CompiledRule& program) {
   // Pour une implémentation simple, nous utiliserons millis() pour simuler l'heure
   // Dans une vraie implémentation, il faudrait un module RTC
   
-  if (schedule.startTime.isEmpty() || schedule.endTime.isEmpty()) {
-    Serial.println("Schedule evaluation: Missing start or end time");
+  if (!program.scheduleValid) {
+    LOG_D("Schedule evaluation: Missing start or end time");
     return false;
   }
   
-  // Simulation basique : activation entre 13:00 et 16:00 (règle 3)
-  // En production, il faudrait parser les heures et utiliser un RTC
+  // Simulation basique : les heures "HH:MM" sont converties en ms au chargement
+  // En production, il faudrait utiliser un RTC
   unsigned long currentTime = millis();
-  unsigned long hourOfDay = (currentTime / (1000 * 60 * 60)) % 24; // Heure simulée
   
   // Pour la démonstration, considérons que l'ESP32 a démarré à 00:00
-  bool isInTimeRange = false;
-  
-  if (schedule.startTime == "13:00" && schedule.endTime == "16:00") {
-    // Activer pendant 3 heures après 13 heures de fonctionnement
-    unsigned long startMillis = 13 * 60 * 60 * 1000; // 13 heures en ms
-    unsigned long endMillis = 16 * 60 * 60 * 1000;   // 16 heures en ms
-    isInTimeRange = (currentTime >= startMillis && currentTime <= endMillis);
-  }
+  bool isInTimeRange = (currentTime >= program.scheduleStart && currentTime <= program.scheduleEnd);
   
-  Serial.println("Schedule evaluation: Current time simulation = " + String(hourOfDay) + 
-                 ":xx, In range = " + String(isInTimeRange ? "true" : "false"));
+  LOG_D("Schedule evaluation: Current time simulation = %lu:xx, In range = %s", 
+        (currentTime / (1000 * 60 * 60)) % 24, isInTimeRange ? "true" : "false");
   
   return isInTimeRange;
 }
 
-void executeActions(const std::vector<Action>& actions) {
-  Serial.println("Executing " + String(actions.size()) + " action(s)");
+void executeActions(const CompiledAction* actions, uint16_t count) {
+  LOG_D("Executing %u action(s)", (unsigned)count);
   
-  for (const auto& action : actions) {
-    bool actuatorFound = false;
+  for (uint16_t i = 0; i < count; i++) {
+    const CompiledAction& action = actions[i];
+    BaseActuator* actuator = action.actuator >= 0 ? actuatorSlots[action.actuator] : nullptr;
     
-    for (auto* actuator : actuators) {
-      if (actuator->getId() == action.actuatorId) {
-        actuatorFound = true;
-        
-        Serial.println("Executing action: " + action.action + " on actuator " + action.actuatorId);
+    // Actionneur introuvable : signalé une seule fois à la compilation des règles
+    if (!actuator) continue;
+    
+    LOG_D("Executing action %d on actuator %s", (int)action.op, symbols.text(actuator->getId()));
+    
+    switch (action.op) {
+      case ActionOp::TURN_ON:
+        actuator->turnOn();
         
-        if (action.action == "turn_on") {
-          actuator->turnOn();
-          
-          // Set duration for timed operations
-          if (action.duration > 0) {
-            Serial.println("Setting duration: " + String(action.duration) + "ms");
-            for (const auto& deviceConfig : config.devices) {
-              if (deviceConfig.id == actuator->getId() && deviceConfig.actuatorType == "RELAY") {
-                RelayActuator* relay = static_cast<RelayActuator*>(actuator);
-                relay->setDuration(action.duration);
-                break;
-              }
-            }
-          }
-          
-          // Set pattern for buzzers
-          if (!action.pattern.isEmpty()) {
-            Serial.println("Setting pattern: " + action.pattern);
-            for (const auto& deviceConfig : config.devices) {
-              if (deviceConfig.id == actuator->getId() && deviceConfig.actuatorType == "BUZZER") {
-                BuzzerActuator* buzzer = static_cast<BuzzerActuator*>(actuator);
-                buzzer->setPattern(action.pattern);
-                break;
-              }
-            }
-          }
-        } else if (action.action == "turn_off") {
-          actuator->turnOff();
-        } else if (action.action == "toggle") {
-          actuator->toggle();
+        // Set duration for timed operations
+        if (action.duration > 0 && actuator->getType() == ActuatorType::RELAY) {
+          LOG_D("Setting duration: %lums", action.duration);
+          static_cast<RelayActuator*>(actuator)->setDuration(action.duration);
         }
         
-        Serial.println("Action completed successfully");
+        // Set pattern for buzzers
+        if (action.pattern != BuzzerPattern::NONE && actuator->getType() == ActuatorType::BUZZER) {
+          LOG_D("Setting pattern: %d", (int)action.pattern);
+          static_cast<BuzzerActuator*>(actuator)->setPattern(action.pattern);
+        }
+        break;
+      case ActionOp::TURN_OFF:
+        actuator->turnOff();
+        break;
+      case ActionOp::TOGGLE:
+        actuator->toggle();
+        break;
+      case ActionOp::UNKNOWN:
         break;
-      }
     }
     
-    if (!actuatorFound) {
-      Serial.println("Warning: Actuator " + action.actuatorId + " not found for action " + action.action);
-    }
+    LOG_D("Action completed successfully");
   }
 }
 
@@ -0,0 +1,98 @@
+#include <Arduino.h>
+#include <SPIFFS.h>
+#include <unity.h>
+#include <algorithm>
+#include <vector>
+#include "Config.h"
+#include "EngineMetrics.h"
+#include "HttpServer.h"
+
+// Tests de non-régression du moteur de règles sur l'hôte (pio test -e native),
+// avec le main.cpp complet et le matériel simulé de lib/NativeHAL
+
+// main.cpp
+extern Config config;
+extern std::vector<uint8_t> dirtyRules;
+void reconfigure(Config& next);
+void processRules();
+
+namespace {
+
+const char* const testConfigPath = "/test_rules.json";
+
+// Même chemin qu'une configuration reçue par l'API : fichier, chargement, reconfigure()
+bool applyJson(const char* json) {
+  File file = SPIFFS.open(testConfigPath, "w");
+  if (!file) return false;
+  file.print(json);
+  file.close();
+
+  Config next;
+  if (!next.loadFromFile(testConfigPath)) return false;
+  reconfigure(next);
+  return true;
+}
+
+// Règle horaire sur toute la journée, sans conditions de désactivation
+const char* const scheduleConfig = R"({
+  "system": { "auth": { "root_password": "test" } },
+  "devices": [
+    { "id": "relay_1", "name": "Relais", "type": "actuator", "actuator_type": "RELAY",
+      "pin": 5, "enabled": true, "state": false }
+  ],
+  "rules": [
+    { "id": "schedule_check", "name": "Plage horaire", "enabled": true, "trigger_type": "schedule",
+      "schedule": { "start_time": "00:00", "end_time": "23:59" },
+      "actions": [ { "actuator_id": "relay_1", "action": "turn_on" } ] }
+  ]
+})";
+
+// La plage est déplacée autour de millis() plutôt que d'attendre l'heure
+void evaluateSchedule(bool inRange) {
+  CompiledRule& program = config.compiledRules[0];
+  unsigned long now = millis();
+  program.scheduleStart = inRange ? 0 : now + 3600000UL;
+  program.scheduleEnd = now + 7200000UL;
+  std::fill(dirtyRules.begin(), dirtyRules.end(), 1);
+  processRules();
+}
+
+}
+
+void setUp() {}
+
+void tearDown() {
+  // Libère les dispositifs entre deux tests
+  Config empty;
+  reconfigure(empty);
+}
+
+// Une règle sans conditions de désactivation redevient inactive en quittant
+// sa plage : chaque entrée compte une activation
+void test_schedule_rule_counts_each_entry() {
+  TEST_ASSERT_TRUE(applyJson(scheduleConfig));
+  TEST_ASSERT_EQUAL(1, config.compiledRules.size());
+
+  evaluateSchedule(false);
+  evaluateSchedule(true);
+  evaluateSchedule(true);
+  evaluateSchedule(false);
+  evaluateSchedule(true);
+
+  TEST_ASSERT_EQUAL_UINT32(2, engineMetrics.ruleActivations[0]);
+}
+
+// HTTP_ANY ((HTTPMethod)255) est hors de l'énumération : nommé avant le switch
+void test_http_any_method_name() {
+  TEST_ASSERT_EQUAL_STRING("ANY", HttpServer::methodName(HTTP_ANY));
+  TEST_ASSERT_EQUAL_STRING("PATCH", HttpServer::methodName(HTTP_PATCH));
+}
+
+int main(int argc, char** argv) {
+  if (!SPIFFS.begin(true)) return 1;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_schedule_rule_counts_each_entry);
+  RUN_TEST(test_http_any_method_name);
+  return UNITY_END();
+}
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Compare deux résultats du banc env:native-bench (lignes JSON).
+
+Les mesures sont appariées par (bench, rules, devices). Une ligne est signalée
+si nsPerOp augmente de plus que --threshold, ou si allocsPerLoop augmente.
+Le code de sortie vaut 1 en cas de régression, pour un usage en CI :
+
+    .pio/build/native-bench/program > bench-new.json
+    python3 tools/bench_compare.py bench-old.json bench-new.json
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            entry = json.loads(line)
+            results[(entry["bench"], entry["rules"], entry["devices"])] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10, help="hausse tolérée de nsPerOp (0.10 = 10 %%)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+    regressions = 0
+
+    print("%-20s %6s %7s %12s %12s %8s %10s" % ("bench", "rules", "devices", "ns/op avant", "ns/op après", "écart", "allocs"))
+    for key in sorted(current):
+        if key not in baseline:
+            continue
+        before = baseline[key]
+        after = current[key]
+        change = after["nsPerOp"] / before["nsPerOp"] - 1 if before["nsPerOp"] else 0.0
+        allocs = after["allocsPerLoop"] - before["allocsPerLoop"]
+        flagged = change > args.threshold or allocs > 0.01
+        regressions += flagged
+        print("%-20s %6d %7d %12.1f %12.1f %+7.1f%% %+10.2f%s" % (
+            key[0], key[1], key[2], before["nsPerOp"], after["nsPerOp"], change * 100, allocs,
+            "  <- régression" if flagged else ""))
+
+    missing = sorted(set(baseline) - set(current))
+    if missing:
+        print("absents du nouveau résultat : %d" % len(missing))
+    print("régressions : %d" % regressions)
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
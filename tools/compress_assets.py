@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Prépare les fichiers statiques de data/ avant l'image SPIFFS.
+
+Pour chaque fichier de l'interface (html, js, css, manifest), écrit une
+variante gzip à côté (app.js -> app.js.gz) et recense leurs ETag dans
+data/assets.json, que le serveur charge au démarrage.
+
+Exécuté automatiquement par PlatformIO (extra_scripts), ou à la main :
+
+    python3 tools/compress_assets.py
+"""
+
+import gzip
+import hashlib
+import json
+import os
+
+COMPRESSED_EXTENSIONS = (".html", ".js", ".css", ".json", ".svg", ".ico")
+
+# Fichiers modifiés à l'exécution : pas de variante figée
+EXCLUDED = ("configuration.json", "assets.json")
+
+MANIFEST = "assets.json"
+
+
+def compress_assets(data_dir):
+    assets = {}
+
+    for name in sorted(os.listdir(data_dir)):
+        path = os.path.join(data_dir, name)
+        if not os.path.isfile(path) or name.endswith(".gz") or name in EXCLUDED:
+            continue
+        if not name.endswith(COMPRESSED_EXTENSIONS):
+            continue
+
+        with open(path, "rb") as source:
+            content = source.read()
+
+        # ETag fort : empreinte du contenu original
+        etag = hashlib.sha1(content).hexdigest()[:16]
+
+        # mtime=0 : sortie reproductible, le .gz ne change qu'avec la source
+        compressed = gzip.compress(content, compresslevel=9, mtime=0)
+        use_gzip = len(compressed) < len(content)
+
+        gz_path = path + ".gz"
+        if use_gzip:
+            write_if_changed(gz_path, compressed)
+        elif os.path.exists(gz_path):
+            os.remove(gz_path)
+
+        assets["/" + name] = {"etag": etag, "gzip": use_gzip}
+        print("assets: /%s %d -> %d bytes" % (name, len(content), len(compressed) if use_gzip else len(content)))
+
+    manifest = json.dumps(assets, indent=2, sort_keys=True).encode() + b"\n"
+    write_if_changed(os.path.join(data_dir, MANIFEST), manifest)
+
+
+def write_if_changed(path, content):
+    if os.path.exists(path):
+        with open(path, "rb") as existing:
+            if existing.read() == content:
+                return
+    with open(path, "wb") as target:
+        target.write(content)
+
+
+try:
+    Import("env")  # noqa: F821 (fourni par PlatformIO)
+    compress_assets(env.subst("$PROJECT_DATA_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        compress_assets(os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "data"))
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+"""Génère le bundle embarqué des fichiers de l'interface (mode EMBEDDED_ASSETS).
+
+Lit les variantes produites par tools/compress_assets.py (data/assets.json et
+les .gz) et écrit AssetBundle.gen.h : un tableau constant par fichier, placé en
+flash, et une table de hachage parfait chemin -> fichier.
+
+Exécuté par PlatformIO après compress_assets.py, uniquement si -DEMBEDDED_ASSETS
+figure dans build_flags. À la main :
+
+    python3 tools/embed_assets.py data build/AssetBundle.gen.h
+"""
+
+import json
+import os
+import sys
+
+CONTENT_TYPES = {
+    ".html": "text/html",
+    ".css": "text/css",
+    ".js": "application/javascript",
+    ".json": "application/json",
+    ".ico": "image/x-icon",
+    ".svg": "image/svg+xml",
+}
+
+# Graines essayées avant d'agrandir la table
+MAX_SEED_ATTEMPTS = 100000
+
+
+def fnv1a(path, seed):
+    value = (2166136261 ^ seed) & 0xFFFFFFFF
+    for byte in path.encode():
+        value ^= byte
+        value = (value * 16777619) & 0xFFFFFFFF
+    return value
+
+
+def perfect_hash(paths):
+    # Table en puissance de 2 d'au moins deux cases par chemin : une graine
+    # sans collision se trouve en quelques essais
+    size = 1
+    while size < 2 * len(paths):
+        size *= 2
+
+    while True:
+        for seed in range(MAX_SEED_ATTEMPTS):
+            slots = [-1] * size
+            for index, path in enumerate(paths):
+                slot = fnv1a(path, seed) & (size - 1)
+                if slots[slot] >= 0:
+                    break
+                slots[slot] = index
+            else:
+                return seed, size, slots
+        size *= 2
+
+
+def c_string(text):
+    return '"' + text.replace("\\", "\\\\").replace('"', '\\"') + '"'
+
+
+def generate(data_dir, output_path):
+    with open(os.path.join(data_dir, "assets.json")) as manifest:
+        assets = json.load(manifest)
+
+    paths = sorted(assets)
+    seed, size, slots = perfect_hash(paths)
+
+    lines = [
+        "// Généré par tools/embed_assets.py à partir de data/, ne pas modifier",
+        "#pragma once",
+        "",
+        "#define EMBEDDED_ASSET_SEED 0x%08xu" % seed,
+        "#define EMBEDDED_ASSET_MASK %du" % (size - 1),
+        "",
+    ]
+
+    entries = []
+    total = 0
+    for index, path in enumerate(paths):
+        info = assets[path]
+        source = os.path.join(data_dir, path.lstrip("/") + (".gz" if info["gzip"] else ""))
+        with open(source, "rb") as asset:
+            content = asset.read()
+        total += len(content)
+
+        lines.append("static const uint8_t embeddedAsset%d[] = {" % index)
+        for offset in range(0, len(content), 20):
+            lines.append("  " + ", ".join("0x%02x" % byte for byte in content[offset:offset + 20]) + ",")
+        lines.append("};")
+        lines.append("")
+
+        extension = os.path.splitext(path)[1]
+        etag = '"%s%s"' % (info["etag"], "-gz" if info["gzip"] else "")
+        entries.append("  { %s, embeddedAsset%d, %d, %s, %s, %s }," % (
+            c_string(path), index, len(content),
+            c_string(CONTENT_TYPES.get(extension, "text/plain")),
+            c_string(etag), "true" if info["gzip"] else "false"))
+
+    lines.append("static const EmbeddedAsset embeddedAssets[] = {")
+    lines.extend(entries)
+    lines.append("};")
+    lines.append("")
+    lines.append("static const int16_t embeddedAssetSlots[%d] = { %s };" % (size, ", ".join(str(slot) for slot in slots)))
+    lines.append("")
+
+    os.makedirs(os.path.dirname(output_path), exist_ok=True)
+    content = "\n".join(lines).encode()
+    if os.path.exists(output_path):
+        with open(output_path, "rb") as existing:
+            if existing.read() == content:
+                return
+    with open(output_path, "wb") as target:
+        target.write(content)
+    print("assets: embedded %d files, %d bytes, %d-slot table (seed 0x%08x)" % (len(paths), total, size, seed))
+
+
+try:
+    Import("env")  # noqa: F821 (fourni par PlatformIO)
+    flags = env.GetProjectOption("build_flags", "")  # noqa: F821
+    if not isinstance(flags, str):
+        flags = " ".join(flags)
+    if "EMBEDDED_ASSETS" in flags:
+        generated_dir = os.path.join(env.subst("$BUILD_DIR"), "generated")  # noqa: F821
+        generate(env.subst("$PROJECT_DATA_DIR"), os.path.join(generated_dir, "AssetBundle.gen.h"))  # noqa: F821
+        env.Append(CPPPATH=[generated_dir])  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        if len(sys.argv) != 3:
+            sys.exit(__doc__)
+        generate(sys.argv[1], sys.argv[2])
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+"""Mesure du débit (req/s) et des latences (p50/p99) du serveur HTTP OPENDOM.
+
+Chaque client simule un navigateur : il charge index.html, app.js et style.css
+puis interroge /api/sensors en boucle. Les clients tournent en parallèle, avec
+ou sans connexion persistante.
+
+    python3 tools/http_bench.py --host 192.168.4.1 --clients 4 --duration 20
+    python3 tools/http_bench.py --host 192.168.4.1 --clients 4 --no-keep-alive
+
+Pour comparer avec l'ancien serveur, flasher l'environnement esp32dev-legacyhttp
+et relancer les mêmes commandes.
+"""
+
+import argparse
+import http.client
+import threading
+import time
+import urllib.parse
+
+PAGE = ["/", "/app.js", "/style.css"]
+API = "/api/sensors"
+
+
+def login(host, port, username, password):
+    # L'authentification est globale au système, une seule connexion suffit
+    conn = http.client.HTTPConnection(host, port, timeout=10)
+    body = urllib.parse.urlencode({"username": username, "password": password})
+    conn.request("POST", "/login", body, {"Content-Type": "application/x-www-form-urlencoded"})
+    response = conn.getresponse()
+    response.read()
+    conn.close()
+    return response.status == 200
+
+
+def worker(args, deadline, latencies, errors, lock):
+    conn = None
+    paths = PAGE + [API] * args.api_ratio
+    index = 0
+    local = []
+    failures = 0
+
+    while time.monotonic() < deadline:
+        path = paths[index % len(paths)]
+        index += 1
+        headers = {} if args.keep_alive else {"Connection": "close"}
+
+        start = time.monotonic()
+        try:
+            if conn is None:
+                conn = http.client.HTTPConnection(args.host, args.port, timeout=args.timeout)
+            conn.request("GET", path, headers=headers)
+            response = conn.getresponse()
+            response.read()
+            if response.status >= 400:
+                failures += 1
+            if not args.keep_alive or response.will_close:
+                conn.close()
+                conn = None
+        except (OSError, http.client.HTTPException):
+            failures += 1
+            if conn is not None:
+                conn.close()
+            conn = None
+            continue
+        local.append(time.monotonic() - start)
+
+    if conn is not None:
+        conn.close()
+
+    with lock:
+        latencies.extend(local)
+        errors.append(failures)
+
+
+def percentile(sorted_values, fraction):
+    if not sorted_values:
+        return 0.0
+    rank = min(len(sorted_values) - 1, int(round(fraction * (len(sorted_values) - 1))))
+    return sorted_values[rank]
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--host", default="192.168.4.1")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--clients", type=int, default=4, help="clients simultanés")
+    parser.add_argument("--duration", type=float, default=20.0, help="durée de la mesure (s)")
+    parser.add_argument("--api-ratio", type=int, default=3, help="requêtes /api/sensors par chargement de page")
+    parser.add_argument("--timeout", type=float, default=10.0)
+    parser.add_argument("--username", default="astron")
+    parser.add_argument("--password", default="astron")
+    parser.add_argument("--no-keep-alive", dest="keep_alive", action="store_false")
+    args = parser.parse_args()
+
+    if not login(args.host, args.port, args.username, args.password):
+        print("warning: login failed, /api/sensors will answer 401")
+
+    latencies = []
+    errors = []
+    lock = threading.Lock()
+    deadline = time.monotonic() + args.duration
+    threads = [threading.Thread(target=worker, args=(args, deadline, latencies, errors, lock))
+               for _ in range(args.clients)]
+
+    start = time.monotonic()
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    elapsed = time.monotonic() - start
+
+    latencies.sort()
+    print("clients=%d keep-alive=%s duration=%.1fs" % (args.clients, args.keep_alive, elapsed))
+    print("requests=%d errors=%d" % (len(latencies), sum(errors)))
+    print("throughput=%.1f req/s" % (len(latencies) / elapsed))
+    print("latency p50=%.1f ms p99=%.1f ms max=%.1f ms" % (
+        percentile(latencies, 0.50) * 1000,
+        percentile(latencies, 0.99) * 1000,
+        (latencies[-1] if latencies else 0.0) * 1000))
+
+
+if __name__ == "__main__":
+    main()